@@ -8,7 +8,7 @@
  *               Default definition module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 22.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -19,13 +19,62 @@
 
 #include <vector>
 
-#include <windows.h>
-#include "commondf.h"
+#ifdef _WIN32
+#  include <windows.h>
+#  include "commondf.h"
+#else
+/* Console modes (workers, coordinator, offline rendering) are built
+ * without Win32 headers, their basic definitions are given here */
+#  include <cfloat>
+#  include <cmath>
+#  include <cstdint>
+#  include <cstdio>
+#  include <cstdlib>
+#  include <cstring>
+#  include <strings.h>
+
+typedef void VOID;
+typedef char CHAR;
+typedef unsigned char UCHAR, BYTE;
+typedef short SHORT;
+typedef unsigned short USHORT, WORD;
+typedef int INT, BOOL;
+typedef unsigned UINT;
+typedef int32_t LONG;
+typedef uint32_t DWORD;
+typedef int64_t INT64;
+typedef uint64_t UINT64;
+typedef float FLOAT;
+typedef double DOUBLE;
+typedef VOID *HDC, *HBITMAP; // Window handles (not used by console modes)
+
+#  define TRUE 1
+#  define FALSE 0
+#  define _stricmp strcasecmp
+
+#  define COM_MIN(A, B) ((A) < (B) ? (A) : (B))
+#  define COM_MAX(A, B) ((A) > (B) ? (A) : (B))
+#  define COM_ABS(A) ((A) < 0 ? -(A) : (A))
+#  define COM_SWAP(A, B, T) ((T) = (A), (A) = (B), (B) = (T))
+
+/* TGA file header structure (as in 'tgahead.h') */
+#  pragma pack(push, 1)
+struct tgaFILEHEADER
+{
+  BYTE IDLength, ColorMapType, ImageType;
+  WORD PaletteStart, PaletteSize;
+  BYTE PaletteEntryDepth;
+  WORD X, Y, Width, Height;
+  BYTE BitsPerPixel, ImageDescriptor;
+};
+#  pragma pack(pop)
+#  define TGA_EXT_SIGNATURE "\0\0\0\0\0\0\0\0TRUEVISION-XFILE." // File footer (with terminating zero)
+#endif /* _WIN32 */
 
 #include "mth/mth.h"
 
-/* Debug memory allocation support */
-#ifndef NDEBUG 
+/* Debug memory allocation support (MSVC runtime only) */
+#if defined(_WIN32) && !defined(NDEBUG)
 # define _CRTDBG_MAP_ALLOC
 # include <crtdbg.h> 
 # define SetDbgMemHooks() \
@@ -42,7 +91,7 @@ public:
   } /* End of '__Dummy' constructor */
 } __ooppss;
 
-#endif /* _DEBUG */
+#endif /* _WIN32 && !NDEBUG */
 
 namespace dart
 {
@@ -51,8 +100,11 @@ namespace dart
   typedef mth::vec3<DBL> vec3;
   typedef mth::vec4<DBL> vec4;
   typedef mth::matr<DBL> matr;
+  typedef mth::transform<DBL> transform;
   typedef mth::ray<DBL> ray;
+  typedef mth::ray_diff<DBL> ray_diff;
   typedef mth::camera<DBL> camera;
+  typedef mth::rnd rnd;
 
   /* Data stock type */
   template <typename Type>
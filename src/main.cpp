@@ -8,20 +8,29 @@
  *               Main startup module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 22.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
  * Computer Graphics Support Group of 30 Phys-Math Lyceum
  */
+#include <cstring>
 #include <string>
-#include <map>
 #include <vector>
 
 #include "def.h"
 #include "mth/mth.h"
-#include "win/win.h"
-#include "rt/rt.h"
+#ifdef _WIN32
+#  include "win/win.h"
+#  include "rt/rt.h"
+#endif
+#include "rt/bench.h"
+#include "rt/animation.h"
+#include "rt/poster.h"
+#include "rt/still.h"
+#include "rt/distributed.h"
+#include "rt/scene_file.h"
+#include "rt/mtl_lib.h"
 #include "rt/shapes/shape.h"
 
 /* Scene examples */
@@ -31,6 +40,12 @@
                                MyRT.Scene << new dart::lgh::point(dart::vec3::Rnd1() * 10, dart::vec3::Rnd0()); \
                              MyRT.Scene << new dart::plane(dart::vec3(1, 10, 0), dart::vec3(0, 10, 0), dart::vec3(0, 10, 1), dart::surface(dart::vec3(.5), dart::vec3(.5 * .8), dart::vec3(.2), .1, 0, 17));
 
+#define SCENE_MANY_LIGHTS() for (INT i = 0; i < 30; i++) \
+                              MyRT.Scene << new dart::sphere(dart::vec3::Rnd1() * 10, ((DBL)rand() / RAND_MAX + .5), SOLID_MTL(dart::vec3::Rnd0() * 2)); \
+                            for (INT i = 0; i < 500; i++) \
+                              MyRT.Scene << new dart::lgh::point(dart::vec3::Rnd1() * 15, dart::vec3::Rnd0() * .05); \
+                            MyRT.Scene << new dart::plane(dart::vec3(1, 10, 0), dart::vec3(0, 10, 0), dart::vec3(0, 10, 1), dart::surface(dart::vec3(.5), dart::vec3(.5 * .8), dart::vec3(.2), .1, 0, 17));
+
 #define SCENE_COORDS() MyRT.Scene << \
                          new dart::sphere(dart::vec3(5, 0, 0), 1, SOLID_MTL(dart::vec3(1, 0, 0))) << \
                          new dart::sphere(dart::vec3(0, 5, 0), 1, SOLID_MTL(dart::vec3(0, 1, 0))) << \
@@ -66,30 +81,489 @@
                        new dart::sphere(dart::vec3(0, 3, 0), 2, dart::surface(dart::vec3(.3, .47, .8), dart::vec3(0), dart::vec3(0), 0, 0.1, 28)) << \
                        new dart::plane(dart::vec3(1, 10, 0), dart::vec3(0, 10, 0), dart::vec3(0, 10, 1), dart::surface(dart::vec3(.5), dart::vec3(.5 * .8), dart::vec3(.2), .1, 0, 17), &Mods);
 
-// Some surfaces materials
-std::map<std::string, dart::surface> MtlLib
-  {
-    {"Black Plastic",   {{0.0, 0.0, 0.0},              {0.01, 0.01, 0.01},           {0.5, 0.5, 0.5},                 0, 0, 32}},
-    {"Brass",           {{0.329412,0.223529,0.027451}, {0.780392,0.568627,0.113725}, {0.992157,0.941176,0.807843},    0, 0, 27.8974}},
-    {"Bronze",          {{0.2125,0.1275,0.054},        {0.714,0.4284,0.18144},       {0.393548,0.271906,0.166721},    0, 0, 25.6}},
-    {"Chrome",          {{0.25, 0.25, 0.25},           {0.4, 0.4, 0.4},              {0.774597, 0.774597, 0.774597},  0, 0, 76.8}},
-    {"Copper",          {{0.19125,0.0735,0.0225},      {0.7038,0.27048,0.0828},      {0.256777,0.137622,0.086014},    0, 0, 12.8}},
-    {"Gold",            {{0.24725,0.1995,0.0745},      {0.75164,0.60648,0.22648},    {0.628281,0.555802,0.366065},    0, 0, 51.2}},
-    {"Peweter",         {{0.10588,0.058824,0.113725},  {0.427451,0.470588,0.541176}, {0.3333,0.3333,0.521569},        0, 0, 9.84615}},
-    {"Silver",          {{0.19225,0.19225,0.19225},    {0.50754,0.50754,0.50754},    {0.508273,0.508273,0.508273},    0, 0, 51.2}},
-    {"Polished Silver", {{0.23125,0.23125,0.23125},    {0.2775,0.2775,0.2775},       {0.773911,0.773911,0.773911},    0, 0, 89.6}},
-    {"Turquoise",       {{0.1, 0.18725, 0.1745},       {0.396, 0.74151, 0.69102},    {0.297254, 0.30829, 0.306678},   0, 0, 12.8}},
-    {"Ruby",            {{0.1745, 0.01175, 0.01175},   {0.61424, 0.04136, 0.04136},  {0.727811, 0.626959, 0.626959},  0.1, 0, 76.8}},
-    {"Polished Gold",   {{0.24725, 0.2245, 0.0645},    {0.34615, 0.3143, 0.0903},    {0.797357, 0.723991, 0.208006},  0, 0, 83.2}},
-    {"Polished Bronze", {{0.25, 0.148, 0.06475},       {0.4, 0.2368, 0.1036},        {0.774597, 0.458561, 0.200621},  0, 0, 76.8}},
-    {"Polished Copper", {{0.2295, 0.08825, 0.0275},    {0.5508, 0.2118, 0.066},      {0.580594, 0.223257, 0.0695701}, 0, 0, 51.2}},
-    {"Jade",            {{0.135, 0.2225, 0.1575},      {0.135, 0.2225, 0.1575},      {0.316228, 0.316228, 0.316228},  0, 0, 12.8}},
-    {"Obsidian",        {{0.05375, 0.05, 0.06625},     {0.18275, 0.17, 0.22525},     {0.332741, 0.328634, 0.346435},  0, 0, 38.4}},
-    {"Pearl",           {{0.25, 0.20725, 0.20725},     {1.0, 0.829, 0.829},          {0.296648, 0.296648, 0.296648},  0, 0, 11.264}},
-    {"Emerald",         {{0.0215, 0.1745, 0.0215},     {0.07568, 0.61424, 0.07568},  {0.633, 0.727811, 0.633},        0.005, 0, 76.8}},
-    {"Black Rubber",    {{0.02, 0.02, 0.02},           {0.01, 0.01, 0.01},           {0.4, 0.4, 0.4},                 0, 0, 10.0}},
+#define SCENE_MARBLE() dart::mods_list Mods {dart::texture::Marble(.3, dart::vec3(1), dart::vec3(.2, .1, .1))}; \
+                       MyRT.Scene << \
+                         new dart::lgh::point(dart::vec3(5, 10, 5), dart::vec3(1)) << \
+                         new dart::plane(dart::vec3(1, 0, 0), dart::vec3(0, 0, 0), dart::vec3(0, 0, 1), dart::surface(dart::vec3(.2), dart::vec3(.8), dart::vec3(.2), 0, 0, 17), &Mods);
+
+// Some surfaces materials (standard library)
+dart::mtl_lib MtlLib;
+
+/* Show error message function.
+ * Message box is shown in Windows, console builds print message to 'stderr'.
+ * ARGUMENTS:
+ *   - message text:
+ *       const CHAR *Msg;
+ * RETURNS: None.
+ */
+static VOID ShowError( const CHAR *Msg )
+{
+#ifdef _WIN32
+  MessageBox(NULL, Msg, "ERROR", MB_OK);
+#else
+  fprintf(stderr, "ERROR: %s\n", Msg);
+#endif
+} /* End of 'ShowError' function */
+
+/* Compare recursive (with linear and tiled frames) and wavefront rendering modes, shading only
+ * re-rendering and orbiting camera frames with and without reprojection
+ * on reflection and refraction scenes, recursive mode scaling by threads
+ * count, both modes on procedural texture scene, frame colors conversion
+ * and matrix kernels function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+static VOID Benchmark( VOID )
+{
+  dart::bench Bench("bench.log");
+  const CHAR *Names[2][6] =
+  {
+    {"SCENE_REFL recursive", "SCENE_REFL wavefront", "SCENE_REFL reshade", "SCENE_REFL orbit", "SCENE_REFL orbit reprojected",
+     "SCENE_REFL recursive tiled"},
+    {"SCENE_REFR recursive", "SCENE_REFR wavefront", "SCENE_REFR reshade", "SCENE_REFR orbit", "SCENE_REFR orbit reprojected",
+     "SCENE_REFR recursive tiled"}
   };
 
+  for (INT s = 0; s < 2; s++)
+    for (INT m = 0; m < 6; m++)
+    {
+      struct
+      {
+        dart::scene Scene;
+      } MyRT; // scene examples add shapes to 'MyRT.Scene'
+
+      if (s == 0)
+      {
+        SCENE_REFL();
+      }
+      else
+      {
+        SCENE_REFR();
+      }
+      MyRT.Scene.IsWavefront = m == 1;
+      MyRT.Scene.IsReproject = m == 4;
+      if (m < 3)
+        Bench.Render(Names[s][m], MyRT.Scene, 600, 400, 10,
+          m == 2 ? dart::scene::CHANGED_SHADING : dart::scene::CHANGED_CAMERA);
+      else if (m < 5)
+        Bench.Render(Names[s][m], MyRT.Scene, 600, 400, 30, 0, .02);
+      else
+        Bench.Render(Names[s][m], MyRT.Scene, 600, 400, 10, dart::scene::CHANGED_CAMERA, 0, TRUE);
+    }
+
+  // tile-parallel recursive rendering scaling on linear and tiled frames
+  INT Threads = dart::ParallelThreads();
+
+  for (INT n = 1; n <= COM_MAX(Threads, 4); n *= 2)
+    for (INT m = 0; m < 2; m++)
+    {
+      struct
+      {
+        dart::scene Scene;
+      } MyRT; // scene examples add shapes to 'MyRT.Scene'
+      CHAR Name[100];
+
+      SCENE_REFL();
+      MyRT.Scene.IsReproject = FALSE;
+      dart::ParallelThreads() = n;
+      sprintf(Name, "SCENE_REFL recursive %s, %d threads", m == 0 ? "linear" : "tiled", n);
+      Bench.Render(Name, MyRT.Scene, 600, 400, 10, dart::scene::CHANGED_CAMERA, 0, m == 1);
+    }
+  dart::ParallelThreads() = Threads;
+
+  // textures shading is batched by wavefront mode only
+  for (INT m = 0; m < 2; m++)
+  {
+    struct
+    {
+      dart::scene Scene;
+    } MyRT; // scene examples add shapes to 'MyRT.Scene'
+
+    SCENE_MARBLE();
+    MyRT.Scene.IsWavefront = m == 1;
+    Bench.Render(m == 0 ? "SCENE_MARBLE recursive" : "SCENE_MARBLE wavefront", MyRT.Scene, 600, 400, 10);
+  }
+
+  // per pixel clamping against resolve pass
+  dart::frame Frm(600, 400);
+  dart::stock<DWORD> Image;
+
+  Image.resize(Frm.W * Frm.H);
+  Frm.Image = Image.data();
+  for (INT i = 0; i < Frm.W * Frm.H; i++)
+    Frm.Put(i, dart::vec3(i % 600 / 300.0, i / 600 / 200.0, .5));
+  Bench.Measure("PutPixel 600x400", 100,
+    [&]( VOID )
+    {
+      for (INT Y = 0; Y < Frm.H; Y++)
+        for (INT X = 0; X < Frm.W; X++)
+        {
+          const FLT *p = &Frm.Hdr[(Y * Frm.W + X) * 4];
+
+          Frm.PutPixel(X, Y, dart::vec4(dart::vec3(p[0], p[1], p[2])));
+        }
+    });
+  Bench.Measure("Resolve 600x400", 100,
+    [&]( VOID )
+    {
+      Frm.Resolve();
+    });
+  Frm.ToneMap = dart::TONEMAP_ACES, Frm.Gamma = 2.2f;
+  Bench.Measure("Resolve 600x400 ACES, gamma 2.2", 100,
+    [&]( VOID )
+    {
+      Frm.Resolve();
+    });
+
+  // matrix kernels against their scalar versions
+  dart::matr Rot = dart::matr::RotateY(1) * dart::matr::RotateX(2) * dart::matr::Translate(dart::vec3(.1, .2, .3)), Acc;
+  CHAR Name[100];
+  auto Compare =
+    [&]( const CHAR *Kernel, INT Count, auto Scalar, auto Simd )
+    {
+      Acc = Rot;
+      sprintf(Name, "%s x%d scalar", Kernel, Count);
+      DBL ts = Bench.Measure(Name, 1, [&]( VOID ) { for (INT i = 0; i < Count; i++) Scalar(); });
+      sprintf(Name, "%s x%d SIMD", Kernel, Count);
+      DBL tv = Bench.Measure(Name, 1, [&]( VOID ) { for (INT i = 0; i < Count; i++) Simd(); });
+      Bench.Print("%-40s %10.2fx", "  speedup", ts / tv);
+    };
+
+  Compare("matr multiply", 1000000,
+    [&]( VOID ) { dart::matr R; mth::kernel::Mul<DBL>(Acc.M, Rot.M, R.M); Acc = R; },
+    [&]( VOID ) { Acc = Acc * Rot; });
+  Compare("matr transpose", 1000000,
+    [&]( VOID ) { dart::matr R; mth::kernel::Transpose<DBL>(Acc.M, R.M); Acc = R; },
+    [&]( VOID ) { Acc = Acc.Transpossing(); });
+  Bench.Print("%-40s %g", "matrix kernels check sum", Acc.M[3][0]);
+
+  // transform and affine inverse kernels have scalar versions only
+  dart::stock<dart::vec3> Pts;
+  dart::vec3 V(.1, .2, .3);
+  dart::matr Proj = Rot;
+  dart::transform Xf(Rot);
+
+  Pts.resize(1000);
+  for (INT i = 0; i < 1000; i++)
+    Pts[i] = dart::vec3(i, i * .5, -i);
+  Bench.Measure("matr point transform x1000000", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000000; i++) V = Rot.PointTransform(V); });
+  Bench.Measure("matr points transform 1000 x1000", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000; i++) Rot.PointsTransform(Pts.data(), Pts.data(), 1000); });
+  Bench.Measure("matr vector transform x1000000", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000000; i++) V = Rot.VectorTransform(V); });
+  Bench.Measure("transform normal x1000000", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000000; i++) V = Xf.Normal(V); });
+  Proj.M[2][3] = 1e-3; // projective part disables affine inverse
+  DBL tg = Bench.Measure("matr inverse x1000000 general", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000000; i++) Acc = Proj.EvaluateInverse(); });
+  DBL ta = Bench.Measure("matr inverse x1000000 affine", 1,
+    [&]( VOID ) { for (INT i = 0; i < 1000000; i++) Acc = Rot.EvaluateInverse(); });
+  Bench.Print("%-40s %10.2fx", "  speedup", tg / ta);
+  Bench.Print("%-40s %g", "transform kernels check sum", Acc.M[3][0] + V[0] + Pts[999][0]);
+
+  // saved images encoders on rendered image
+  struct
+  {
+    dart::scene Scene;
+  } MyRT; // scene examples add shapes to 'MyRT.Scene'
+  dart::camera Cam;
+
+  SCENE_REFL();
+  Frm.ToneMap = dart::TONEMAP_CLAMP, Frm.Gamma = 1;
+  Cam.Resize(Frm.W, Frm.H);
+  Cam.Set(dart::vec3(0, MyRT.Scene.CamDist, MyRT.Scene.CamDist), dart::vec3(0), dart::vec3(0, 1, 0));
+  MyRT.Scene.Render(Cam, Frm);
+  Bench.Encode("Encode SCENE_REFL 600x400", Frm.Image, Frm.W, Frm.H, 20);
+} /* End of 'Benchmark' function */
+
+/* Render animation of window scene to numbered files function.
+ * ARGUMENTS:
+ *   - command line arguments after "-anim" (first and last frames,
+ *     time step and frames rendered at once, all optional):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Animation( const CHAR *Args )
+{
+  INT first = 0, last = 299, workers = 2;
+  DBL step = 1 / 30.0;
+
+  sscanf(Args, "%d%d%lf%d", &first, &last, &step, &workers);
+
+  dart::animation Anim(600, 400, first, last, step, workers);
+  Anim.Render(
+    []( dart::scene &Scene )
+    {
+      struct
+      {
+        dart::scene &Scene;
+      } MyRT {Scene}; // scene examples add shapes to 'MyRT.Scene'
+
+      // the same random scene as in window
+      srand(1);
+      SCENE_RAND_SPHERES();
+    });
+} /* End of 'Animation' function */
+
+/* Render window scene to big image file function.
+ * ARGUMENTS:
+ *   - command line arguments after "-poster" (image size and file name):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Poster( const CHAR *Args )
+{
+  INT w = 8192, h = 8192;
+  CHAR FileName[300] = "poster.exr";
+
+  sscanf(Args, "%d%d%299s", &w, &h, FileName);
+
+  struct
+  {
+    dart::scene Scene;
+  } MyRT; // scene examples add shapes to 'MyRT.Scene'
+  dart::camera Cam;
+
+  srand(1);
+  SCENE_RAND_SPHERES();
+  Cam.Set(dart::vec3(0, MyRT.Scene.CamDist, MyRT.Scene.CamDist), dart::vec3(0), dart::vec3(0, 1, 0));
+
+  dart::poster Poster(w, h);
+  Poster.Render(MyRT.Scene, Cam, FileName);
+} /* End of 'Poster' function */
+
+/* Render window scene to image with many samples per pixel function.
+ * ARGUMENTS:
+ *   - command line arguments after "-still" (image size, samples count,
+ *     file name, checkpoints period in seconds and "resume" word to
+ *     continue from checkpoint, all optional):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Still( const CHAR *Args )
+{
+  INT w = 1920, h = 1080, samples = 1024;
+  DBL period = 60;
+  CHAR FileName[300] = "still.png", Resume[10] = "";
+
+  sscanf(Args, "%d%d%d%299s%lf%9s", &w, &h, &samples, FileName, &period, Resume);
+
+  struct
+  {
+    dart::scene Scene;
+  } MyRT; // scene examples add shapes to 'MyRT.Scene'
+  dart::camera Cam;
+
+  srand(1);
+  SCENE_RAND_SPHERES();
+  MyRT.Scene.Policy.IsRoulette = TRUE;
+  Cam.Set(dart::vec3(0, MyRT.Scene.CamDist, MyRT.Scene.CamDist), dart::vec3(0), dart::vec3(0, 1, 0));
+
+  dart::still Still(w, h, samples, period);
+  Still.Render(MyRT.Scene, Cam, FileName, strcmp(Resume, "resume") == 0);
+} /* End of 'Still' function */
+
+/* Render animation of window scene by worker processes function.
+ * ARGUMENTS:
+ *   - command line arguments after "-coordinator" (first and last
+ *     frames, time step, samples per pixel and port, all optional):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Coordinator( const CHAR *Args )
+{
+  INT first = 0, last = 299, samples = 1, port = 5517;
+  DBL step = 1 / 30.0;
+
+  sscanf(Args, "%d%d%lf%d%d", &first, &last, &step, &samples, &port);
+
+  dart::coordinator Coord(600, 400, samples, port);
+  if (Coord.Render(first, last, step, "frame_%05d.tga") < 0)
+    ShowError(Coord.Error.c_str());
+} /* End of 'Coordinator' function */
+
+/* Load scene description file or compiled snapshot function.
+ * ARGUMENTS:
+ *   - file name ('.snap' files are snapshots):
+ *       const CHAR *FileName;
+ *   - reference at scene:
+ *       dart::scene &Scene;
+ *   - reference at camera:
+ *       dart::camera &Cam;
+ *   - reference at error message to fill:
+ *       std::string &Error;
+ * RETURNS:
+ *   (BOOL) TRUE if scene is loaded, FALSE overwise.
+ */
+static BOOL LoadScene( const CHAR *FileName, dart::scene &Scene, dart::camera &Cam, std::string &Error )
+{
+  size_t Len = strlen(FileName);
+
+  if (Len > 5 && strcmp(FileName + Len - 5, ".snap") == 0)
+  {
+    if (Scene.LoadSnapshot(FileName, Cam))
+      return TRUE;
+    Error = std::string("bad scene snapshot '") + FileName + "'";
+    return FALSE;
+  }
+
+  dart::scene_file Loader;
+
+  if (Loader.Load(FileName, Scene, Cam))
+    return TRUE;
+  Error = Loader.Error;
+  return FALSE;
+} /* End of 'LoadScene' function */
+
+/* Compile scene description file to snapshot function.
+ * ARGUMENTS:
+ *   - command line arguments after "-snapshot" (scene and snapshot files names):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Snapshot( const CHAR *Args )
+{
+  CHAR InName[300] = "", OutName[300] = "scene.snap";
+  dart::scene Scene;
+  dart::camera Cam;
+  std::string Error;
+
+  sscanf(Args, "%299s%299s", InName, OutName);
+  if (!LoadScene(InName, Scene, Cam, Error))
+    ShowError(Error.c_str());
+  else if (!Scene.SaveSnapshot(OutName, Cam))
+    ShowError("snapshot is not written");
+} /* End of 'Snapshot' function */
+
+/* Build tiled image file for image textures function.
+ * ARGUMENTS:
+ *   - command line arguments after "-mktex" (TGA and tiled image files names):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID MakeTexture( const CHAR *Args )
+{
+  CHAR InName[300] = "", OutName[300] = "texture.dtx";
+
+  sscanf(Args, "%299s%299s", InName, OutName);
+  if (!dart::tiled_image::Build(InName, OutName))
+    ShowError("tiled image is not built (24 or 32 bits TGA image is expected)");
+} /* End of 'MakeTexture' function */
+
+/* Render tiles of window scene for coordinator process function.
+ * ARGUMENTS:
+ *   - command line arguments after "-worker" (port and scene file, optional):
+ *       const CHAR *Args;
+ * RETURNS: None.
+ */
+static VOID Worker( const CHAR *Args )
+{
+  INT port = 5517;
+  CHAR FileName[300] = "";
+
+  sscanf(Args, "%d%299s", &port, FileName);
+
+  struct
+  {
+    dart::scene Scene;
+  } MyRT; // scene examples add shapes to 'MyRT.Scene'
+
+  if (FileName[0] != 0)
+  {
+    dart::camera Cam;
+    std::string Error;
+
+    if (!LoadScene(FileName, MyRT.Scene, Cam, Error))
+    {
+      ShowError(Error.c_str());
+      return;
+    }
+  }
+  else
+  {
+    // the same random scene as in coordinator window
+    srand(1);
+    SCENE_RAND_SPHERES();
+  }
+  if (dart::worker::Run(MyRT.Scene, port) < 0)
+    ShowError("coordinator is not found");
+} /* End of 'Worker' function */
+
+/* Run console mode by command line function.
+ * ARGUMENTS:
+ *   - command line string:
+ *       const CHAR *CmdLine;
+ * RETURNS:
+ *   (BOOL) TRUE if command line selects console mode (it is done), FALSE overwise.
+ */
+static BOOL RunConsole( const CHAR *CmdLine )
+{
+  // run "T05RT.exe -bench" to write rendering timings to 'bench.log'
+  if (strstr(CmdLine, "-bench") != nullptr)
+  {
+    Benchmark();
+    return TRUE;
+  }
+
+  // run "T05RT.exe -anim 0 299 0.0333 2" to render frames 0..299 to 'frame_*.tga' (resumes after crash)
+  const CHAR *anim = strstr(CmdLine, "-anim");
+  if (anim != nullptr)
+  {
+    Animation(anim + 5);
+    return TRUE;
+  }
+
+  // run "T05RT.exe -poster 32768 32768 poster.exr" to render big image (TGA, PPM or EXR) by bands
+  const CHAR *poster = strstr(CmdLine, "-poster");
+  if (poster != nullptr)
+  {
+    Poster(poster + 7);
+    return TRUE;
+  }
+
+  // run "T05RT.exe -still 1920 1080 1024 still.png 60 [resume]" to render many samples with checkpoints
+  const CHAR *still = strstr(CmdLine, "-still");
+  if (still != nullptr)
+  {
+    Still(still + 6);
+    return TRUE;
+  }
+
+  // run "T05RT.exe -snapshot scene.scn scene.snap" to compile scene description to snapshot
+  const CHAR *snap = strstr(CmdLine, "-snapshot");
+  if (snap != nullptr)
+  {
+    Snapshot(snap + 9);
+    return TRUE;
+  }
+
+  // run "T05RT.exe -mktex image.tga image.dtx" to build tiled mip-mapped image for 'image' textures
+  const CHAR *mktex = strstr(CmdLine, "-mktex");
+  if (mktex != nullptr)
+  {
+    MakeTexture(mktex + 6);
+    return TRUE;
+  }
+
+  // run "T05RT.exe -coordinator 0 299 0.0333 1 5517" and several "T05RT.exe -worker 5517 [scene]" to render animation by processes
+  const CHAR *coord = strstr(CmdLine, "-coordinator");
+  if (coord != nullptr)
+  {
+    Coordinator(coord + 12);
+    return TRUE;
+  }
+  const CHAR *work = strstr(CmdLine, "-worker");
+  if (work != nullptr)
+  {
+    Worker(work + 7);
+    return TRUE;
+  }
+
+  return FALSE;
+} /* End of 'RunConsole' function */
+
+#ifdef _WIN32
 /* The main program function.
  * ARGUMENTS:
  *   - handle of application instance:
@@ -105,9 +579,30 @@ std::map<std::string, dart::surface> MtlLib
    */
 INT WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, CHAR *CmdLine, INT ShowCmd )
 {
+  if (RunConsole(CmdLine))
+    return 0;
+
   dart::rt MyRT(hInstance);
 
-  SCENE_RAND_SPHERES();
+  // run "T05RT.exe -scene file.scn" to render scene from description file (reloaded on save) or "file.snap" snapshot
+  const CHAR *file = strstr(CmdLine, "-scene");
+  if (file != nullptr)
+  {
+    CHAR FileName[300] = "";
+    std::string Error;
+
+    sscanf(file + 6, "%299s", FileName);
+    if (!LoadScene(FileName, MyRT.Scene, MyRT.Camera, Error))
+    {
+      ShowError(Error.c_str());
+      return 0;
+    }
+    // description file is reloaded on save
+    if (strstr(FileName, ".snap") == nullptr)
+      MyRT.Watch(FileName, MyRT.Camera);
+  }
+  else
+    SCENE_RAND_SPHERES();
 
 #if 0
   MyRT.Scene <<
@@ -136,6 +631,31 @@ INT WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, CHAR *CmdLine,
 #endif
 
   MyRT.Run();
+  return 0;
 } /* End of 'WinMain' function */
+#else
+/* The main program function (console modes only).
+ * ARGUMENTS:
+ *   - command line arguments:
+ *       INT argc, CHAR *argv[];
+ * RETURNS:
+ *   (INT) Error level for operation system (0 for success).
+ */
+INT main( INT argc, CHAR *argv[] )
+{
+  std::string CmdLine;
+
+  for (INT i = 1; i < argc; i++)
+    CmdLine += std::string(" ") + argv[i];
+  if (RunConsole(CmdLine.c_str()))
+    return 0;
+  fprintf(stderr,
+    "usage: %s -worker [port [scene]] | -coordinator [first last step samples port] |\n"
+    "       -anim [first last step workers] | -still [w h samples file period [resume]] |\n"
+    "       -poster [w h file] | -snapshot scene snap | -mktex image.tga image.dtx | -bench\n"
+    "(window mode is available in Windows build only)\n", argv[0]);
+  return 1;
+} /* End of 'main' function */
+#endif /* _WIN32 */
 
 /* END OF 'main.cpp' FILE */
@@ -3,7 +3,7 @@
  *               Math types definition module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 23.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'mth'.
  *
  * No part of this file may be changed without agreement of
@@ -16,8 +16,10 @@
 #include "mth_vec3.h"
 #include "mth_vec4.h"
 #include "mth_matr.h"
+#include "mth_transform.h"
 #include "mth_ray.h"
 #include "mth_camera.h"
+#include "mth_rnd.h"
 
 #endif // __mth_h_
 /* END OF 'mth.h' FILE */
@@ -177,7 +177,7 @@ namespace mth
       static matr<Type> Ortho( Type Left, Type Right, Type Bottom, Type Top, Type Near, Type Far )
       {
         if (Right == Left || Top == Bottom || Far == Near)
-          return matr::Identity();
+          return matr<Type>::Identity();
 
         return matr<Type>(2 / (Right - Left), 0, 0, 0,
                           0, 2 / (Top - Bottom), 0, 0,
@@ -0,0 +1,229 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : mth_kernels.h
+ * PURPOSE     : Raytracing project.
+ *               Matrix computation kernels module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'mth::kernel'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __mth_kernels_h_
+#define __mth_kernels_h_
+
+#include <emmintrin.h>
+#ifdef __AVX__
+#  include <immintrin.h>
+#endif
+
+#include "mth_vec3.h"
+
+/* Matrices are arrays of 4 rows, vectors are multiplied as rows from
+ * the left. Templates are plain scalar versions for any element type,
+ * double precision overloads use SSE2 (AVX if it is enabled by compiler
+ * options) and sum products in the same order, so results are equal.
+ * Vector transforms and 3x3 inverse are scalar only.
+ */
+namespace mth
+{
+  namespace kernel
+  {
+    /* Multiply matrices function.
+     * ARGUMENTS:
+     *   - references at matrices elements:
+     *       const Type (&A)[4][4], (&B)[4][4];
+     *   - reference at result elements (not the same as arguments):
+     *       Type (&R)[4][4];
+     * RETURNS: None.
+     */
+    template <typename Type>
+      inline VOID Mul( const Type (&A)[4][4], const Type (&B)[4][4], Type (&R)[4][4] )
+      {
+        for (INT i = 0; i < 4; i++)
+          for (INT j = 0; j < 4; j++)
+            R[i][j] = A[i][0] * B[0][j] + A[i][1] * B[1][j] + A[i][2] * B[2][j] + A[i][3] * B[3][j];
+      } /* End of 'Mul' function */
+
+    /* Multiply matrices function.
+     * ARGUMENTS:
+     *   - references at matrices elements:
+     *       const DBL (&A)[4][4], (&B)[4][4];
+     *   - reference at result elements (not the same as arguments):
+     *       DBL (&R)[4][4];
+     * RETURNS: None.
+     */
+    inline VOID Mul( const DBL (&A)[4][4], const DBL (&B)[4][4], DBL (&R)[4][4] )
+    {
+#ifdef __AVX__
+      __m256d
+        b0 = _mm256_loadu_pd(B[0]), b1 = _mm256_loadu_pd(B[1]),
+        b2 = _mm256_loadu_pd(B[2]), b3 = _mm256_loadu_pd(B[3]);
+
+      for (INT i = 0; i < 4; i++)
+        _mm256_storeu_pd(R[i],
+          _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(_mm256_broadcast_sd(&A[i][0]), b0),
+            _mm256_mul_pd(_mm256_broadcast_sd(&A[i][1]), b1)),
+            _mm256_mul_pd(_mm256_broadcast_sd(&A[i][2]), b2)),
+            _mm256_mul_pd(_mm256_broadcast_sd(&A[i][3]), b3)));
+#else
+      for (INT i = 0; i < 4; i++)
+      {
+        __m128d
+          a0 = _mm_set1_pd(A[i][0]), a1 = _mm_set1_pd(A[i][1]),
+          a2 = _mm_set1_pd(A[i][2]), a3 = _mm_set1_pd(A[i][3]);
+
+        for (INT j = 0; j < 4; j += 2)
+          _mm_storeu_pd(R[i] + j,
+            _mm_add_pd(_mm_add_pd(_mm_add_pd(
+              _mm_mul_pd(a0, _mm_loadu_pd(B[0] + j)),
+              _mm_mul_pd(a1, _mm_loadu_pd(B[1] + j))),
+              _mm_mul_pd(a2, _mm_loadu_pd(B[2] + j))),
+              _mm_mul_pd(a3, _mm_loadu_pd(B[3] + j))));
+      }
+#endif
+    } /* End of 'Mul' function */
+
+    /* Transpose matrix function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const Type (&A)[4][4];
+     *   - reference at result elements (not the same as argument):
+     *       Type (&R)[4][4];
+     * RETURNS: None.
+     */
+    template <typename Type>
+      inline VOID Transpose( const Type (&A)[4][4], Type (&R)[4][4] )
+      {
+        for (INT i = 0; i < 4; i++)
+          for (INT j = 0; j < 4; j++)
+            R[i][j] = A[j][i];
+      } /* End of 'Transpose' function */
+
+    /* Transpose matrix function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const DBL (&A)[4][4];
+     *   - reference at result elements (not the same as argument):
+     *       DBL (&R)[4][4];
+     * RETURNS: None.
+     */
+    inline VOID Transpose( const DBL (&A)[4][4], DBL (&R)[4][4] )
+    {
+      // 2x2 blocks are transposed by unpacking
+      for (INT i = 0; i < 4; i += 2)
+        for (INT j = 0; j < 4; j += 2)
+        {
+          __m128d
+            r0 = _mm_loadu_pd(A[j] + i),
+            r1 = _mm_loadu_pd(A[j + 1] + i);
+
+          _mm_storeu_pd(R[i] + j, _mm_unpacklo_pd(r0, r1));
+          _mm_storeu_pd(R[i + 1] + j, _mm_unpackhi_pd(r0, r1));
+        }
+    } /* End of 'Transpose' function */
+
+    /* Transform point by matrix without projective part function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const Type (&M)[4][4];
+     *   - reference at point:
+     *       const vec3<Type> &P;
+     * RETURNS:
+     *   (vec3<Type>) transformed point.
+     */
+    template <typename Type>
+      inline vec3<Type> Point( const Type (&M)[4][4], const vec3<Type> &P )
+      {
+        return vec3<Type>(P.X * M[0][0] + P.Y * M[1][0] + P.Z * M[2][0] + M[3][0],
+                          P.X * M[0][1] + P.Y * M[1][1] + P.Z * M[2][1] + M[3][1],
+                          P.X * M[0][2] + P.Y * M[1][2] + P.Z * M[2][2] + M[3][2]);
+      } /* End of 'Point' function */
+
+    /* Transform direction vector by matrix 3x3 part function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const Type (&M)[4][4];
+     *   - reference at vector:
+     *       const vec3<Type> &V;
+     * RETURNS:
+     *   (vec3<Type>) transformed vector.
+     */
+    template <typename Type>
+      inline vec3<Type> Vector( const Type (&M)[4][4], const vec3<Type> &V )
+      {
+        return vec3<Type>(V.X * M[0][0] + V.Y * M[1][0] + V.Z * M[2][0],
+                          V.X * M[0][1] + V.Y * M[1][1] + V.Z * M[2][1],
+                          V.X * M[0][2] + V.Y * M[1][2] + V.Z * M[2][2]);
+      } /* End of 'Vector' function */
+
+    /* Transform points array by matrix without projective part function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const Type (&M)[4][4];
+     *   - source points:
+     *       const vec3<Type> *In;
+     *   - result points (may be the same as source):
+     *       vec3<Type> *Out;
+     *   - points count:
+     *       INT N;
+     * RETURNS: None.
+     */
+    template <typename Type>
+      inline VOID Points( const Type (&M)[4][4], const vec3<Type> *In, vec3<Type> *Out, INT N )
+      {
+        for (INT i = 0; i < N; i++)
+          Out[i] = Point(M, In[i]);
+      } /* End of 'Points' function */
+
+    /* Invert matrix without projective part function.
+     * ARGUMENTS:
+     *   - reference at matrix elements:
+     *       const Type (&A)[4][4];
+     *   - reference at result elements (not the same as argument):
+     *       Type (&R)[4][4];
+     * RETURNS:
+     *   (BOOL) TRUE if matrix is inverted, FALSE if it is singular.
+     */
+    template <typename Type>
+      inline BOOL AffineInverse( const Type (&A)[4][4], Type (&R)[4][4] )
+      {
+        // columns of inverse 3x3 part are cross products of rows
+        Type
+          D00 = A[1][1] * A[2][2] - A[1][2] * A[2][1],
+          D01 = A[1][2] * A[2][0] - A[1][0] * A[2][2],
+          D02 = A[1][0] * A[2][1] - A[1][1] * A[2][0],
+          det = A[0][0] * D00 + A[0][1] * D01 + A[0][2] * D02;
+
+        if (det == 0)
+          return FALSE;
+
+        Type inv = 1 / det;
+
+        R[0][0] = D00 * inv;
+        R[1][0] = D01 * inv;
+        R[2][0] = D02 * inv;
+        R[0][1] = (A[2][1] * A[0][2] - A[2][2] * A[0][1]) * inv;
+        R[1][1] = (A[2][2] * A[0][0] - A[2][0] * A[0][2]) * inv;
+        R[2][1] = (A[2][0] * A[0][1] - A[2][1] * A[0][0]) * inv;
+        R[0][2] = (A[0][1] * A[1][2] - A[0][2] * A[1][1]) * inv;
+        R[1][2] = (A[0][2] * A[1][0] - A[0][0] * A[1][2]) * inv;
+        R[2][2] = (A[0][0] * A[1][1] - A[0][1] * A[1][0]) * inv;
+        for (INT j = 0; j < 3; j++)
+          R[3][j] = -(A[3][0] * R[0][j] + A[3][1] * R[1][j] + A[3][2] * R[2][j]);
+        R[0][3] = R[1][3] = R[2][3] = 0;
+        R[3][3] = 1;
+        return TRUE;
+      } /* End of 'AffineInverse' function */
+  } /* end of 'kernel' namespace */
+} /* end of 'mth' namespace */
+
+#endif // __mth_kernels_h_
+
+/* END OF 'mth_kernels.h' FILE */
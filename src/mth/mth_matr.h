@@ -3,7 +3,7 @@
  *               Matrix class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 23.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'math'.
  *
  * No part of this file may be changed without agreement of
@@ -13,6 +13,7 @@
 #define __mth_matr_h_
 
 #include "mth_def.h"
+#include "mth_kernels.h"
 
 namespace mth
 {
@@ -21,15 +22,13 @@ namespace mth
     class matr
     {
     public:
-      Type M[4][4];                 // Matrix elements
-      mutable Type InvM[4][4];      // Inversed matrix elements
-      mutable BOOL WasInvEvaluated; // Was inverse matrix evaluated flag
+      Type M[4][4]; // Matrix elements
 
       /* Default constructor function.
        * ARGUMENTS: None;
        * RETURNS: None.
        */
-      matr<Type>() : M{0}, InvM{0}, WasInvEvaluated(FALSE)
+      matr<Type>() : M{0}
       {
       } /* End of 'matr' function */
 
@@ -48,7 +47,7 @@ namespace mth
                   Type A30, Type A31, Type A32, Type A33 ) : M{ A00, A01, A02, A03,
                                                                 A10, A11, A12, A13,
                                                                 A20, A21, A22, A23,
-                                                                A30, A31, A32, A33 }, InvM{0}, WasInvEvaluated(FALSE)
+                                                                A30, A31, A32, A33 }
       {
       } /* End of 'matr' function */
 
@@ -61,7 +60,7 @@ namespace mth
       matr<Type>( const Type A[4][4] ) : M{A[0][0], A[0][1], A[0][2], A[0][3],
                                            A[1][0], A[1][1], A[1][2], A[1][3],
                                            A[2][0], A[2][1], A[2][2], A[2][3],
-                                           A[3][0], A[3][1], A[3][2], A[3][3]}, InvM{0}, WasInvEvaluated(FALSE)
+                                           A[3][0], A[3][1], A[3][2], A[3][3]}
       {
       } /* End of 'matr' function */
 
@@ -89,21 +88,22 @@ namespace mth
       } /* End of 'Determ3x3' function */
 
     public:
+     /* Copy constructor function.
+      * ARGUMENTS:
+      *   - other matrix:
+      *       const matr &X;
+      * RETURNS: None.
+      */
+      matr<Type>( const matr &X ) = default;
+
      /* Copy other matrix to this function.
       * ARGUMENTS:
       *   - other matrix:
-      *       const matr &M;
+      *       const matr &X;
       * RETURNS:
       *   (matr &) self referense.
       */
-      matr & operator=( const matr &X )
-      {
-        M[0][0] = X.M[0][0], M[0][1] = X.M[0][1], M[0][2] = X.M[0][2], M[0][3] = X.M[0][3];
-        M[1][0] = X.M[1][0], M[1][1] = X.M[1][1], M[1][2] = X.M[1][2], M[1][3] = X.M[1][3];
-        M[2][0] = X.M[2][0], M[2][1] = X.M[2][1], M[2][2] = X.M[2][2], M[2][3] = X.M[2][3];
-        M[3][0] = X.M[3][0], M[3][1] = X.M[3][1], M[3][2] = X.M[3][2], M[3][3] = X.M[3][3];
-        return *this;
-      } /* End of 'operator=' function */
+      matr & operator=( const matr &X ) = default;
 
       /* Evaluate matrix determinator function.
        * ARGUMENTS: None;
@@ -127,39 +127,57 @@ namespace mth
                                        M[3][0], M[3][1], M[3][2]);
       } /* End of 'operator!' function */
 
+      /* Check if matrix has no projective part function.
+       * ARGUMENTS: None;
+       * RETURNS:
+       *   (BOOL) TRUE if last column is (0, 0, 0, 1), FALSE overwise.
+       */
+      BOOL IsAffine() const
+      {
+        return M[0][3] == 0 && M[1][3] == 0 && M[2][3] == 0 && M[3][3] == 1;
+      } /* End of 'IsAffine' function */
+
       /* Evaluate inverse matrix function.
+       * Matrix is not changed, so it may be shared by threads
+       * ('transform' keeps evaluated inverse for often used matrices),
+       * affine matrices are inverted by 3x3 part.
        * ARGUMENTS: None;
        * RETURNS:
-       *   (matr) inversed matrix.
+       *   (matr) inversed matrix (identity for singular matrix).
        */
       matr EvaluateInverse() const
       {
-        if (WasInvEvaluated)
-          return matr(InvM);
+        if (IsAffine())
+        {
+          matr R;
+
+          return kernel::AffineInverse(M, R.M) ? R : Identity();
+        }
+
+        Type det = !*this, InvM[4][4];
 
-        WasInvEvaluated = TRUE;
-        DBL det = !*this;
         if (det == 0)
           return Identity();
 
+        // cofactors are stored transposed (element [i][j] gets cofactor of [j][i])
         InvM[0][0] =
           +EvaluateDeterm3x3(M[1][1], M[1][2], M[1][3],
                              M[2][1], M[2][2], M[2][3],
                              M[3][1], M[3][2], M[3][3]) / det;
-        InvM[0][1] =
+        InvM[1][0] =
           -EvaluateDeterm3x3(M[1][0], M[1][2], M[1][3],
                              M[2][0], M[2][2], M[2][3],
                              M[3][0], M[3][2], M[3][3]) / det;
-        InvM[0][2] =
+        InvM[2][0] =
           +EvaluateDeterm3x3(M[1][0], M[1][1], M[1][3],
                              M[2][0], M[2][1], M[2][3],
                              M[3][0], M[3][1], M[3][3]) / det;
-        InvM[0][3] =
+        InvM[3][0] =
           -EvaluateDeterm3x3(M[1][0], M[1][1], M[1][2],
                              M[2][0], M[2][1], M[2][2],
                              M[3][0], M[3][1], M[3][2]) / det;
 
-        InvM[1][0] =
+        InvM[0][1] =
           -EvaluateDeterm3x3(M[0][1], M[0][2], M[0][3],
                              M[2][1], M[2][2], M[2][3],
                              M[3][1], M[3][2], M[3][3]) / det;
@@ -167,20 +185,20 @@ namespace mth
           +EvaluateDeterm3x3(M[0][0], M[0][2], M[0][3],
                              M[2][0], M[2][2], M[2][3],
                              M[3][0], M[3][2], M[3][3]) / det;
-        InvM[1][2] =
+        InvM[2][1] =
           -EvaluateDeterm3x3(M[0][0], M[0][1], M[0][3],
                              M[2][0], M[2][1], M[2][3],
                              M[3][0], M[3][1], M[3][3]) / det;
-        InvM[1][3] =
+        InvM[3][1] =
           +EvaluateDeterm3x3(M[0][0], M[0][1], M[0][2],
                              M[2][0], M[2][1], M[2][2],
                              M[3][0], M[3][1], M[3][2]) / det;
 
-        InvM[2][0] =
+        InvM[0][2] =
           +EvaluateDeterm3x3(M[0][1], M[0][2], M[0][3],
                              M[1][1], M[1][2], M[1][3],
                              M[3][1], M[3][2], M[3][3]) / det;
-        InvM[2][1] =
+        InvM[1][2] =
           -EvaluateDeterm3x3(M[0][0], M[0][2], M[0][3],
                              M[1][0], M[1][2], M[1][3],
                              M[3][0], M[3][2], M[3][3]) / det;
@@ -188,20 +206,20 @@ namespace mth
           +EvaluateDeterm3x3(M[0][0], M[0][1], M[0][3],
                              M[1][0], M[1][1], M[1][3],
                              M[3][0], M[3][1], M[3][3]) / det;
-        InvM[2][3] =
+        InvM[3][2] =
           -EvaluateDeterm3x3(M[0][0], M[0][1], M[0][2],
                              M[1][0], M[1][1], M[1][2],
                              M[3][0], M[3][1], M[3][2]) / det;
 
-        InvM[3][0] =
+        InvM[0][3] =
           -EvaluateDeterm3x3(M[0][1], M[0][2], M[0][3],
                              M[1][1], M[1][2], M[1][3],
                              M[2][1], M[2][2], M[2][3]) / det;
-        InvM[3][1] =
+        InvM[1][3] =
           +EvaluateDeterm3x3(M[0][0], M[0][2], M[0][3],
                              M[1][0], M[1][2], M[1][3],
                              M[2][0], M[2][2], M[2][3]) / det;
-        InvM[3][2] =
+        InvM[2][3] =
           -EvaluateDeterm3x3(M[0][0], M[0][1], M[0][3],
                              M[1][0], M[1][1], M[1][3],
                              M[2][0], M[2][1], M[2][3]) / det;
@@ -211,7 +229,7 @@ namespace mth
                              M[2][0], M[2][1], M[2][2]) / det;
 
         return matr(InvM);
-      } /* End of 'Inverse' function */
+      } /* End of 'EvaluateInverse' function */
 
       /* Get identity matrix function.
        * ARGUMENTS: None;
@@ -288,7 +306,7 @@ namespace mth
        */
       static matr RotateY( FLT AngleInDegree )
       {
-        FLT A = static_cast<FLT>(D2R(AngleInDegree)), s = sin(A), c = cos(A);
+        Type A = D2R(AngleInDegree), s = sin(A), c = cos(A);
         matr M = Identity();
 
         M.M[0][0] = c;
@@ -307,7 +325,7 @@ namespace mth
        */
       static matr RotateZ( FLT AngleInDegree )
       {
-        FLT A = D2R(AngleInDegree), s = sin(A), c = cos(A);
+        Type A = D2R(AngleInDegree), s = sin(A), c = cos(A);
         matr M = Identity();
 
         M.M[0][0] = c;
@@ -344,10 +362,7 @@ namespace mth
        */
       matr & Transpose()
       {
-        return *this = matr(M[0][0], M[1][0], M[2][0], M[3][0],
-                            M[0][1], M[1][1], M[2][1], M[3][1],
-                            M[0][2], M[1][2], M[2][2], M[3][2],
-                            M[0][3], M[1][3], M[2][3], M[3][3]);
+        return *this = Transpossing();
       } /* End of 'Transpose' function */
 
       /* Transpose matrix function.
@@ -357,10 +372,10 @@ namespace mth
        */
       matr Transpossing() const
       {
-        return matr(M[0][0], M[1][0], M[2][0], M[3][0],
-                    M[0][1], M[1][1], M[2][1], M[3][1],
-                    M[0][2], M[1][2], M[2][2], M[3][2],
-                    M[0][3], M[1][3], M[2][3], M[3][3]);
+        matr R;
+
+        kernel::Transpose(M, R.M);
+        return R;
       } /* End of 'Transpose' function */
 
       /* Multiplicate two matrices function.
@@ -370,39 +385,11 @@ namespace mth
        * RETURNS:
        *   (matr) result matrix.
        */
-      matr operator*( const matr &X )
+      matr operator*( const matr &X ) const
       {
-        INT i, j, k;
         matr R;
 
-        
-        for (i = 0; i < 4; i++)
-          for (j = 0; j < 4; j++)
-            for (k = 0; k < 4; k++)
-              R.M[i][j] += M[i][k] * X.M[k][j];
-        
-
-        /*
-        R.M[0]  = M[0] * M.M[0]  + M[4] * M.M[1]  + M[8] * M.M[2]   + M[12] * M.M[3];
-        R.M[4]  = M[0] * M.M[4]  + M[4] * M.M[5]  + M[8] * M.M[6]   + M[12] * M.M[7];
-        R.M[8]  = M[0] * M.M[8]  + M[4] * M.M[9]  + M[8] * M.M[10]  + M[12] * M.M[11];
-        R.M[12] = M[0] * M.M[12] + M[4] * M.M[13] + M[8] * M.M[14]  + M[12] * M.M[15];
-
-        R.M[1]  = M[1] * M.M[0]  + M[5] * M.M[1]  + M[9] * M.M[2]   + M[13] * M.M[3];
-        R.M[5]  = M[1] * M.M[4]  + M[5] * M.M[5]  + M[9] * M.M[6]   + M[13] * M.M[7];
-        R.M[9]  = M[1] * M.M[8]  + M[5] * M.M[9]  + M[9] * M.M[10]  + M[13] * M.M[11];
-        R.M[13] = M[1] * M.M[12] + M[5] * M.M[13] + M[9] * M.M[14]  + M[13] * M.M[15];
-
-        R.M[2]  = M[2] * M.M[0]  + M[6] * M.M[1]  + M[10] * M.M[2]  + M[14] * M.M[3];
-        R.M[6]  = M[2] * M.M[4]  + M[6] * M.M[5]  + M[10] * M.M[6]  + M[14] * M.M[7];
-        R.M[10] = M[2] * M.M[8]  + M[6] * M.M[9]  + M[10] * M.M[10] + M[14] * M.M[11];
-        R.M[14] = M[2] * M.M[12] + M[6] * M.M[13] + M[10] * M.M[14] + M[14] * M.M[15];
-
-        R.M[3]  = M[3] * M.M[0]  + M[7] * M.M[1]  + M[11] * M.M[2]  + M[15] * M.M[3];
-        R.M[7]  = M[3] * M.M[4]  + M[7] * M.M[5]  + M[11] * M.M[6]  + M[15] * M.M[7];
-        R.M[11] = M[3] * M.M[8]  + M[7] * M.M[9]  + M[11] * M.M[10] + M[15] * M.M[11];
-        R.M[15] = M[3] * M.M[12] + M[7] * M.M[13] + M[11] * M.M[14] + M[15] * M.M[15];
-        */
+        kernel::Mul(M, X.M, R.M);
         return R;
       } /* End of 'operator*' function */
 
@@ -413,16 +400,11 @@ namespace mth
        * RETURNS:
        *   (matr &) self reference.
        */
-      matr & operator*=( const matr &M )
+      matr & operator*=( const matr &X )
       {
-        INT i, j, k;
         matr R;
 
-        for (i = 0; i < 4; i++)
-          for (j = 0; j < 4; j++)
-            for (k = 0; k < 4; k++)
-              R.M[i][j] += M[i][k] * M.M[k][j];
-
+        kernel::Mul(M, X.M, R.M);
         return *this = R;
       } /* End of 'operator*=' function */
 
@@ -433,27 +415,37 @@ namespace mth
        * RETURNS:
        *   (vec3<Type>) result poINT.
        */
-      vec3<Type> PointTransform( const vec3<Type> &P )
+      vec3<Type> PointTransform( const vec3<Type> &P ) const
       {
-        return vec3<Type>(P.X * M[0][0] + P.Y * M[1][0] + P.Z * M[2][0] + M[3][0],
-                          P.X * M[0][1] + P.Y * M[1][1] + P.Z * M[2][1] + M[3][1],
-                          P.X * M[0][2] + P.Y * M[1][2] + P.Z * M[2][2] + M[3][2]);
+        return kernel::Point(M, P);
       } /* End of 'PointTransform' function */
 
-      /* Transform normal by matrix function.
+      /* Transform points array by matrix function.
+       * ARGUMENTS:
+       *   - source points:
+       *       const vec3<Type> *In;
+       *   - result points (may be the same as source):
+       *       vec3<Type> *Out;
+       *   - points count:
+       *       INT N;
+       * RETURNS: None.
+       */
+      VOID PointsTransform( const vec3<Type> *In, vec3<Type> *Out, INT N ) const
+      {
+        kernel::Points(M, In, Out, N);
+      } /* End of 'PointsTransform' function */
+
+      /* Transform direction vector by matrix function.
        * ARGUMENTS:
-       *   - reference at normal to transform:
-       *       const vec3<Type> &N;
+       *   - reference at vector to transform:
+       *       const vec3<Type> &V;
        * RETURNS:
-       *   (vec3<Type>) result normal.
+       *   (vec3<Type>) result vector (translation is not applied).
        */
-      vec3<Type> NormalTransform( const vec3<Type> &N )
+      vec3<Type> VectorTransform( const vec3<Type> &V ) const
       {
-        EvaluateInverse();
-        return vec3<Type>(N.X * InvM[0][0] + N.Y * InvM[1][0] + N.Z * InvM[2][0],
-                          N.X * InvM[0][1] + N.Y * InvM[1][1] + N.Z * InvM[2][1],
-                          N.X * InvM[0][2] + N.Y * InvM[1][2] + N.Z * InvM[2][2]);
-      } /* End of 'NormalTransform' function */
+        return kernel::Vector(M, V);
+      } /* End of 'VectorTransform' function */
 
       /* Transform vector by matrix function.
        * ARGUMENTS:
@@ -462,7 +454,7 @@ namespace mth
        * RETURNS:
        *   (vec3<Type>) result vector.
        */
-      vec3<Type> operator*( const vec3<Type> &V )
+      vec3<Type> operator*( const vec3<Type> &V ) const
       {
         Type w = V.X * (*this).M[0][3] + V.Y * (*this).M[1][3] + V.Z * (*this).M[2][3] + (*this).M[3][3];
 
@@ -478,7 +470,7 @@ namespace mth
        * RETURNS:
        *   (vec3<Type>) result vector.
        */
-      vec3<Type> Transform4x4( const vec3<Type> &V )
+      vec3<Type> Transform4x4( const vec3<Type> &V ) const
       {
         FLT w = V.X * (*this).M[0][3] + V.Y * (*this).M[1][3] + V.Z * (*this).M[2][3] + (*this).M[3][3];
 
@@ -3,7 +3,7 @@
  *               Window base class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 23.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -25,6 +25,11 @@ namespace mth
     public:
       vec3<Type> Org, Dir; // Ray origin and direction
 
+      /* Class default constructor */
+      ray( VOID ) : Org(), Dir(0, 0, 1)
+      {
+      } /* End of 'ray' function */
+
       /* Class constructor
        * ARGUMENTS:
        *   - ray origin:
@@ -49,6 +54,113 @@ namespace mth
       } /* End of 'operator()' function */
 
     }; /* End of 'ray' class */
+
+  /* Ray differentials type.
+   * Changes of ray origin and direction by one pixel step along frame
+   * X and Y axes (Igehy's ray differentials). Surfaces are treated as
+   * locally flat (normal derivatives are not known), so footprints of
+   * curved mirrors are underestimated.
+   */
+  template <typename Type = DBL>
+    class ray_diff
+    {
+    public:
+      vec3<Type>
+        dOdx, dOdy, // Origin differentials
+        dDdx, dDdy; // Direction differentials
+
+      /* Class default constructor (no differentials) */
+      ray_diff( VOID ) : dOdx(0), dOdy(0), dDdx(0), dDdy(0)
+      {
+      } /* End of 'ray_diff' function */
+
+      /* Class constructor.
+       * ARGUMENTS:
+       *   - origin differentials:
+       *       const vec3<Type> &DOdx, &DOdy;
+       *   - direction differentials:
+       *       const vec3<Type> &DDdx, &DDdy;
+       */
+      ray_diff( const vec3<Type> &DOdx, const vec3<Type> &DOdy, const vec3<Type> &DDdx, const vec3<Type> &DDdy ) :
+        dOdx(DOdx), dOdy(DOdy), dDdx(DDdx), dDdy(DDdy)
+      {
+      } /* End of 'ray_diff' function */
+
+      /* Move differentials to ray hit point function.
+       * Origin differentials become hit point differentials on surface plane.
+       * ARGUMENTS:
+       *   - ray direction:
+       *       const vec3<Type> &D;
+       *   - hit distance:
+       *       Type T;
+       *   - surface normal at hit:
+       *       const vec3<Type> &N;
+       * RETURNS:
+       *   (ray_diff &) self reference.
+       */
+      ray_diff & Transfer( const vec3<Type> &D, Type T, const vec3<Type> &N )
+      {
+        Type DN = D & N;
+
+        dOdx += dDdx * T;
+        dOdy += dDdy * T;
+        if (DN > 1e-8 || DN < -1e-8)
+        {
+          dOdx -= D * ((dOdx & N) / DN);
+          dOdy -= D * ((dOdy & N) / DN);
+        }
+        return *this;
+      } /* End of 'Transfer' function */
+
+      /* Get differentials of reflected ray function.
+       * Origin differentials should be transferred to hit point already.
+       * ARGUMENTS:
+       *   - incident direction:
+       *       const vec3<Type> &D;
+       *   - surface normal:
+       *       const vec3<Type> &N;
+       * RETURNS:
+       *   (ray_diff) reflected ray differentials.
+       */
+      ray_diff Reflect( const vec3<Type> &D, const vec3<Type> &N ) const
+      {
+        return ray_diff(dOdx, dOdy, dDdx - N * (2 * (dDdx & N)), dDdy - N * (2 * (dDdy & N)));
+      } /* End of 'Reflect' function */
+
+      /* Get differentials of refracted ray function.
+       * Refracted direction is Eta * (D - N (D N)) - N sqrt(1 - (1 - (D N)^2) Eta^2).
+       * ARGUMENTS:
+       *   - incident direction:
+       *       const vec3<Type> &D;
+       *   - surface normal:
+       *       const vec3<Type> &N;
+       *   - relative refraction index:
+       *       Type Eta;
+       * RETURNS:
+       *   (ray_diff) refracted ray differentials.
+       */
+      ray_diff Refract( const vec3<Type> &D, const vec3<Type> &N, Type Eta ) const
+      {
+        Type
+          DN = D & N,
+          S = 1 - (1 - DN * DN) * Eta * Eta,
+          K = S > 1e-8 ? Eta + Eta * Eta * DN / sqrt(S) : Eta;
+
+        return ray_diff(dOdx, dOdy, dDdx * Eta - N * (K * (dDdx & N)), dDdy * Eta - N * (K * (dDdy & N)));
+      } /* End of 'Refract' function */
+
+      /* Get footprint width function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (Type) largest origin change by one pixel step.
+       */
+      Type Width( VOID ) const
+      {
+        Type wx = !dOdx, wy = !dOdy;
+
+        return wx > wy ? wx : wy;
+      } /* End of 'Width' function */
+    }; /* End of 'ray_diff' class */
 } /* end of 'mth' namespace */
 
 #endif // __mth_ray_h_
@@ -0,0 +1,98 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : mth_rnd.h
+ * PURPOSE     : Raytracing project.
+ *               Random numbers generator class implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'mth'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __mth_rnd_h_
+#define __mth_rnd_h_
+
+#include "mth_def.h"
+
+namespace mth
+{
+  /* Pseudo random numbers generator type (xorshift64*).
+   * Unlike 'rand' it has no hidden global state, so every ray path
+   * owns its generator and sequences are reproducible by seed.
+   */
+  class rnd
+  {
+  public:
+    UINT64 State; // Generator state
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - start seed:
+     *       UINT64 StartSeed;
+     */
+    rnd( UINT64 StartSeed = 0x853C49E6748FEA9BULL ) : State()
+    {
+      Seed(StartSeed);
+    } /* End of 'rnd' function */
+
+    /* Reset generator by seed function.
+     * ARGUMENTS:
+     *   - new seed:
+     *       UINT64 NewSeed;
+     * RETURNS: None.
+     */
+    VOID Seed( UINT64 NewSeed )
+    {
+      // splitmix64 step to spread bad (small, sequential) seeds
+      UINT64 z = NewSeed + 0x9E3779B97F4A7C15ULL;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      State = z ^ (z >> 31);
+      if (State == 0)
+        State = 0x853C49E6748FEA9BULL;
+    } /* End of 'Seed' function */
+
+    /* Reset generator by several integer keys function.
+     * ARGUMENTS:
+     *   - keys (e.g. pixel coordinates and sample number):
+     *       UINT64 A, B, C;
+     * RETURNS: None.
+     */
+    VOID Seed( UINT64 A, UINT64 B, UINT64 C )
+    {
+      Seed(A * 0x9E3779B97F4A7C15ULL ^ (B + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL ^ C * 0x165667B19E3779F9ULL);
+    } /* End of 'Seed' function */
+
+    /* Get next random integer function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (UINT64) random integer.
+     */
+    UINT64 Next( VOID )
+    {
+      State ^= State >> 12;
+      State ^= State << 25;
+      State ^= State >> 27;
+      return State * 0x2545F4914F6CDD1DULL;
+    } /* End of 'Next' function */
+
+    /* Get random number from 0 (inclusive) to 1 (exclusive) function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) random number.
+     */
+    DBL operator()( VOID )
+    {
+      return (Next() >> 11) * (1.0 / 9007199254740992.0);
+    } /* End of 'operator()' function */
+  }; /* End of 'rnd' class */
+} /* end of 'mth' namespace */
+
+#endif // __mth_rnd_h_
+
+/* END OF 'mth_rnd.h' FILE */
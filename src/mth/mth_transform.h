@@ -0,0 +1,254 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : mth_transform.h
+ * PURPOSE     : Raytracing project.
+ *               Immutable transformation class implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'mth'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __mth_transform_h_
+#define __mth_transform_h_
+
+#include "mth_matr.h"
+
+namespace mth
+{
+  /* Space transformation type.
+   * Forward, inverse and normal matrices are evaluated once by constructor
+   * and never changed, so one transformation may be used by all render
+   * threads without locks. Simple transforms have exact inverses, other
+   * affine matrices (the most of object transforms) are inverted by 3x3 part.
+   */
+  template <typename Type = DBL>
+    class transform
+    {
+      matr<Type> M, InvM; // Forward and inverse matrices
+      matr<Type> NormM;   // Normal matrix (transposed inverse, 3x3 part is used)
+      BOOL IsAffine;      // Matrices have no projective part flag
+
+      /* Class constructor by both matrices.
+       * ARGUMENTS:
+       *   - forward and inverse matrices:
+       *       const matr<Type> &Matr, &InvMatr;
+       */
+      transform( const matr<Type> &Matr, const matr<Type> &InvMatr ) :
+        M(Matr), InvM(InvMatr), NormM(InvMatr.Transpossing()), IsAffine(Matr.IsAffine())
+      {
+      } /* End of 'transform' function */
+
+    public:
+      /* Class default constructor (identity transformation) */
+      transform( VOID ) : M(matr<Type>::Identity()), InvM(matr<Type>::Identity()), NormM(matr<Type>::Identity()), IsAffine(TRUE)
+      {
+      } /* End of 'transform' function */
+
+      /* Class constructor by matrix.
+       * ARGUMENTS:
+       *   - reference at matrix:
+       *       const matr<Type> &Matr;
+       */
+      explicit transform( const matr<Type> &Matr ) :
+        M(Matr), InvM(Matr.EvaluateInverse()), NormM(InvM.Transpossing()), IsAffine(Matr.IsAffine())
+      {
+      } /* End of 'transform' function */
+
+      /* Get translation function.
+       * ARGUMENTS:
+       *   - reference at translation vector:
+       *       const vec3<Type> &T;
+       * RETURNS:
+       *   (transform) translation.
+       */
+      static transform Translate( const vec3<Type> &T )
+      {
+        return transform(matr<Type>::Translate(T), matr<Type>::Translate(-T));
+      } /* End of 'Translate' function */
+
+      /* Get scale function.
+       * ARGUMENTS:
+       *   - reference at scale coefficients (not zero):
+       *       const vec3<Type> &S;
+       * RETURNS:
+       *   (transform) scale.
+       */
+      static transform Scale( const vec3<Type> &S )
+      {
+        return transform(matr<Type>::Scale(S), matr<Type>::Scale(vec3<Type>(1 / S.X, 1 / S.Y, 1 / S.Z)));
+      } /* End of 'Scale' function */
+
+      /* Get rotation around X axis function.
+       * ARGUMENTS:
+       *   - angle:
+       *       FLT AngleInDegree;
+       * RETURNS:
+       *   (transform) rotation.
+       */
+      static transform RotateX( FLT AngleInDegree )
+      {
+        matr<Type> R = matr<Type>::RotateX(AngleInDegree);
+
+        return transform(R, R.Transpossing());
+      } /* End of 'RotateX' function */
+
+      /* Get rotation around Y axis function.
+       * ARGUMENTS:
+       *   - angle:
+       *       FLT AngleInDegree;
+       * RETURNS:
+       *   (transform) rotation.
+       */
+      static transform RotateY( FLT AngleInDegree )
+      {
+        matr<Type> R = matr<Type>::RotateY(AngleInDegree);
+
+        return transform(R, R.Transpossing());
+      } /* End of 'RotateY' function */
+
+      /* Get rotation around Z axis function.
+       * ARGUMENTS:
+       *   - angle:
+       *       FLT AngleInDegree;
+       * RETURNS:
+       *   (transform) rotation.
+       */
+      static transform RotateZ( FLT AngleInDegree )
+      {
+        matr<Type> R = matr<Type>::RotateZ(AngleInDegree);
+
+        return transform(R, R.Transpossing());
+      } /* End of 'RotateZ' function */
+
+      /* Get forward matrix function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (const matr<Type> &) forward matrix.
+       */
+      const matr<Type> & GetMatr( VOID ) const
+      {
+        return M;
+      } /* End of 'GetMatr' function */
+
+      /* Get inverse matrix function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (const matr<Type> &) inverse matrix.
+       */
+      const matr<Type> & GetInverseMatr( VOID ) const
+      {
+        return InvM;
+      } /* End of 'GetInverseMatr' function */
+
+      /* Get inverse transformation function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (transform) inverse transformation.
+       */
+      transform Inverse( VOID ) const
+      {
+        return transform(InvM, M);
+      } /* End of 'Inverse' function */
+
+      /* Combine transformations function.
+       * ARGUMENTS:
+       *   - reference at transformation applied after this one:
+       *       const transform &T;
+       * RETURNS:
+       *   (transform) combined transformation (inverse is multiplied too).
+       */
+      transform operator*( const transform &T ) const
+      {
+        return transform(M * T.M, T.InvM * InvM);
+      } /* End of 'operator*' function */
+
+      /* Transform point function.
+       * ARGUMENTS:
+       *   - reference at point:
+       *       const vec3<Type> &P;
+       * RETURNS:
+       *   (vec3<Type>) transformed point.
+       */
+      vec3<Type> Point( const vec3<Type> &P ) const
+      {
+        return IsAffine ? M.PointTransform(P) : M * P;
+      } /* End of 'Point' function */
+
+      /* Transform points array function.
+       * ARGUMENTS:
+       *   - source points:
+       *       const vec3<Type> *In;
+       *   - result points (may be the same as source):
+       *       vec3<Type> *Out;
+       *   - points count:
+       *       INT N;
+       * RETURNS: None.
+       */
+      VOID Points( const vec3<Type> *In, vec3<Type> *Out, INT N ) const
+      {
+        if (IsAffine)
+          M.PointsTransform(In, Out, N);
+        else
+          for (INT i = 0; i < N; i++)
+            Out[i] = M * In[i];
+      } /* End of 'Points' function */
+
+      /* Transform direction vector function.
+       * ARGUMENTS:
+       *   - reference at vector:
+       *       const vec3<Type> &V;
+       * RETURNS:
+       *   (vec3<Type>) transformed vector.
+       */
+      vec3<Type> Vector( const vec3<Type> &V ) const
+      {
+        return M.VectorTransform(V);
+      } /* End of 'Vector' function */
+
+      /* Transform normal function.
+       * ARGUMENTS:
+       *   - reference at normal:
+       *       const vec3<Type> &N;
+       * RETURNS:
+       *   (vec3<Type>) transformed normal (not normalized).
+       */
+      vec3<Type> Normal( const vec3<Type> &N ) const
+      {
+        return NormM.VectorTransform(N);
+      } /* End of 'Normal' function */
+
+      /* Inverse transform point function.
+       * ARGUMENTS:
+       *   - reference at point:
+       *       const vec3<Type> &P;
+       * RETURNS:
+       *   (vec3<Type>) transformed point.
+       */
+      vec3<Type> InvPoint( const vec3<Type> &P ) const
+      {
+        return IsAffine ? InvM.PointTransform(P) : InvM * P;
+      } /* End of 'InvPoint' function */
+
+      /* Inverse transform direction vector function.
+       * ARGUMENTS:
+       *   - reference at vector:
+       *       const vec3<Type> &V;
+       * RETURNS:
+       *   (vec3<Type>) transformed vector.
+       */
+      vec3<Type> InvVector( const vec3<Type> &V ) const
+      {
+        return InvM.VectorTransform(V);
+      } /* End of 'InvVector' function */
+    }; /* End of 'transform' class */
+} /* end of 'mth' namespace */
+
+#endif // __mth_transform_h_
+
+/* END OF 'mth_transform.h' FILE */
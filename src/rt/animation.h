@@ -0,0 +1,169 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : animation.h
+ * PURPOSE     : Raytracing project.
+ *               Offline animation sequence rendering module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __animation_h_
+#define __animation_h_
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+#include "rt/scene.h"
+#include "rt/image_saver.h"
+
+namespace dart
+{
+  /* Offline animation sequence renderer class.
+   * Renders frames of timer driven animation (camera orbit, rotators)
+   * at fixed time step to numbered RLE TGA or PNG files. Several
+   * frames are rendered at once, every one by its share of processor
+   * cores, files are encoded by saver thread meanwhile.
+   */
+  class animation
+  {
+    /* Get frame file name function.
+     * ARGUMENTS:
+     *   - frame number:
+     *       INT Frame;
+     *   - name buffer (300 characters):
+     *       CHAR *Buf;
+     * RETURNS:
+     *   (CHAR *) file name.
+     */
+    CHAR * FileName( INT Frame, CHAR *Buf ) const
+    {
+      snprintf(Buf, 290, Pattern, Frame);
+      return Buf;
+    } /* End of 'FileName' function */
+
+  public:
+    INT W, H;            // Frames size
+    INT First, Last;     // Frames numbers range (inclusive)
+    DBL Step;            // Animation time per frame
+    INT Workers;         // Frames rendered at once
+    const CHAR *Pattern; // Files names format (with frame number)
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - frames size:
+     *       INT Width, Height;
+     *   - frames numbers range (inclusive):
+     *       INT FirstFrame, LastFrame;
+     *   - animation time per frame:
+     *       DBL TimeStep;
+     *   - frames rendered at once:
+     *       INT FramesAtOnce;
+     *   - files names format (printf format with frame number):
+     *       const CHAR *NamePattern;
+     */
+    animation( INT Width, INT Height, INT FirstFrame, INT LastFrame, DBL TimeStep,
+               INT FramesAtOnce = 2, const CHAR *NamePattern = "frame_%05d.tga" ) :
+      W(Width), H(Height), First(FirstFrame), Last(LastFrame), Step(TimeStep),
+      Workers(FramesAtOnce), Pattern(NamePattern)
+    {
+    } /* End of 'animation' function */
+
+    /* Check if frame file is already written function.
+     * ARGUMENTS:
+     *   - frame number:
+     *       INT Frame;
+     * RETURNS:
+     *   (BOOL) TRUE if frame is completed, FALSE overwise.
+     */
+    BOOL IsCompleted( INT Frame ) const
+    {
+      CHAR Buf[300];
+      FILE *F = fopen(FileName(Frame, Buf), "rb");
+
+      if (F == nullptr)
+        return FALSE;
+      fclose(F);
+      return TRUE;
+    } /* End of 'IsCompleted' function */
+
+    /* Render frames sequence function.
+     * Every frame is written under temporary name and renamed when
+     * completed (see 'image_saver::Write'), so interrupted sequence is
+     * resumed by the same call (frames with files are skipped).
+     * ARGUMENTS:
+     *   - scene building function (called once per worker, should
+     *     build the same scene every time):
+     *       const std::function<VOID( scene & )> &Build;
+     * RETURNS:
+     *   (INT) written frames count.
+     */
+    INT Render( const std::function<VOID( scene & )> &Build )
+    {
+      INT
+        workers = COM_MAX(1, COM_MIN(Workers, Last - First + 1)),
+        cores = COM_MAX(1, ParallelThreads() / workers);
+      std::atomic<INT> Next(First);
+      stock<scene *> Scenes;
+      image_saver Saver(workers * 2);
+
+      // scenes are built one by one (builders may use 'rand')
+      for (INT i = 0; i < workers; i++)
+      {
+        Scenes.push_back(new scene);
+        Build(*Scenes.back());
+      }
+
+      auto Work =
+        [&]( scene *Scene )
+        {
+          stock<DWORD> Image;
+          frame Frm(W, H);
+          camera Cam;
+          CHAR Name[300];
+
+          ParallelThreads() = cores;
+          Image.resize(W * H);
+          Frm.Image = Image.data();
+          Cam.Resize(W, H);
+
+          // frames of one worker are not neighbours, every frame is exact
+          Scene->IsReproject = FALSE;
+          for (INT f = Next++; f <= Last; f = Next++)
+          {
+            if (IsCompleted(f))
+              continue;
+
+            // camera and modifiers take time from timer in 'scene::Update'
+            Scene->Timer.Set(f * Step, Step);
+            Scene->Render(Cam, Frm);
+            Saver.Save(FileName(f, Name), Frm.Image, W, H);
+          }
+        };
+
+      stock<std::thread> Ths;
+      for (INT i = 1; i < workers; i++)
+        Ths.push_back(std::thread(Work, Scenes[i]));
+      Work(Scenes[0]);
+      for (auto &th : Ths)
+        th.join();
+
+      for (auto scn : Scenes)
+        delete scn;
+      Saver.Flush();
+      return Saver.Written;
+    } /* End of 'Render' function */
+  }; /* End of 'animation' class */
+} /* end of 'dart' namespace */
+
+#endif // __animation_h_
+
+/* END OF 'animation.h' FILE */
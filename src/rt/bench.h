@@ -0,0 +1,189 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : bench.h
+ * PURPOSE     : Raytracing project.
+ *               Offscreen rendering benchmark module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __bench_h_
+#define __bench_h_
+
+#include <cstdio>
+
+#include "rt/scene.h"
+#include "rt/image_encoder.h"
+
+namespace dart
+{
+  /* Benchmark log class */
+  class bench
+  {
+    FILE *Log; // Results log file
+
+  public:
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - log file name:
+     *       const CHAR *FileName;
+     */
+    bench( const CHAR *FileName = "bench.log" ) : Log(fopen(FileName, "w"))
+    {
+    } /* End of 'bench' function */
+
+    /* Class destructor */
+    ~bench( VOID )
+    {
+      if (Log != nullptr)
+        fclose(Log);
+    } /* End of '~bench' function */
+
+    /* Get current time in seconds function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) time in seconds.
+     */
+    static DBL Time( VOID )
+    {
+      return (DBL)timer::Counter() / timer::Frequency();
+    } /* End of 'Time' function */
+
+    /* Write line to log function.
+     * ARGUMENTS:
+     *   - format string and its arguments (as in 'printf'):
+     *       const CHAR *Fmt, ...;
+     * RETURNS: None.
+     */
+    template <typename... Args>
+      VOID Print( const CHAR *Fmt, Args... A )
+      {
+        if (Log == nullptr)
+          return;
+        fprintf(Log, Fmt, A...);
+        fputc('\n', Log);
+        fflush(Log);
+      } /* End of 'Print' function */
+
+    /* Measure function run time function.
+     * ARGUMENTS:
+     *   - test name:
+     *       const CHAR *Name;
+     *   - runs count:
+     *       INT Count;
+     *   - function to run:
+     *       FuncType F;
+     * RETURNS:
+     *   (DBL) average run time in seconds.
+     */
+    template <typename FuncType>
+      DBL Measure( const CHAR *Name, INT Count, FuncType F )
+      {
+        DBL start = Time();
+
+        for (INT i = 0; i < Count; i++)
+          F();
+
+        DBL t = (Time() - start) / Count;
+
+        Print("%-40s %10.3f ms", Name, t * 1000);
+        return t;
+      } /* End of 'Measure' function */
+
+    /* Measure scene rendering to offscreen frame function.
+     * ARGUMENTS:
+     *   - test name:
+     *       const CHAR *Name;
+     *   - reference at scene:
+     *       scene &Scene;
+     *   - frame size:
+     *       INT W, H;
+     *   - frames count:
+     *       INT Count;
+     *   - scene changes reported before every frame (scene::CHANGED_*** flags):
+     *       UINT Changes;
+     *   - camera orbit angle step per frame (0 for still camera):
+     *       DBL Step;
+     *   - tiled frame layout flag:
+     *       BOOL IsTiled;
+     * RETURNS:
+     *   (DBL) average frame time in seconds.
+     */
+    DBL Render( const CHAR *Name, scene &Scene, INT W, INT H, INT Count,
+                UINT Changes = scene::CHANGED_CAMERA, DBL Step = 0, BOOL IsTiled = FALSE )
+    {
+      stock<DWORD> Image;
+      frame Frm(W, H);
+      camera Cam;
+
+      Frm.SetTiled(IsTiled);
+
+      Image.resize(W * H);
+      Frm.Image = Image.data();
+      Cam.Resize(W, H);
+      Cam.Set(vec3(0, Scene.CamDist, Scene.CamDist), vec3(0), vec3(0, 1, 0));
+      Scene.Timer.IsPause = TRUE;
+      Scene.Render(Cam, Frm);
+
+      INT frame = 0;
+      DBL t = Measure(Name, Count,
+        [&]( VOID )
+        {
+          DBL a = ++frame * Step;
+
+          Cam.Set(vec3(Scene.CamDist * sin(a), Scene.CamDist, Scene.CamDist * cos(a)), vec3(0), vec3(0, 1, 0));
+          Scene.Invalidate(Changes);
+          Scene.Render(Cam, Frm);
+        });
+
+      Print("%-40s %10lld rays, %.3f Mrays/s", "", Scene.Stats.Traced, Scene.Stats.Traced / t / 1e6);
+      return t;
+    } /* End of 'Render' function */
+
+    /* Measure image encoders throughput function.
+     * ARGUMENTS:
+     *   - test name:
+     *       const CHAR *Name;
+     *   - image pixels (rows from top to bottom, as in frame):
+     *       const DWORD *Image;
+     *   - image size:
+     *       INT W, H;
+     *   - encodings count:
+     *       INT Count;
+     * RETURNS: None.
+     */
+    VOID Encode( const CHAR *Name, const DWORD *Image, INT W, INT H, INT Count )
+    {
+      const CHAR *Formats[2] = {"RLE TGA", "PNG"};
+      stock<BYTE> Data;
+      CHAR Buf[100];
+
+      for (INT f = 0; f < 2; f++)
+      {
+        snprintf(Buf, sizeof(Buf), "%s %s", Name, Formats[f]);
+
+        DBL t = Measure(Buf, Count,
+          [&]( VOID )
+          {
+            if (f == 0)
+              image_encoder::EncodeTga(Image, W, H, Data);
+            else
+              image_encoder::EncodePng(Image, W, H, Data);
+          });
+
+        Print("%-40s %10.1f MB/s, %.1f%% of raw size", "", W * H * 4 / t / (1 << 20), Data.size() * 100.0 / (W * H * 4));
+      }
+    } /* End of 'Encode' function */
+  }; /* End of 'bench' class */
+} /* end of 'dart' namespace */
+
+#endif // __bench_h_
+
+/* END OF 'bench.h' FILE */
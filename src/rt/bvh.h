@@ -0,0 +1,651 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : bvh.h
+ * PURPOSE     : Raytracing project.
+ *               Shapes bounding volume hierarchy module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __bvh_h_
+#define __bvh_h_
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "rt/shapes/shape_def.h"
+
+namespace dart
+{
+  /* Shapes bounding volume hierarchy class.
+   * Bounded shapes are stored in binary tree of bound boxes,
+   * unbounded ones (planes) are tested with every ray. Besides
+   * single ray queries tree can be traversed by batch of rays at
+   * once: every node is fetched one time for the whole batch and
+   * leaf shapes are intersected with all rays still hitting it.
+   */
+  class bvh
+  {
+  public:
+    /* Tree node struct */
+    struct node
+    {
+      vec3 Min, Max;   // Node bound box
+      INT Left, Right;  // Children indices for inner node
+      INT Axis;         // Split axis for inner node
+      INT Start, Count; // Shapes range for leaf (Count is 0 for inner node)
+    }; /* End of 'node' struct */
+
+  private:
+    /* Bounded shape struct */
+    struct item
+    {
+      shape *Shp;       // Shape
+      vec3 Min, Max, C; // Shape bound box and its center
+    }; /* End of 'item' struct */
+
+    stock<node> Nodes;  // Tree nodes (root is first)
+    stock<item> Items;  // Bounded shapes in tree order
+
+    /* Build subtree function.
+     * ARGUMENTS:
+     *   - shapes range to build:
+     *       INT Start, End;
+     * RETURNS:
+     *   (INT) built node index.
+     */
+    INT Build( INT Start, INT End )
+    {
+      INT Index = (INT)Nodes.size();
+      node Nd;
+      vec3 CMin(DBL_MAX), CMax(-DBL_MAX);
+
+      Nd.Min = vec3(DBL_MAX), Nd.Max = vec3(-DBL_MAX), Nd.Left = Nd.Right = -1, Nd.Axis = 0, Nd.Start = Start, Nd.Count = 0;
+      for (INT i = Start; i < End; i++)
+      {
+        const item &It = Items[i];
+
+        Nd.Min = vec3(COM_MIN(Nd.Min.X, It.Min.X), COM_MIN(Nd.Min.Y, It.Min.Y), COM_MIN(Nd.Min.Z, It.Min.Z));
+        Nd.Max = vec3(COM_MAX(Nd.Max.X, It.Max.X), COM_MAX(Nd.Max.Y, It.Max.Y), COM_MAX(Nd.Max.Z, It.Max.Z));
+        CMin = vec3(COM_MIN(CMin.X, It.C.X), COM_MIN(CMin.Y, It.C.Y), COM_MIN(CMin.Z, It.C.Z));
+        CMax = vec3(COM_MAX(CMax.X, It.C.X), COM_MAX(CMax.Y, It.C.Y), COM_MAX(CMax.Z, It.C.Z));
+      }
+      Nodes.push_back(Nd);
+      if (End - Start <= LeafSize)
+      {
+        Nodes[Index].Count = End - Start;
+        return Index;
+      }
+
+      // split by median of centers along the longest axis
+      vec3 Size = CMax - CMin;
+      INT Axis = Size.X > Size.Y ? (Size.X > Size.Z ? 0 : 2) : (Size.Y > Size.Z ? 1 : 2);
+      INT Mid = (Start + End) / 2;
+
+      std::nth_element(Items.begin() + Start, Items.begin() + Mid, Items.begin() + End,
+        [Axis]( const item &A, const item &B )
+        {
+          return A.C[Axis] < B.C[Axis];
+        });
+
+      INT L = Build(Start, Mid), R = Build(Mid, End);
+      Nodes[Index].Left = L, Nodes[Index].Right = R, Nodes[Index].Axis = Axis;
+      return Index;
+    } /* End of 'Build' function */
+
+    /* Intersect ray with node bound box function.
+     * ARGUMENTS:
+     *   - reference at node:
+     *       const node &Nd;
+     *   - reference at ray origin and inversed direction:
+     *       const vec3 &Org, &InvDir;
+     *   - pointer at box entry distance:
+     *       DBL *T;
+     * RETURNS:
+     *   (BOOL) TRUE if ray hits box, FALSE overwise.
+     */
+    static BOOL IsBoxHit( const node &Nd, const vec3 &Org, const vec3 &InvDir, DBL *T )
+    {
+      DBL tnear = 0, tfar = DBL_MAX;
+
+      for (INT i = 0; i < 3; i++)
+      {
+        DBL
+          t0 = (Nd.Min[i] - Threshold - Org[i]) * InvDir[i],
+          t1 = (Nd.Max[i] + Threshold - Org[i]) * InvDir[i];
+
+        if (t0 > t1)
+          std::swap(t0, t1);
+        tnear = COM_MAX(tnear, t0);
+        tfar = COM_MIN(tfar, t1);
+        if (tnear > tfar)
+          return FALSE;
+      }
+      *T = tnear;
+      return TRUE;
+    } /* End of 'IsBoxHit' function */
+
+    /* Intersect ray with shape and keep the closest hit function.
+     * ARGUMENTS:
+     *   - pointer at shape:
+     *       shape *Shp;
+     *   - reference at ray:
+     *       const ray &R;
+     *   - pointer at closest intersection:
+     *       intr *Best;
+     * RETURNS: None.
+     */
+    static VOID Closest( shape *Shp, const ray &R, intr *Best )
+    {
+      intr in;
+
+      if (Shp->WorldIntersect(R, &in))
+        if (Best->Shp == nullptr || Best->T > in.T)
+          *Best = in;
+    } /* End of 'Closest' function */
+
+    /* Determine if shape blocks ray segment function.
+     * ARGUMENTS:
+     *   - pointer at shape:
+     *       shape *Shp;
+     *   - reference at ray:
+     *       const ray &R;
+     *   - segment length:
+     *       DBL Dist;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is hit closer than segment end, FALSE overwise.
+     */
+    static BOOL IsBlocking( shape *Shp, const ray &R, DBL Dist )
+    {
+      intr in;
+
+      return Shp->WorldIntersect(R, &in) && in.T < Dist;
+    } /* End of 'IsBlocking' function */
+
+    /* Get node bound box surface area function.
+     * ARGUMENTS:
+     *   - reference at node:
+     *       const node &Nd;
+     * RETURNS:
+     *   (DBL) surface area.
+     */
+    static DBL Area( const node &Nd )
+    {
+      vec3 D = Nd.Max - Nd.Min;
+
+      return 2 * (D.X * D.Y + D.Y * D.Z + D.Z * D.X);
+    } /* End of 'Area' function */
+
+    /* Recompute nodes bound boxes by shapes ones function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if nodes area grew not more than 'RefitLimit' times, FALSE overwise.
+     */
+    BOOL RefitNodes( VOID )
+    {
+      DBL OldArea = 0, NewArea = 0;
+
+      for (INT i = (INT)Nodes.size() - 1; i >= 0; i--)
+      {
+        node &Nd = Nodes[i];
+
+        OldArea += Area(Nd);
+        if (Nd.Count > 0)
+        {
+          Nd.Min = Items[Nd.Start].Min, Nd.Max = Items[Nd.Start].Max;
+          for (INT j = Nd.Start + 1; j < Nd.Start + Nd.Count; j++)
+          {
+            const item &It = Items[j];
+
+            Nd.Min = vec3(COM_MIN(Nd.Min.X, It.Min.X), COM_MIN(Nd.Min.Y, It.Min.Y), COM_MIN(Nd.Min.Z, It.Min.Z));
+            Nd.Max = vec3(COM_MAX(Nd.Max.X, It.Max.X), COM_MAX(Nd.Max.Y, It.Max.Y), COM_MAX(Nd.Max.Z, It.Max.Z));
+          }
+        }
+        else
+        {
+          const node &L = Nodes[Nd.Left], &R = Nodes[Nd.Right];
+
+          Nd.Min = vec3(COM_MIN(L.Min.X, R.Min.X), COM_MIN(L.Min.Y, R.Min.Y), COM_MIN(L.Min.Z, R.Min.Z));
+          Nd.Max = vec3(COM_MAX(L.Max.X, R.Max.X), COM_MAX(L.Max.Y, R.Max.Y), COM_MAX(L.Max.Z, R.Max.Z));
+        }
+        NewArea += Area(Nd);
+      }
+      return NewArea <= OldArea * RefitLimit;
+    } /* End of 'RefitNodes' function */
+
+  public:
+    static const INT LeafSize = 2;  // Maximum shapes in leaf
+    static const INT MaxBatch = 64; // Maximum rays traversed together
+    static const INT MaxDepth = 48; // Maximum tree depth (fits traversal stacks)
+    static const INT RefitLimit = 2; // Allowed growth of nodes area by refit
+
+    stock<shape *> Unbounded; // Shapes without bound box
+
+    /* Build tree by shapes list function.
+     * ARGUMENTS:
+     *   - reference at shapes list:
+     *       const stock<shape *> &Shapes;
+     * RETURNS: None.
+     */
+    VOID Build( const stock<shape *> &Shapes )
+    {
+      Nodes.clear();
+      Items.clear();
+      Unbounded.clear();
+      for (auto shp : Shapes)
+      {
+        item It;
+
+        It.Shp = shp;
+        if (shp->WorldBound(&It.Min, &It.Max))
+        {
+          It.C = (It.Min + It.Max) / 2;
+          Items << It;
+        }
+        else
+          Unbounded << shp;
+      }
+      Nodes.reserve(Items.size() * 2);
+      if (!Items.empty())
+        Build(0, (INT)Items.size());
+    } /* End of 'Build' function */
+
+    /* Get tree nodes function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const stock<node> &) nodes (root is first, children are after parent).
+     */
+    const stock<node> & GetNodes( VOID ) const
+    {
+      return Nodes;
+    } /* End of 'GetNodes' function */
+
+    /* Get bounded shapes in tree order function.
+     * ARGUMENTS:
+     *   - reference at shapes list to fill:
+     *       stock<shape *> &Shapes;
+     * RETURNS: None.
+     */
+    VOID GetItems( stock<shape *> &Shapes ) const
+    {
+      Shapes.clear();
+      for (auto &it : Items)
+        Shapes << it.Shp;
+    } /* End of 'GetItems' function */
+
+    /* Set already built tree function.
+     * Tree is checked so it never leaves nodes or shapes arrays and
+     * fits traversal stack, shapes bound boxes are taken from shapes.
+     * ARGUMENTS:
+     *   - tree nodes (as got by 'GetNodes'):
+     *       const node *TreeNodes, INT NodesCount;
+     *   - bounded shapes in tree order (as got by 'GetItems'):
+     *       const stock<shape *> &Shapes;
+     *   - shapes without bound box:
+     *       const stock<shape *> &UnboundedShapes;
+     * RETURNS:
+     *   (BOOL) TRUE if tree is set, FALSE if it is not valid (tree is empty).
+     */
+    BOOL Assign( const node *TreeNodes, INT NodesCount, const stock<shape *> &Shapes,
+                 const stock<shape *> &UnboundedShapes )
+    {
+      INT n = (INT)Shapes.size();
+      stock<BYTE> Depth;
+
+      Nodes.clear();
+      Items.clear();
+      Unbounded = UnboundedShapes;
+      if ((NodesCount == 0) != (n == 0))
+        return FALSE;
+
+      // children follow parents, so depth is known when node is checked
+      Depth.assign(NodesCount, 0);
+      for (INT i = 0; i < NodesCount; i++)
+      {
+        const node &Nd = TreeNodes[i];
+
+        if (Nd.Count < 0 || (Nd.Count > 0 ? Nd.Start < 0 || Nd.Count > n - Nd.Start :
+            Nd.Left <= i || Nd.Right <= i || Nd.Left >= NodesCount || Nd.Right >= NodesCount ||
+            Depth[i] >= MaxDepth || Nd.Axis < 0 || Nd.Axis > 2))
+          return FALSE;
+        if (Nd.Count == 0)
+          Depth[Nd.Left] = Depth[Nd.Right] = Depth[i] + 1;
+      }
+
+      Items.resize(n);
+      for (INT i = 0; i < n; i++)
+      {
+        item &It = Items[i];
+
+        It.Shp = Shapes[i];
+        It.Shp->WorldBound(&It.Min, &It.Max);
+        It.C = (It.Min + It.Max) / 2;
+      }
+      Nodes.assign(TreeNodes, TreeNodes + NodesCount);
+      return TRUE;
+    } /* End of 'Assign' function */
+
+    /* Replace shapes and refit tree function.
+     * Tree topology is kept, bound boxes of replaced shapes and all
+     * nodes are recomputed from leaves to root (children are after
+     * parents). Refitted tree is rejected if its nodes area (ray
+     * traversal cost estimation) grows more than 'RefitLimit' times.
+     * ARGUMENTS:
+     *   - replaced shapes (old and new ones):
+     *       const stock<std::pair<shape *, shape *>> &Replaced;
+     * RETURNS:
+     *   (BOOL) TRUE if tree is refitted, FALSE if it should be built again
+     *   (shape got or lost bound box or tree became too loose).
+     */
+    BOOL Refit( const stock<std::pair<shape *, shape *>> &Replaced )
+    {
+      std::unordered_map<shape *, shape *> Map(Replaced.begin(), Replaced.end());
+      vec3 Min, Max;
+
+      for (auto &shp : Unbounded)
+      {
+        auto it = Map.find(shp);
+
+        if (it != Map.end())
+          if ((shp = it->second)->WorldBound(&Min, &Max))
+            return FALSE;
+      }
+      for (auto &It : Items)
+      {
+        auto it = Map.find(It.Shp);
+
+        if (it != Map.end())
+        {
+          It.Shp = it->second;
+          if (!It.Shp->WorldBound(&It.Min, &It.Max))
+            return FALSE;
+          It.C = (It.Min + It.Max) / 2;
+        }
+      }
+
+      return RefitNodes();
+    } /* End of 'Refit' function */
+
+    /* Refit tree to moved shapes function.
+     * Bound boxes of all shapes are taken again (shapes are moved
+     * by modifiers, see 'shape::Animate'), tree topology is kept.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if tree is refitted, FALSE if it should be built again.
+     */
+    BOOL Refit( VOID )
+    {
+      for (auto &It : Items)
+      {
+        It.Shp->WorldBound(&It.Min, &It.Max);
+        It.C = (It.Min + It.Max) / 2;
+      }
+      return RefitNodes();
+    } /* End of 'Refit' function */
+
+    /* Get scene bound box function.
+     * ARGUMENTS:
+     *   - pointers at bound box minimum and maximum corners:
+     *       vec3 *Min, *Max;
+     * RETURNS:
+     *   (BOOL) TRUE if there are bounded shapes, FALSE overwise.
+     */
+    BOOL Bound( vec3 *Min, vec3 *Max ) const
+    {
+      if (Nodes.empty())
+        return FALSE;
+      *Min = Nodes[0].Min, *Max = Nodes[0].Max;
+      return TRUE;
+    } /* End of 'Bound' function */
+
+    /* Find the closest intersection with ray function.
+     * ARGUMENTS:
+     *   - reference at ray:
+     *       const ray &R;
+     *   - pointer at intersection:
+     *       intr *In;
+     * RETURNS:
+     *   (BOOL) TRUE if there is intersection, FALSE overwise.
+     */
+    BOOL Intersect( const ray &R, intr *In ) const
+    {
+      intr best_in;
+
+      for (auto shp : Unbounded)
+        Closest(shp, R, &best_in);
+      if (!Nodes.empty())
+      {
+        vec3 inv(1 / R.Dir.X, 1 / R.Dir.Y, 1 / R.Dir.Z);
+        INT Stack[64], sp = 0;
+
+        Stack[sp++] = 0;
+        while (sp > 0)
+        {
+          const node &Nd = Nodes[Stack[--sp]];
+          DBL t;
+
+          if (!IsBoxHit(Nd, R.Org, inv, &t) || (best_in.Shp != nullptr && t > best_in.T))
+            continue;
+          if (Nd.Count > 0)
+            for (INT i = Nd.Start; i < Nd.Start + Nd.Count; i++)
+              Closest(Items[i].Shp, R, &best_in);
+          else if (R.Dir[Nd.Axis] < 0)
+            Stack[sp++] = Nd.Left, Stack[sp++] = Nd.Right;
+          else
+            Stack[sp++] = Nd.Right, Stack[sp++] = Nd.Left;
+        }
+      }
+      best_in.P = R(best_in.T);
+      *In = best_in;
+      return best_in.Shp != nullptr;
+    } /* End of 'Intersect' function */
+
+    /* Find the closest intersections with batch of rays function.
+     * ARGUMENTS:
+     *   - rays array:
+     *       const ray *Rays;
+     *   - rays count:
+     *       INT Count;
+     *   - intersections array (Shp is nullptr for missed rays):
+     *       intr *Ins;
+     * RETURNS: None.
+     */
+    VOID Intersect( const ray *Rays, INT Count, intr *Ins ) const
+    {
+      /* Traversal stack entry: node with rays which hit its parent */
+      struct entry
+      {
+        INT Node, Start, Count; // Node index and range of parent active rays in pool
+      } Stack[64];
+      INT Pool[MaxBatch * 64];
+
+      for (INT first = 0; first < Count; first += MaxBatch)
+      {
+        INT n = COM_MIN(Count - first, MaxBatch), sp = 0;
+        const ray *rays = Rays + first;
+        intr *ins = Ins + first;
+        vec3 inv[MaxBatch];
+
+        for (INT k = 0; k < n; k++)
+        {
+          ins[k] = intr();
+          for (auto shp : Unbounded)
+            Closest(shp, rays[k], &ins[k]);
+          inv[k] = vec3(1 / rays[k].Dir.X, 1 / rays[k].Dir.Y, 1 / rays[k].Dir.Z);
+          Pool[k] = k;
+        }
+
+        if (!Nodes.empty())
+          Stack[sp++] = {0, 0, n};
+        while (sp > 0)
+        {
+          entry e = Stack[--sp];
+          const node &Nd = Nodes[e.Node];
+          INT start = e.Start + e.Count, na = 0;
+
+          // rays of parent which still may hit something closer inside node
+          // (pool above parent range belongs to already finished sibling subtree)
+          for (INT a = e.Start; a < e.Start + e.Count; a++)
+          {
+            INT k = Pool[a];
+            DBL t;
+
+            if (IsBoxHit(Nd, rays[k].Org, inv[k], &t) && (ins[k].Shp == nullptr || t <= ins[k].T))
+              Pool[start + na++] = k;
+          }
+          if (na == 0)
+            continue;
+          if (Nd.Count > 0)
+            for (INT i = Nd.Start; i < Nd.Start + Nd.Count; i++)
+              for (INT a = start; a < start + na; a++)
+                Closest(Items[i].Shp, rays[Pool[a]], &ins[Pool[a]]);
+          else if (rays[Pool[start]].Dir[Nd.Axis] < 0)
+          {
+            // near child is visited first, guessed by first ray of coherent batch
+            Stack[sp++] = {Nd.Left, start, na};
+            Stack[sp++] = {Nd.Right, start, na};
+          }
+          else
+          {
+            Stack[sp++] = {Nd.Right, start, na};
+            Stack[sp++] = {Nd.Left, start, na};
+          }
+        }
+        for (INT k = 0; k < n; k++)
+          ins[k].P = rays[k](ins[k].T);
+      }
+    } /* End of 'Intersect' function */
+
+    /* Determine if ray segment is blocked by any shape function.
+     * ARGUMENTS:
+     *   - reference at ray:
+     *       const ray &R;
+     *   - segment length:
+     *       DBL Dist;
+     * RETURNS:
+     *   (BOOL) TRUE if segment is blocked, FALSE overwise.
+     */
+    BOOL IsOccluded( const ray &R, DBL Dist ) const
+    {
+      for (auto shp : Unbounded)
+        if (IsBlocking(shp, R, Dist))
+          return TRUE;
+      if (Nodes.empty())
+        return FALSE;
+
+      vec3 inv(1 / R.Dir.X, 1 / R.Dir.Y, 1 / R.Dir.Z);
+      INT Stack[64], sp = 0;
+
+      Stack[sp++] = 0;
+      while (sp > 0)
+      {
+        const node &Nd = Nodes[Stack[--sp]];
+        DBL t;
+
+        if (!IsBoxHit(Nd, R.Org, inv, &t) || t > Dist)
+          continue;
+        if (Nd.Count > 0)
+        {
+          for (INT i = Nd.Start; i < Nd.Start + Nd.Count; i++)
+            if (IsBlocking(Items[i].Shp, R, Dist))
+              return TRUE;
+        }
+        else
+          Stack[sp++] = Nd.Right, Stack[sp++] = Nd.Left;
+      }
+      return FALSE;
+    } /* End of 'IsOccluded' function */
+
+    /* Determine if batch of ray segments are blocked function.
+     * ARGUMENTS:
+     *   - rays array:
+     *       const ray *Rays;
+     *   - segments lengths array (non positive length segments are never blocked):
+     *       const DBL *Dist;
+     *   - rays count:
+     *       INT Count;
+     *   - results array (1 for blocked segment, 0 overwise):
+     *       BYTE *IsBlocked;
+     * RETURNS: None.
+     */
+    VOID IsOccluded( const ray *Rays, const DBL *Dist, INT Count, BYTE *IsBlocked ) const
+    {
+      /* Traversal stack entry: node with rays which hit its parent */
+      struct entry
+      {
+        INT Node, Start, Count; // Node index and range of parent active rays in pool
+      } Stack[64];
+      INT Pool[MaxBatch * 64];
+
+      for (INT first = 0; first < Count; first += MaxBatch)
+      {
+        INT n = COM_MIN(Count - first, MaxBatch), sp = 0, na = 0;
+        const ray *rays = Rays + first;
+        const DBL *dist = Dist + first;
+        BYTE *res = IsBlocked + first;
+        vec3 inv[MaxBatch];
+
+        for (INT k = 0; k < n; k++)
+        {
+          res[k] = 0;
+          if (dist[k] <= 0)
+            continue;
+          for (auto shp : Unbounded)
+            if (IsBlocking(shp, rays[k], dist[k]))
+            {
+              res[k] = 1;
+              break;
+            }
+          inv[k] = vec3(1 / rays[k].Dir.X, 1 / rays[k].Dir.Y, 1 / rays[k].Dir.Z);
+          if (!res[k])
+            Pool[na++] = k;
+        }
+
+        if (!Nodes.empty() && na > 0)
+          Stack[sp++] = {0, 0, na};
+        while (sp > 0)
+        {
+          entry e = Stack[--sp];
+          const node &Nd = Nodes[e.Node];
+          INT start = e.Start + e.Count;
+
+          na = 0;
+          for (INT a = e.Start; a < e.Start + e.Count; a++)
+          {
+            INT k = Pool[a];
+            DBL t;
+
+            if (!res[k] && IsBoxHit(Nd, rays[k].Org, inv[k], &t) && t <= dist[k])
+              Pool[start + na++] = k;
+          }
+          if (na == 0)
+            continue;
+          if (Nd.Count > 0)
+          {
+            for (INT i = Nd.Start; i < Nd.Start + Nd.Count; i++)
+              for (INT a = start; a < start + na; a++)
+                if (!res[Pool[a]] && IsBlocking(Items[i].Shp, rays[Pool[a]], dist[Pool[a]]))
+                  res[Pool[a]] = 1;
+          }
+          else
+          {
+            Stack[sp++] = {Nd.Right, start, na};
+            Stack[sp++] = {Nd.Left, start, na};
+          }
+        }
+      }
+    } /* End of 'IsOccluded' function */
+  }; /* End of 'bvh' class */
+} /* end of 'dart' namespace */
+
+#endif // __bvh_h_
+
+/* END OF 'bvh.h' FILE */
@@ -0,0 +1,243 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : checkpoint.h
+ * PURPOSE     : Raytracing project.
+ *               Rendering checkpoints module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __checkpoint_h_
+#define __checkpoint_h_
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "rt/scene.h"
+
+namespace dart
+{
+  /* Rendering checkpoints writer class.
+   * Renderer copies accumulation state between frames and posts it,
+   * file is written by checkpoint thread. If thread is still writing
+   * previous state, posted state replaces not written one, so renderer
+   * never waits for disk.
+   */
+  class checkpoint
+  {
+    static const INT Version = 2; // File format version
+
+    std::string FileName;             // Checkpoint file name
+    std::thread Th;                   // Writing thread
+    std::mutex Mutex;                 // States exchange lock
+    std::condition_variable Changed;  // Posted state notification
+    scene::accum_state Posted, Spare; // Posted and free states (buffers are reused)
+    BOOL IsPosted;                    // Not written state is posted flag
+    BOOL IsWriting;                   // State is being written flag
+    BOOL IsDone;                      // Stop writing thread flag
+
+    /* Writing thread function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Run( VOID )
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      scene::accum_state State;
+
+      for (;;)
+      {
+        Changed.wait(Lock,
+          [this]( VOID )
+          {
+            return IsDone || IsPosted;
+          });
+        if (!IsPosted)
+          return;
+        std::swap(State, Posted);
+        IsPosted = FALSE;
+        IsWriting = TRUE;
+
+        Lock.unlock();
+        if (Save(FileName.c_str(), State))
+          Written++;
+        else
+          Failed++;
+        Lock.lock();
+
+        // written buffers are returned for next copy
+        std::swap(State, Spare);
+        IsWriting = FALSE;
+        Changed.notify_all();
+      }
+    } /* End of 'Run' function */
+
+  public:
+    std::atomic<INT> Written; // Written checkpoints count
+    std::atomic<INT> Failed;  // Not written checkpoints count
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - checkpoint file name:
+     *       const CHAR *CheckpointName;
+     */
+    checkpoint( const CHAR *CheckpointName ) :
+      FileName(CheckpointName), IsPosted(FALSE), IsWriting(FALSE), IsDone(FALSE), Written(0), Failed(0)
+    {
+      Th = std::thread(&checkpoint::Run, this);
+    } /* End of 'checkpoint' function */
+
+    /* Class destructor (writes last posted state) */
+    ~checkpoint( VOID )
+    {
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        IsDone = TRUE;
+      }
+      Changed.notify_all();
+      Th.join();
+    } /* End of '~checkpoint' function */
+
+    /* Post scene accumulation state to write function.
+     * ARGUMENTS:
+     *   - reference at scene (between frames):
+     *       const scene &Scene;
+     *   - reference at rendered frame:
+     *       const frame &Frm;
+     * RETURNS: None.
+     */
+    VOID Post( const scene &Scene, const frame &Frm )
+    {
+      scene::accum_state State;
+
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        std::swap(State, Spare);
+      }
+      Scene.GetAccum(State, Frm);
+
+      std::lock_guard<std::mutex> Lock(Mutex);
+      std::swap(State, Posted);
+      IsPosted = TRUE;
+      Changed.notify_all();
+
+      // replaced state buffers are kept for next copy
+      if (Spare.Accum.empty())
+        std::swap(State, Spare);
+    } /* End of 'Post' function */
+
+    /* Wait for all posted states function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Flush( VOID )
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+
+      Changed.wait(Lock,
+        [this]( VOID )
+        {
+          return !IsPosted && !IsWriting;
+        });
+    } /* End of 'Flush' function */
+
+    /* Write accumulation state to file function.
+     * State is written under temporary name and renamed when completed,
+     * so previous checkpoint is kept if writing is interrupted.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at state:
+     *       const scene::accum_state &State;
+     * RETURNS:
+     *   (BOOL) TRUE if file is written, FALSE overwise.
+     */
+    static BOOL Save( const CHAR *FileName, const scene::accum_state &State )
+    {
+      std::string TmpName = std::string(FileName) + ".tmp";
+      std::fstream F(TmpName, std::fstream::out | std::fstream::binary);
+
+      if (!F)
+        return FALSE;
+
+      INT Head[8] =
+      {
+        Version, (INT)sizeof(vec3), State.W, State.H, State.IsTiled, State.Count, (INT)State.TilesDone.size(),
+        (INT)State.Accum.size()
+      };
+
+      F.write("DB6CKPT", 8);
+      F.write((const CHAR *)Head, sizeof(Head));
+      F.write((const CHAR *)&State.Loc, sizeof(vec3));
+      F.write((const CHAR *)&State.Dir, sizeof(vec3));
+      F.write((const CHAR *)State.TilesDone.data(), State.TilesDone.size());
+      F.write((const CHAR *)State.Accum.data(), State.Accum.size() * sizeof(vec3));
+      F.close();
+      if (F.fail())
+      {
+        remove(TmpName.c_str());
+        return FALSE;
+      }
+      remove(FileName);
+      return rename(TmpName.c_str(), FileName) == 0;
+    } /* End of 'Save' function */
+
+    /* Read accumulation state from file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at state to fill:
+     *       scene::accum_state &State;
+     * RETURNS:
+     *   (BOOL) TRUE if whole valid checkpoint is read, FALSE overwise.
+     */
+    static BOOL Load( const CHAR *FileName, scene::accum_state &State )
+    {
+      std::fstream F(FileName, std::fstream::in | std::fstream::binary);
+      CHAR Magic[8];
+      INT Head[8];
+
+      if (!F)
+        return FALSE;
+      F.read(Magic, 8);
+      F.read((CHAR *)Head, sizeof(Head));
+      if (!F || memcmp(Magic, "DB6CKPT", 8) != 0 || Head[0] != Version || Head[1] != (INT)sizeof(vec3) ||
+          Head[2] <= 0 || Head[3] <= 0 || Head[6] < 0)
+        return FALSE;
+
+      // tiled accumulation buffer is padded to whole tiles
+      INT
+        TilesW = (Head[2] + frame::TileSize - 1) / frame::TileSize,
+        TilesH = (Head[3] + frame::TileSize - 1) / frame::TileSize;
+      if (Head[7] != (Head[4] ? TilesW * TilesH * frame::TileSize * frame::TileSize : Head[2] * Head[3]))
+        return FALSE;
+
+      State.W = Head[2], State.H = Head[3];
+      State.IsTiled = Head[4];
+      State.Count = Head[5];
+      State.TilesDone.resize(Head[6]);
+      State.Accum.resize(Head[7]);
+      F.read((CHAR *)&State.Loc, sizeof(vec3));
+      F.read((CHAR *)&State.Dir, sizeof(vec3));
+      F.read((CHAR *)State.TilesDone.data(), State.TilesDone.size());
+      F.read((CHAR *)State.Accum.data(), State.Accum.size() * sizeof(vec3));
+      return !F.fail() && F.peek() == EOF;
+    } /* End of 'Load' function */
+  }; /* End of 'checkpoint' class */
+} /* end of 'dart' namespace */
+
+#endif // __checkpoint_h_
+
+/* END OF 'checkpoint.h' FILE */
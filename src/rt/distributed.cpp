@@ -0,0 +1,562 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : distributed.cpp
+ * PURPOSE     : Raytracing project.
+ *               Multi-process tiles rendering implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+// sockets headers should be included before 'windows.h'
+#ifdef _WIN32
+#  include <winsock2.h>
+#  pragma comment(lib, "ws2_32")
+#else
+#  include <arpa/inet.h>
+#  include <cerrno>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <sys/select.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "rt/distributed.h"
+#include "rt/image_saver.h"
+
+namespace dart
+{
+  /* Local sockets support namespace */
+  namespace net
+  {
+#ifdef _WIN32
+    typedef SOCKET handle;                 // Socket handle
+    static const handle Invalid = INVALID_SOCKET;
+    static const INT NoSignal = 0;         // Send flags
+#else
+    typedef INT handle;                    // Socket handle
+    static const handle Invalid = -1;
+    static const INT NoSignal = MSG_NOSIGNAL; // Send flags (no SIGPIPE on closed socket)
+#endif
+
+    static const INT Magic = 0x57364244;   // Worker greeting ("DB6W")
+    static const INT Version = 1;          // Protocol version
+
+    /* Tile task message structure (coordinator to worker, 'Id' < 0 to stop) */
+    struct task_msg
+    {
+      INT Id, Frame;         // Task and frame numbers
+      DBL Time, DeltaTime;   // Frame animation time
+      INT W, H;              // Frame size
+      INT X0, Y0, TW, TH;    // Tile rectangle
+      INT Samples;           // Samples per pixel
+    };
+
+    /* Tile result message header structure (worker to coordinator, colors follow) */
+    struct result_msg
+    {
+      INT Id;    // Task number
+      INT Count; // Colors components count
+    };
+
+    /* Start sockets usage function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if sockets are available, FALSE overwise.
+     */
+    static BOOL Init( VOID )
+    {
+#ifdef _WIN32
+      static const BOOL IsInit =
+        []( VOID ) -> BOOL
+        {
+          WSADATA wsa;
+
+          return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+        }();
+
+      return IsInit;
+#else
+      return TRUE;
+#endif
+    } /* End of 'Init' function */
+
+    /* Close socket function.
+     * ARGUMENTS:
+     *   - socket handle:
+     *       handle S;
+     * RETURNS: None.
+     */
+    static VOID Close( handle S )
+    {
+#ifdef _WIN32
+      closesocket(S);
+#else
+      close(S);
+#endif
+    } /* End of 'Close' function */
+
+    /* Check if last socket call is interrupted by signal function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if call should be repeated, FALSE overwise.
+     */
+    static BOOL IsInterrupted( VOID )
+    {
+#ifdef _WIN32
+      return WSAGetLastError() == WSAEINTR;
+#else
+      return errno == EINTR;
+#endif
+    } /* End of 'IsInterrupted' function */
+
+    /* Get last socket error code function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) system error code.
+     */
+    static INT LastError( VOID )
+    {
+#ifdef _WIN32
+      return WSAGetLastError();
+#else
+      return errno;
+#endif
+    } /* End of 'LastError' function */
+
+    /* Make local host address function.
+     * ARGUMENTS:
+     *   - port:
+     *       INT Port;
+     * RETURNS:
+     *   (sockaddr_in) address.
+     */
+    static sockaddr_in Local( INT Port )
+    {
+      sockaddr_in A = {};
+
+      A.sin_family = AF_INET;
+      A.sin_port = htons((u_short)Port);
+      A.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      return A;
+    } /* End of 'Local' function */
+
+    /* Send whole data function.
+     * ARGUMENTS:
+     *   - socket handle:
+     *       handle S;
+     *   - data to send:
+     *       const VOID *Data, size_t Size;
+     * RETURNS:
+     *   (BOOL) TRUE if all data is sent, FALSE overwise.
+     */
+    static BOOL SendAll( handle S, const VOID *Data, size_t Size )
+    {
+      const CHAR *p = (const CHAR *)Data;
+
+      while (Size > 0)
+      {
+        INT n = send(S, p, (INT)COM_MIN(Size, (size_t)1 << 20), NoSignal);
+
+        if (n <= 0)
+          return FALSE;
+        p += n, Size -= n;
+      }
+      return TRUE;
+    } /* End of 'SendAll' function */
+
+    /* Receive whole data function.
+     * ARGUMENTS:
+     *   - socket handle:
+     *       handle S;
+     *   - buffer to fill:
+     *       VOID *Data, size_t Size;
+     * RETURNS:
+     *   (BOOL) TRUE if all data is received, FALSE overwise.
+     */
+    static BOOL RecvAll( handle S, VOID *Data, size_t Size )
+    {
+      CHAR *p = (CHAR *)Data;
+
+      while (Size > 0)
+      {
+        INT n = recv(S, p, (INT)COM_MIN(Size, (size_t)1 << 20), 0);
+
+        if (n <= 0)
+          return FALSE;
+        p += n, Size -= n;
+      }
+      return TRUE;
+    } /* End of 'RecvAll' function */
+
+    /* Get time in seconds function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (DBL) time from some moment.
+     */
+    static DBL Now( VOID )
+    {
+      return std::chrono::duration<DBL>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    } /* End of 'Now' function */
+  } /* end of 'net' namespace */
+
+  /* Render frames sequence by workers function.
+   * ARGUMENTS:
+   *   - frames numbers range (inclusive):
+   *       INT First, Last;
+   *   - animation time per frame:
+   *       DBL Step;
+   *   - files names format (printf format with frame number):
+   *       const CHAR *Pattern;
+   * RETURNS:
+   *   (INT) written frames count, -1 on sockets error ('Error' is set).
+   */
+  INT coordinator::Render( INT First, INT Last, DBL Step, const CHAR *Pattern )
+  {
+    CHAR Msg[100];
+
+    Error.clear();
+    if (!net::Init())
+    {
+      Error = "sockets are not available";
+      return -1;
+    }
+
+    net::handle L = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in A = net::Local(Port);
+    INT yes = 1;
+
+    if (L == net::Invalid)
+    {
+      Error = (snprintf(Msg, sizeof(Msg), "socket is not created (error %d)", net::LastError()), Msg);
+      return -1;
+    }
+    setsockopt(L, SOL_SOCKET, SO_REUSEADDR, (const CHAR *)&yes, sizeof(yes));
+    if (bind(L, (const sockaddr *)&A, sizeof(A)) != 0 || listen(L, 64) != 0)
+    {
+      Error = (snprintf(Msg, sizeof(Msg), "port %d is not opened (error %d)", Port, net::LastError()), Msg);
+      net::Close(L);
+      return -1;
+    }
+
+    /* Tile task structure */
+    struct task
+    {
+      INT Frame, X0, Y0, TW, TH; // Frame and tile rectangle
+      INT Runs;                  // Workers rendering tile now
+      BOOL IsDone;               // Result is taken flag
+      DBL Start;                 // First run start time
+    };
+
+    /* Frame in progress structure */
+    struct out_frame
+    {
+      frame Frm;          // Frame colors
+      stock<DWORD> Image; // Frame pixels
+
+      out_frame( INT W, INT H ) : Frm(W, H)
+      {
+        Image.resize(W * H);
+        Frm.Image = Image.data();
+      }
+    };
+
+    /* Connected worker structure */
+    struct peer
+    {
+      net::handle S;  // Socket
+      std::string In; // Received not parsed bytes
+      INT Task;       // Rendered task (-1 if idle)
+      DBL Start;      // Task start time
+      BOOL IsReady;   // Greeting is received flag
+    };
+
+    stock<task> Tasks;
+    std::deque<INT> Pending;
+    std::map<INT, std::unique_ptr<out_frame>> Frames; // Frames with some tiles done
+    std::map<INT, INT> Left;                          // Tiles to complete per frame
+    stock<peer> Peers;
+    image_saver Saver;
+    CHAR Name[300];
+
+    for (INT f = First; f <= Last; f++)
+    {
+      FILE *F = fopen((snprintf(Name, sizeof(Name), Pattern, f), Name), "rb");
+
+      if (F != nullptr)
+      {
+        fclose(F);
+        continue;
+      }
+      INT count = 0;
+      for (INT y = 0; y < H; y += TileSize)
+        for (INT x = 0; x < W; x += TileSize, count++)
+        {
+          Pending.push_back((INT)Tasks.size());
+          Tasks.push_back({f, x, y, COM_MIN(TileSize, W - x), COM_MIN(TileSize, H - y), 0, FALSE, 0});
+        }
+      Left[f] = count;
+    }
+
+    INT Done = 0, Total = (INT)Tasks.size(), Timed = 0;
+    DBL AvgTime = 0;
+    stock<FLT> Colors;
+
+    while (Done < Total)
+    {
+      fd_set R;
+      timeval tv = {0, 20000};
+      net::handle MaxS = L;
+
+      FD_ZERO(&R);
+      FD_SET(L, &R);
+      for (auto &Pr : Peers)
+      {
+        FD_SET(Pr.S, &R);
+        MaxS = COM_MAX(MaxS, Pr.S);
+      }
+      if (select((INT)MaxS + 1, &R, nullptr, nullptr, &tv) < 0)
+      {
+        if (net::IsInterrupted())
+          continue;
+        Error = (snprintf(Msg, sizeof(Msg), "sockets waiting is failed (error %d)", net::LastError()), Msg);
+        break;
+      }
+
+      if (FD_ISSET(L, &R))
+      {
+        net::handle S = accept(L, nullptr, nullptr);
+
+        if (S != net::Invalid)
+        {
+          setsockopt(S, IPPROTO_TCP, TCP_NODELAY, (const CHAR *)&yes, sizeof(yes));
+          Peers.push_back({S, "", -1, 0, FALSE});
+        }
+      }
+
+      // take results, drop disconnected workers
+      for (size_t p = 0; p < Peers.size(); )
+      {
+        peer &Pr = Peers[p];
+        BOOL IsAlive = TRUE;
+
+        if (FD_ISSET(Pr.S, &R))
+        {
+          CHAR Buf[1 << 16];
+          INT n = recv(Pr.S, Buf, sizeof(Buf), 0);
+
+          if (n <= 0)
+            IsAlive = FALSE;
+          else
+            Pr.In.append(Buf, n);
+        }
+        while (IsAlive)
+        {
+          if (!Pr.IsReady)
+          {
+            INT Hello[2];
+
+            if (Pr.In.size() < sizeof(Hello))
+              break;
+            memcpy(Hello, Pr.In.data(), sizeof(Hello));
+            Pr.In.erase(0, sizeof(Hello));
+            IsAlive = Pr.IsReady = Hello[0] == net::Magic && Hello[1] == net::Version;
+            continue;
+          }
+
+          net::result_msg M;
+          if (Pr.In.size() < sizeof(M))
+            break;
+          memcpy(&M, Pr.In.data(), sizeof(M));
+
+          size_t size = sizeof(M) + (size_t)M.Count * sizeof(FLT);
+          if (M.Id != Pr.Task || M.Id < 0 || M.Id >= Total ||
+              M.Count != Tasks[M.Id].TW * Tasks[M.Id].TH * 3)
+          {
+            IsAlive = FALSE;
+            break;
+          }
+          if (Pr.In.size() < size)
+            break;
+
+          task &T = Tasks[M.Id];
+          DBL t = net::Now() - Pr.Start;
+
+          AvgTime = (AvgTime * Timed + t) / (Timed + 1), Timed++;
+          T.Runs--;
+          Pr.Task = -1;
+
+          // the first result of tile is taken, late copies are dropped
+          if (!T.IsDone)
+          {
+            std::unique_ptr<out_frame> &Out = Frames[T.Frame];
+
+            if (Out == nullptr)
+              Out.reset(new out_frame(W, H));
+            T.IsDone = TRUE;
+            Done++;
+            Colors.resize(M.Count);
+            memcpy(Colors.data(), Pr.In.data() + sizeof(M), M.Count * sizeof(FLT));
+            for (INT y = 0; y < T.TH; y++)
+              for (INT x = 0; x < T.TW; x++)
+              {
+                const FLT *c = &Colors[(y * T.TW + x) * 3];
+
+                Out->Frm.Put(Out->Frm.Index(T.X0 + x, T.Y0 + y), vec3(c[0], c[1], c[2]));
+              }
+            if (--Left[T.Frame] == 0)
+            {
+              Out->Frm.Resolve();
+              snprintf(Name, sizeof(Name), Pattern, T.Frame);
+              Saver.Save(Name, Out->Image.data(), W, H);
+              Frames.erase(T.Frame);
+            }
+          }
+          Pr.In.erase(0, size);
+        }
+
+        if (IsAlive)
+        {
+          p++;
+          continue;
+        }
+        if (Pr.Task >= 0)
+        {
+          task &T = Tasks[Pr.Task];
+
+          if (--T.Runs == 0 && !T.IsDone)
+          {
+            Pending.push_front(Pr.Task);
+            Lost++;
+          }
+        }
+        net::Close(Pr.S);
+        Peers.erase(Peers.begin() + p);
+      }
+
+      // give tiles to idle workers: waiting ones first, then copies of slow ones
+      DBL now = net::Now();
+      for (auto &Pr : Peers)
+      {
+        if (!Pr.IsReady || Pr.Task >= 0)
+          continue;
+
+        INT id = -1;
+        while (!Pending.empty() && id < 0)
+        {
+          id = Pending.front();
+          Pending.pop_front();
+          if (Tasks[id].IsDone || Tasks[id].Runs > 0)
+            id = -1;
+        }
+        if (id < 0 && Timed > 0)
+        {
+          DBL slow = COM_MAX(MinSlowTime, SlowFactor * AvgTime), worst = slow;
+
+          for (INT i = 0; i < Total; i++)
+            if (!Tasks[i].IsDone && Tasks[i].Runs == 1 && now - Tasks[i].Start > worst)
+              worst = now - Tasks[i].Start, id = i;
+          if (id >= 0)
+            Reissued++;
+        }
+        if (id < 0)
+          continue;
+
+        task &T = Tasks[id];
+        net::task_msg M = {id, T.Frame, T.Frame * Step, Step, W, H, T.X0, T.Y0, T.TW, T.TH, Samples};
+
+        if (T.Runs++ == 0)
+          T.Start = now;
+        Pr.Task = id;
+        Pr.Start = now;
+        // failed worker is dropped when its socket is read
+        net::SendAll(Pr.S, &M, sizeof(M));
+      }
+    }
+
+    net::task_msg Stop = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    for (auto &Pr : Peers)
+    {
+      net::SendAll(Pr.S, &Stop, sizeof(Stop));
+      net::Close(Pr.S);
+    }
+    net::Close(L);
+    Saver.Flush();
+    return Error.empty() ? (INT)Saver.Written : -1;
+  } /* End of 'coordinator::Render' function */
+
+  /* Render tiles given by coordinator function.
+   * ARGUMENTS:
+   *   - reference at scene:
+   *       scene &Scene;
+   *   - coordinator local port:
+   *       INT Port;
+   *   - time to wait for coordinator in seconds:
+   *       DBL ConnectTime;
+   * RETURNS:
+   *   (INT) rendered tiles count, -1 if coordinator is not found.
+   */
+  INT worker::Run( scene &Scene, INT Port, DBL ConnectTime )
+  {
+    if (!net::Init())
+      return -1;
+
+    sockaddr_in A = net::Local(Port);
+    net::handle S = net::Invalid;
+    DBL start = net::Now();
+
+    // coordinator may start later
+    for (;;)
+    {
+      S = socket(AF_INET, SOCK_STREAM, 0);
+      if (S == net::Invalid)
+        return -1;
+      if (connect(S, (const sockaddr *)&A, sizeof(A)) == 0)
+        break;
+      net::Close(S);
+      if (net::Now() - start > ConnectTime)
+        return -1;
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    INT Hello[2] = {net::Magic, net::Version}, yes = 1, count = 0;
+    net::task_msg T;
+    stock<FLT> Colors;
+    camera Cam;
+
+    setsockopt(S, IPPROTO_TCP, TCP_NODELAY, (const CHAR *)&yes, sizeof(yes));
+    if (net::SendAll(S, Hello, sizeof(Hello)))
+      while (net::RecvAll(S, &T, sizeof(T)) && T.Id >= 0)
+      {
+        // camera and modifiers take time from timer in 'scene::Prepare'
+        Scene.Timer.Set(T.Time, T.DeltaTime);
+        Cam.Resize(T.W, T.H);
+        Colors.resize(T.TW * T.TH * 3);
+        Scene.RenderRect(Cam, T.X0, T.Y0, T.TW, T.TH, T.Samples, Colors.data());
+
+        net::result_msg M = {T.Id, (INT)Colors.size()};
+        if (!net::SendAll(S, &M, sizeof(M)) || !net::SendAll(S, Colors.data(), Colors.size() * sizeof(FLT)))
+          break;
+        count++;
+      }
+    net::Close(S);
+    return count;
+  } /* End of 'worker::Run' function */
+} /* end of 'dart' namespace */
+
+/* END OF 'distributed.cpp' FILE */
@@ -0,0 +1,104 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : distributed.h
+ * PURPOSE     : Raytracing project.
+ *               Multi-process tiles rendering module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __distributed_h_
+#define __distributed_h_
+
+#include <string>
+
+#include "rt/scene.h"
+
+namespace dart
+{
+  /* Distributed rendering coordinator class.
+   * Frames of animation are split to tiles rendered by worker processes
+   * connected to local TCP port (workers may come and go at any time).
+   * Every worker has one tile at once; tile of disconnected worker is
+   * given to other one, tile of slow worker is given to idle worker too
+   * and the first result is taken. Completed frames are saved by saver
+   * thread to numbered files, frames with files are skipped.
+   */
+  class coordinator
+  {
+  public:
+    INT W, H;        // Frames size
+    INT Samples;     // Samples per pixel (stochastic scenes)
+    INT Port;        // Listening local port
+    INT TileSize;    // Task tile size
+    DBL SlowFactor;  // Tile is given to other worker after this times average tile time
+    DBL MinSlowTime; // Minimal tile time in seconds to treat worker as slow
+
+    INT Reissued; // Tiles given to other worker because of slow one
+    INT Lost;     // Tiles given to other worker because of disconnected one
+
+    std::string Error; // Last error message, empty if there was no error
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - frames size:
+     *       INT Width, Height;
+     *   - samples per pixel:
+     *       INT SamplesCount;
+     *   - listening local port:
+     *       INT ListenPort;
+     *   - task tile size:
+     *       INT TaskTileSize;
+     */
+    coordinator( INT Width, INT Height, INT SamplesCount = 1, INT ListenPort = 5517,
+                 INT TaskTileSize = frame::TileSize * 4 ) :
+      W(Width), H(Height), Samples(SamplesCount), Port(ListenPort), TileSize(TaskTileSize),
+      SlowFactor(4), MinSlowTime(.5), Reissued(0), Lost(0)
+    {
+    } /* End of 'coordinator' function */
+
+    /* Render frames sequence by workers function.
+     * ARGUMENTS:
+     *   - frames numbers range (inclusive):
+     *       INT First, Last;
+     *   - animation time per frame:
+     *       DBL Step;
+     *   - files names format (printf format with frame number):
+     *       const CHAR *Pattern;
+     * RETURNS:
+     *   (INT) written frames count, -1 on sockets error ('Error' is set,
+     *   frames completed before error are written).
+     */
+    INT Render( INT First, INT Last, DBL Step, const CHAR *Pattern );
+  }; /* End of 'coordinator' class */
+
+  /* Distributed rendering worker class */
+  class worker
+  {
+  public:
+    /* Render tiles given by coordinator function.
+     * Scene should be built the same way as in other workers.
+     * ARGUMENTS:
+     *   - reference at scene:
+     *       scene &Scene;
+     *   - coordinator local port:
+     *       INT Port;
+     *   - time to wait for coordinator in seconds:
+     *       DBL ConnectTime;
+     * RETURNS:
+     *   (INT) rendered tiles count, -1 if coordinator is not found.
+     */
+    static INT Run( scene &Scene, INT Port, DBL ConnectTime = 10 );
+  }; /* End of 'worker' class */
+} /* end of 'dart' namespace */
+
+#endif // __distributed_h_
+
+/* END OF 'distributed.h' FILE */
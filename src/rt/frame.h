@@ -8,7 +8,7 @@
  *               Window base class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 25.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -17,30 +17,151 @@
 #ifndef __frame_h_
 #define __frame_h_
 
+#include <chrono>
+#include <cmath>
+#include <ctime>
 #include <fstream>
+#include <emmintrin.h>
 
-#pragma pack(push, 1)
-#include <tgahead.h>
-#pragma pack(pop)
+#ifdef _WIN32
+#  pragma pack(push, 1)
+#  include <tgahead.h>
+#  pragma pack(pop)
+#endif
+
+#include "rt/parallel.h"
 
 namespace dart
 {
-  /* Frame represetation type */
+  /* Tone mapping operators */
+  enum tonemap
+  {
+    TONEMAP_CLAMP,    // Clamp to [0; 1] only
+    TONEMAP_REINHARD, // C / (1 + C)
+    TONEMAP_ACES      // Filmic curve (Narkowicz fit of ACES)
+  };
+
+  /* Frame represetation type.
+   * Linear colors are stored row by row or (if 'IsTiled' is set) by
+   * 8x8 tiles with pixels of tile in Morton order, so every tile owns
+   * 1 KB of memory and parallel tile workers never share cache lines.
+   * Stored colors are converted to linear 8-bit image by 'Resolve' only.
+   */
   class frame
   {
+    static const INT LutSize = 4096; // Gamma table size
+
+    BYTE GammaLut[LutSize]; // Gamma correction and quantization table
+    FLT LutGamma;           // Gamma of built table
+
+    /* Convert linear color to image pixel function.
+     * ARGUMENTS:
+     *   - pointer at linear RGBA color:
+     *       const FLT *P;
+     * RETURNS:
+     *   (DWORD) packed pixel color.
+     */
+    template <tonemap Op>
+      DWORD ResolvePixel( const FLT *P ) const
+      {
+        const __m128
+          zero = _mm_setzero_ps(),
+          one = _mm_set1_ps(1);
+        __m128 c = _mm_mul_ps(_mm_loadu_ps(P), _mm_set1_ps(Exposure));
+
+        if (Op == TONEMAP_REINHARD)
+          c = _mm_div_ps(c, _mm_add_ps(one, c));
+        else if (Op == TONEMAP_ACES)
+        {
+          __m128
+            a = _mm_mul_ps(c, _mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(2.51f)), _mm_set1_ps(.03f))),
+            b = _mm_add_ps(_mm_mul_ps(c, _mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(2.43f)), _mm_set1_ps(.59f))), _mm_set1_ps(.14f));
+
+          c = _mm_div_ps(a, b);
+        }
+        c = _mm_min_ps(_mm_max_ps(c, zero), one);
+
+        // alpha is not exposed, tone mapped and gamma corrected
+        __m128i
+          idx = _mm_cvtps_epi32(_mm_mul_ps(c, _mm_set1_ps(LutSize - 1))),
+          a = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_load_ss(P + 3), zero), one), _mm_set_ss(255)));
+
+        idx = _mm_packs_epi32(idx, idx);
+        return _mm_cvtsi128_si32(a) << 24 | GammaLut[_mm_extract_epi16(idx, 0)] << 16 |
+          GammaLut[_mm_extract_epi16(idx, 1)] << 8 | GammaLut[_mm_extract_epi16(idx, 2)];
+      } /* End of 'ResolvePixel' function */
+
+    /* Resolve frame rows function.
+     * ARGUMENTS:
+     *   - pixel rows range (tile rows range for tiled frame):
+     *       INT Start, End;
+     * RETURNS: None.
+     */
+    template <tonemap Op>
+      VOID ResolveRows( INT Start, INT End )
+      {
+        if (!IsTiled)
+        {
+          for (INT i = Start * W; i < End * W; i++)
+            Image[i] = ResolvePixel<Op>(&Hdr[i * 4]);
+          return;
+        }
+
+        // read tiles sequentially, write image by 8 pixels row pieces
+        for (INT ty = Start; ty < End; ty++)
+          for (INT tx = 0; tx < TilesW; tx++)
+          {
+            const FLT *p = &Hdr[(ty * TilesW + tx) * TileSize * TileSize * 4];
+
+            for (INT k = 0; k < TileSize * TileSize; k++, p += 4)
+            {
+              INT
+                X = tx * TileSize + Demorton(k),
+                Y = ty * TileSize + Demorton(k >> 1);
+
+              if (X < W && Y < H)
+                Image[Y * W + X] = ResolvePixel<Op>(p);
+            }
+          }
+      } /* End of 'ResolveRows' function */
+
+    /* Get coordinate from Morton code bits function.
+     * ARGUMENTS:
+     *   - Morton code (coordinate is in even bits):
+     *       INT M;
+     * RETURNS:
+     *   (INT) coordinate in tile.
+     */
+    static INT Demorton( INT M )
+    {
+      return (M & 1) | (M >> 1 & 2) | (M >> 2 & 4);
+    } /* End of 'Demorton' function */
+
   public:
+    static const INT TileSize = 8; // Tile side in pixels
+
     INT W, H;     // frame size
+    INT OrgY;     // Frame first row in whole image (if frame is rows band of bigger image)
     DWORD *Image; // pixels array
     HDC hMemDC;   // Second device context
     HBITMAP hBm;  // Bitmap handle
 
+    BOOL IsTiled;       // Tiled colors layout flag
+    INT TilesW, TilesH; // Tiles count
+    stock<FLT> Hdr;     // Linear RGBA colors (4 components per pixel)
+    FLT Exposure;       // Colors multiplier before tone mapping
+    tonemap ToneMap;    // Tone mapping operator
+    FLT Gamma;          // Display gamma
+
     /* Class constructor.
      * ARGUMENTS:
      *  - frame size:
      *       INT Width, Height;
      */
-    frame( INT Width = 0, INT Height = 0 ) : W(Width), H(Height), Image(nullptr), hMemDC(nullptr), hBm(nullptr)
+    frame( INT Width = 0, INT Height = 0 ) : LutGamma(0), W(Width), H(Height), OrgY(0), Image(nullptr), hMemDC(nullptr), hBm(nullptr),
+      IsTiled(FALSE), TilesW(0), TilesH(0), Hdr(), Exposure(1), ToneMap(TONEMAP_CLAMP), Gamma(1)
     {
+      Resize(W, H);
     } /* End of 'frame' function */
 
     /* Class destructor. */
@@ -57,8 +178,102 @@ namespace dart
     VOID Resize( INT NewW, INT NewH )
     {
       W = NewW, H = NewH;
+      TilesW = (W + TileSize - 1) / TileSize;
+      TilesH = (H + TileSize - 1) / TileSize;
+      Hdr.resize(Size() * 4);
     } /* End of 'frame' function */
 
+    /* Change colors layout function.
+     * ARGUMENTS:
+     *   - tiled layout flag:
+     *       BOOL NewIsTiled;
+     * RETURNS: None.
+     */
+    VOID SetTiled( BOOL NewIsTiled )
+    {
+      IsTiled = NewIsTiled;
+      Resize(W, H);
+    } /* End of 'SetTiled' function */
+
+    /* Get stored pixels count function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) pixels count (with tiles padding).
+     */
+    INT Size( VOID ) const
+    {
+      return IsTiled ? TilesW * TilesH * TileSize * TileSize : W * H;
+    } /* End of 'Size' function */
+
+    /* Get pixel index in stored colors function.
+     * ARGUMENTS:
+     *   - pixel coordinates (not checked):
+     *       INT X, Y;
+     * RETURNS:
+     *   (INT) pixel index.
+     */
+    INT Index( INT X, INT Y ) const
+    {
+      if (!IsTiled)
+        return Y * W + X;
+
+      INT x = X & (TileSize - 1), y = Y & (TileSize - 1);
+
+      return ((Y / TileSize) * TilesW + X / TileSize) * TileSize * TileSize +
+        ((x & 1) | (y & 1) << 1 | (x & 2) << 1 | (y & 2) << 2 | (x & 4) << 2 | (y & 4) << 3);
+    } /* End of 'Index' function */
+
+    /* Put linear color to frame function.
+     * ARGUMENTS:
+     *   - pixel index (see 'Index', not checked):
+     *       INT I;
+     *   - pixel color:
+     *       const vec3 &Color;
+     * RETURNS: None.
+     */
+    VOID Put( INT I, const vec3 &Color )
+    {
+      FLT *p = &Hdr[I * 4];
+
+      p[0] = (FLT)Color.X, p[1] = (FLT)Color.Y, p[2] = (FLT)Color.Z, p[3] = 1;
+    } /* End of 'Put' function */
+
+    /* Convert linear colors to image pixels function.
+     * Applies exposure, tone mapping and gamma (by table) to all
+     * pixels and packs them to linear 8-bit image (for presentation
+     * or saving), rows are processed in parallel.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Resolve( VOID )
+    {
+      if (Image == nullptr || (INT)Hdr.size() < Size() * 4)
+        return;
+      if (LutGamma != Gamma)
+      {
+        for (INT i = 0; i < LutSize; i++)
+          GammaLut[i] = (BYTE)(pow((DBL)i / (LutSize - 1), 1 / Gamma) * 255 + .5);
+        LutGamma = Gamma;
+      }
+
+      ParallelFor(IsTiled ? TilesH : H, IsTiled ? 2 : 16,
+        [this]( INT Start, INT End )
+        {
+          switch (ToneMap)
+          {
+          case TONEMAP_REINHARD:
+            ResolveRows<TONEMAP_REINHARD>(Start, End);
+            break;
+          case TONEMAP_ACES:
+            ResolveRows<TONEMAP_ACES>(Start, End);
+            break;
+          default:
+            ResolveRows<TONEMAP_CLAMP>(Start, End);
+            break;
+          }
+        });
+    } /* End of 'Resolve' function */
+
     /* Put pixel on frame function.
      *   ARGUMENTS:
      *   - pixel coordinates:
@@ -125,6 +340,7 @@ namespace dart
       Image[Y * W + X] = Clamp(Color.W) << 24 | Clamp(Color.X) << 16 | Clamp(Color.Y) << 8 | Clamp(Color.Z);
     } /* End of 'PutPixel' function */
 
+#ifdef _WIN32
     /* Create DIB Section for current frame function.
      * ARGUMENTS:
      *   - reference at device context handle:
@@ -153,22 +369,60 @@ namespace dart
       //StretchBlt(hDC, 0, 0, W, H, hMemDC, 0, 0, W, H, SRCCOPY);
       //SetDIBitsToDevice(hDC, 0, 0, W, H, 0, 0, 0, H, Image, (BITMAPINFO*)&bmih, DIB_RGB_COLORS);
     } /* End of 'CreateDIB' function */
+#endif /* _WIN32 */
+
+   /* Make file name by current time function.
+    * ARGUMENTS:
+    *   - name buffer (102 characters):
+    *       CHAR *FileName;
+    *   - file name extension (without dot):
+    *       const CHAR *Ext;
+    * RETURNS:
+    *   (CHAR *) file name.
+    */
+    static CHAR * TimeFileName( CHAR *FileName, const CHAR *Ext )
+    {
+#ifdef _WIN32
+      SYSTEMTIME st;
+
+      GetLocalTime(&st);
+      wsprintf(FileName, "%04d%02d%02d_%02d%02d%02d_%03d.%s", st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds, Ext);
+#else
+      auto Now = std::chrono::system_clock::now();
+      time_t t = std::chrono::system_clock::to_time_t(Now);
+      INT ms = (INT)(std::chrono::duration_cast<std::chrono::milliseconds>(Now.time_since_epoch()).count() % 1000);
+      tm st;
+
+      localtime_r(&t, &st);
+      sprintf(FileName, "%04d%02d%02d_%02d%02d%02d_%03d.%s", st.tm_year + 1900, st.tm_mon + 1, st.tm_mday, st.tm_hour, st.tm_min, st.tm_sec, ms, Ext);
+#endif
+      return FileName;
+    } /* End of 'TimeFileName' function */
 
-   /* Save frame to file function.
+   /* Save frame to file with current time name function.
     * ARGUMENTS: None.
     * RETURNS: None.
     */
     VOID Save( void )
     {
       CHAR FileName[102];
-      SYSTEMTIME st;
 
-      GetLocalTime(&st);
-      wsprintf(FileName, "%04d%02d%02d_%02d%02d%02d_%03d.tga", st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+      Save(TimeFileName(FileName, "tga"));
+    } /* End of 'Save' function */
+
+   /* Save frame to TGA file function.
+    * ARGUMENTS:
+    *   - file name:
+    *       const CHAR *FileName;
+    * RETURNS:
+    *   (BOOL) TRUE if file is written, FALSE overwise.
+    */
+    BOOL Save( const CHAR *FileName )
+    {
       std::fstream F(FileName, std::fstream::out | std::fstream::binary);
 
       if (!F)
-        return;
+        return FALSE;
 
       CHAR Copyright[] = "DB6's picture";
       tgaFILEHEADER Header =
@@ -187,6 +441,8 @@ namespace dart
       F.write(Copyright, sizeof(Copyright));
       F.write((const CHAR *) Image, (DWORD)W * (DWORD)H * 4);
       F.write(TGA_EXT_SIGNATURE, sizeof(TGA_EXT_SIGNATURE));
+      F.close();
+      return !F.fail();
     } /* End of 'Save' function */
   }; /* End of 'frame' class */
 } /* end of 'dart' namespace */
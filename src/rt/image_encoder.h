@@ -0,0 +1,693 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : image_encoder.h
+ * PURPOSE     : Raytracing project.
+ *               Compressed image formats encoding module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __image_encoder_h_
+#define __image_encoder_h_
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#  pragma pack(push, 1)
+#  include <tgahead.h>
+#  pragma pack(pop)
+#endif
+
+#include "def.h"
+
+namespace dart
+{
+  /* Deflate (RFC 1951) compressor class.
+   * Lazy LZ77 matching by hash chains in 32 KB window and dynamic
+   * Huffman codes per block, output is wrapped to zlib (RFC 1950) stream.
+   */
+  class deflater
+  {
+    static const INT
+      WinSize = 32768,       // LZ77 window size
+      HashSize = 1 << 15,    // Hash table size
+      MaxChain = 32,         // Maximum checked matches per position
+      MaxMatch = 258,        // Maximum match length
+      LazyMatch = 32,        // Shorter matches are deferred for better next one
+      BlockTokens = 1 << 15; // Tokens per block
+
+    stock<BYTE> &Out; // Output bytes
+    UINT64 Bits;      // Not written bits
+    INT BitsCount;    // Not written bits count
+
+    /* Write bits (least significant first) function.
+     * ARGUMENTS:
+     *   - bits and their count:
+     *       UINT Code, INT Count;
+     * RETURNS: None.
+     */
+    VOID Put( UINT Code, INT Count )
+    {
+      Bits |= (UINT64)Code << BitsCount;
+      BitsCount += Count;
+      while (BitsCount >= 8)
+      {
+        Out.push_back((BYTE)Bits);
+        Bits >>= 8;
+        BitsCount -= 8;
+      }
+    } /* End of 'Put' function */
+
+    /* Build length limited Huffman code lengths function.
+     * ARGUMENTS:
+     *   - symbols frequencies and symbols count:
+     *       const UINT *Freq, INT N;
+     *   - maximum code length:
+     *       INT MaxLen;
+     *   - code lengths array to fill (0 for unused symbols):
+     *       BYTE *Len;
+     * RETURNS: None.
+     */
+    static VOID BuildLengths( const UINT *Freq, INT N, INT MaxLen, BYTE *Len )
+    {
+      stock<UINT> f, w;
+      stock<INT> Syms, Parent, Depth;
+
+      f.assign(Freq, Freq + N);
+      memset(Len, 0, N);
+      for (INT i = 0; i < N; i++)
+        if (f[i] > 0)
+          Syms.push_back(i);
+
+      INT n = (INT)Syms.size();
+      if (n == 0)
+        return;
+      if (n == 1)
+      {
+        Len[Syms[0]] = 1;
+        return;
+      }
+
+      // rare deep trees are flattened by halving frequencies
+      for (;;)
+      {
+        std::stable_sort(Syms.begin(), Syms.end(),
+          [&f]( INT A, INT B )
+          {
+            return f[A] < f[B];
+          });
+
+        // two queues method: leaves are sorted, new nodes are made in weight order
+        w.resize(n * 2 - 1);
+        Parent.resize(n * 2 - 1);
+        Depth.resize(n * 2 - 1);
+        for (INT i = 0; i < n; i++)
+          w[i] = f[Syms[i]];
+
+        INT leaf = 0, node = n;
+        for (INT next = n; next < n * 2 - 1; next++)
+        {
+          INT a[2];
+
+          for (INT k = 0; k < 2; k++)
+            if (leaf < n && (node >= next || w[leaf] <= w[node]))
+              a[k] = leaf++;
+            else
+              a[k] = node++;
+          w[next] = w[a[0]] + w[a[1]];
+          Parent[a[0]] = Parent[a[1]] = next;
+        }
+
+        INT MaxDepth = 0;
+        Depth[n * 2 - 2] = 0;
+        for (INT i = n * 2 - 3; i >= 0; i--)
+        {
+          Depth[i] = Depth[Parent[i]] + 1;
+          MaxDepth = COM_MAX(MaxDepth, Depth[i]);
+        }
+        if (MaxDepth <= MaxLen)
+        {
+          for (INT i = 0; i < n; i++)
+            Len[Syms[i]] = (BYTE)Depth[i];
+          return;
+        }
+        for (INT i = 0; i < n; i++)
+          f[Syms[i]] = (f[Syms[i]] >> 1) | 1;
+      }
+    } /* End of 'BuildLengths' function */
+
+    /* Build canonical Huffman codes (bits reversed for output) function.
+     * ARGUMENTS:
+     *   - code lengths and symbols count:
+     *       const BYTE *Len, INT N;
+     *   - codes array to fill:
+     *       UINT *Code;
+     * RETURNS: None.
+     */
+    static VOID BuildCodes( const BYTE *Len, INT N, UINT *Code )
+    {
+      INT Count[16] = {0}, Next[16] = {0};
+
+      for (INT i = 0; i < N; i++)
+        Count[Len[i]]++;
+      Count[0] = 0;
+      for (INT b = 1, c = 0; b < 16; b++)
+        Next[b] = c = (c + Count[b - 1]) << 1;
+      for (INT i = 0; i < N; i++)
+        if (Len[i] > 0)
+        {
+          UINT c = Next[Len[i]]++, r = 0;
+
+          for (INT b = 0; b < Len[i]; b++)
+            r |= ((c >> b) & 1) << (Len[i] - 1 - b);
+          Code[i] = r;
+        }
+    } /* End of 'BuildCodes' function */
+
+    /* Get match length symbol function.
+     * ARGUMENTS:
+     *   - match length (3..258):
+     *       INT L;
+     *   - pointers at extra bits count and value:
+     *       INT *Extra, *Value;
+     * RETURNS:
+     *   (INT) symbol index in 257..285 range minus 257.
+     */
+    static INT LengthCode( INT L, INT *Extra, INT *Value )
+    {
+      static const INT Base[29] =
+        {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+      INT c = 28;
+
+      while (Base[c] > L)
+        c--;
+      *Extra = c == 28 || c < 8 ? 0 : (c - 4) / 4;
+      *Value = L - Base[c];
+      return c;
+    } /* End of 'LengthCode' function */
+
+    /* Get match distance symbol function.
+     * ARGUMENTS:
+     *   - match distance (1..32768):
+     *       INT D;
+     *   - pointers at extra bits count and value:
+     *       INT *Extra, *Value;
+     * RETURNS:
+     *   (INT) distance symbol (0..29).
+     */
+    static INT DistanceCode( INT D, INT *Extra, INT *Value )
+    {
+      INT c;
+
+      if (D <= 4)
+        c = D - 1;
+      else
+      {
+        INT b = 31, d = D - 1;
+
+        while (!(d >> b))
+          b--;
+        c = b * 2 + ((d >> (b - 1)) & 1);
+      }
+      *Extra = c < 4 ? 0 : c / 2 - 1;
+      *Value = c < 4 ? 0 : (D - 1) & ((1 << *Extra) - 1);
+      return c;
+    } /* End of 'DistanceCode' function */
+
+    /* Write block with dynamic Huffman codes function.
+     * ARGUMENTS:
+     *   - tokens (literals or length << 16 | distance):
+     *       const UINT *Tokens, INT Count;
+     *   - last block flag:
+     *       BOOL IsLast;
+     * RETURNS: None.
+     */
+    VOID WriteBlock( const UINT *Tokens, INT Count, BOOL IsLast )
+    {
+      static const BYTE Order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+      UINT LitFreq[286] = {0}, DistFreq[30] = {0}, LitCode[286], DistCode[30];
+      BYTE LitLen[286], DistLen[30];
+      INT e, v;
+
+      for (INT i = 0; i < Count; i++)
+        if (Tokens[i] < 256)
+          LitFreq[Tokens[i]]++;
+        else
+        {
+          LitFreq[257 + LengthCode(Tokens[i] >> 16, &e, &v)]++;
+          DistFreq[DistanceCode(Tokens[i] & 0xFFFF, &e, &v)]++;
+        }
+      LitFreq[256] = 1;
+      BuildLengths(LitFreq, 286, 15, LitLen);
+      BuildLengths(DistFreq, 30, 15, DistLen);
+      if (std::count(DistLen, DistLen + 30, 0) == 30)
+        DistLen[0] = 1; // one unused distance code for blocks without matches
+      BuildCodes(LitLen, 286, LitCode);
+      BuildCodes(DistLen, 30, DistCode);
+
+      // code lengths of both alphabets compressed by runs
+      INT nlit = 286, ndist = 30, n = 0;
+      BYTE All[316];
+      stock<INT> Sym;
+      UINT CFreq[19] = {0}, CCode[19];
+      BYTE CLen[19];
+
+      while (nlit > 257 && LitLen[nlit - 1] == 0)
+        nlit--;
+      while (ndist > 1 && DistLen[ndist - 1] == 0)
+        ndist--;
+      memcpy(All, LitLen, nlit);
+      memcpy(All + nlit, DistLen, ndist);
+      for (INT i = 0, total = nlit + ndist; i < total; )
+      {
+        INT l = All[i], run = 1;
+
+        while (i + run < total && All[i + run] == l)
+          run++;
+        i += run;
+        if (l == 0)
+          for (; run > 0; )
+            if (run >= 11)
+            {
+              INT r = COM_MIN(run, 138);
+              Sym.push_back(18 | (r - 11) << 8), run -= r;
+            }
+            else if (run >= 3)
+              Sym.push_back(17 | (run - 3) << 8), run = 0;
+            else
+              Sym.push_back(0), run--;
+        else
+        {
+          Sym.push_back(l), run--;
+          for (; run > 0; )
+            if (run >= 3)
+            {
+              INT r = COM_MIN(run, 6);
+              Sym.push_back(16 | (r - 3) << 8), run -= r;
+            }
+            else
+              Sym.push_back(l), run--;
+        }
+      }
+      for (INT s : Sym)
+        CFreq[s & 0xFF]++;
+      BuildLengths(CFreq, 19, 7, CLen);
+      BuildCodes(CLen, 19, CCode);
+      n = 19;
+      while (n > 4 && CLen[Order[n - 1]] == 0)
+        n--;
+
+      Put(IsLast, 1);
+      Put(2, 2);
+      Put(nlit - 257, 5);
+      Put(ndist - 1, 5);
+      Put(n - 4, 4);
+      for (INT k = 0; k < n; k++)
+        Put(CLen[Order[k]], 3);
+      for (INT s : Sym)
+      {
+        INT c = s & 0xFF;
+
+        Put(CCode[c], CLen[c]);
+        if (c >= 16)
+          Put(s >> 8, c == 16 ? 2 : c == 17 ? 3 : 7);
+      }
+
+      for (INT i = 0; i < Count; i++)
+        if (Tokens[i] < 256)
+          Put(LitCode[Tokens[i]], LitLen[Tokens[i]]);
+        else
+        {
+          INT c = 257 + LengthCode(Tokens[i] >> 16, &e, &v);
+
+          Put(LitCode[c], LitLen[c]);
+          Put(v, e);
+          c = DistanceCode(Tokens[i] & 0xFFFF, &e, &v);
+          Put(DistCode[c], DistLen[c]);
+          Put(v, e);
+        }
+      Put(LitCode[256], LitLen[256]);
+    } /* End of 'WriteBlock' function */
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - reference at output bytes:
+     *       stock<BYTE> &Output;
+     */
+    deflater( stock<BYTE> &Output ) : Out(Output), Bits(0), BitsCount(0)
+    {
+    } /* End of 'deflater' function */
+
+  public:
+    /* Compress data to zlib stream function.
+     * ARGUMENTS:
+     *   - data to compress:
+     *       const BYTE *Data, INT Size;
+     *   - reference at output bytes (compressed data is appended):
+     *       stock<BYTE> &Out;
+     * RETURNS: None.
+     */
+    static VOID Compress( const BYTE *Data, INT Size, stock<BYTE> &Out )
+    {
+      deflater D(Out);
+      stock<INT> Head, Prev;
+      stock<UINT> Tokens;
+
+      Out.push_back(0x78);
+      Out.push_back(0x9C);
+
+      Head.assign(HashSize, -1);
+      Prev.resize(WinSize);
+      Tokens.reserve(BlockTokens);
+
+      auto Hash =
+        [Data]( INT P ) -> INT
+        {
+          return ((Data[P] << 10) ^ (Data[P + 1] << 5) ^ Data[P + 2]) & (HashSize - 1);
+        };
+      auto Insert =
+        [&]( INT P )
+        {
+          INT h = Hash(P);
+
+          Prev[P & (WinSize - 1)] = Head[h];
+          Head[h] = P;
+        };
+
+      auto Find =
+        [&]( INT P, INT *Dist ) -> INT
+        {
+          INT best = 0;
+
+          if (P + 2 >= Size)
+            return 0;
+
+          INT maxlen = COM_MIN(MaxMatch, Size - P), chain = MaxChain;
+
+          // chain positions decrease, stale window slots are older than window
+          for (INT p = Head[Hash(P)]; p >= 0 && P - p <= WinSize && chain-- > 0; p = Prev[p & (WinSize - 1)])
+          {
+            if (Data[p + best] != Data[P + best])
+              continue;
+
+            INT l = 0;
+            while (l < maxlen && Data[p + l] == Data[P + l])
+              l++;
+            if (l > best)
+            {
+              best = l, *Dist = P - p;
+              if (l == maxlen)
+                break;
+            }
+          }
+          return best >= 3 ? best : 0;
+        };
+      auto Emit =
+        [&]( UINT Token )
+        {
+          Tokens.push_back(Token);
+          if ((INT)Tokens.size() == BlockTokens)
+          {
+            D.WriteBlock(Tokens.data(), BlockTokens, FALSE);
+            Tokens.clear();
+          }
+        };
+
+      // lazy matching: short match is deferred while next position gives longer one
+      INT PrevLen = 0, PrevDist = 0;
+      for (INT i = 0; i < Size; )
+      {
+        INT dist = 0, len = Find(i, &dist);
+
+        if (i + 2 < Size)
+          Insert(i);
+        if (PrevLen > 0 && len <= PrevLen)
+        {
+          // deferred match from previous position
+          Emit((UINT)PrevLen << 16 | PrevDist);
+          for (INT k = i + 1; k < i - 1 + PrevLen; k++)
+            if (k + 2 < Size)
+              Insert(k);
+          i += PrevLen - 1;
+          PrevLen = 0;
+          continue;
+        }
+        if (PrevLen > 0)
+          Emit(Data[i - 1]);
+        PrevLen = 0;
+        if (len > 0 && len < LazyMatch)
+        {
+          PrevLen = len, PrevDist = dist;
+          i++;
+        }
+        else if (len > 0)
+        {
+          Emit((UINT)len << 16 | dist);
+          for (INT k = i + 1; k < i + len; k++)
+            if (k + 2 < Size)
+              Insert(k);
+          i += len;
+        }
+        else
+          Emit(Data[i++]);
+      }
+      D.WriteBlock(Tokens.data(), (INT)Tokens.size(), TRUE);
+      if (D.BitsCount > 0)
+        Out.push_back((BYTE)D.Bits);
+
+      // Adler-32 checksum (sums are reduced before 32-bit overflow)
+      UINT a = 1, b = 0;
+      for (INT i = 0; i < Size; )
+      {
+        for (INT end = COM_MIN(Size, i + 5552); i < end; i++)
+          a += Data[i], b += a;
+        a %= 65521, b %= 65521;
+      }
+      for (INT s = 24; s >= 0; s -= 8)
+        Out.push_back((BYTE)((b << 16 | a) >> s));
+    } /* End of 'Compress' function */
+  }; /* End of 'deflater' class */
+
+  /* Compressed image encoders class */
+  class image_encoder
+  {
+    /* Append PNG chunk function.
+     * ARGUMENTS:
+     *   - reference at output bytes:
+     *       stock<BYTE> &Out;
+     *   - chunk type:
+     *       const CHAR *Type;
+     *   - chunk data:
+     *       const BYTE *Data, INT Size;
+     * RETURNS: None.
+     */
+    static VOID PngChunk( stock<BYTE> &Out, const CHAR *Type, const BYTE *Data, INT Size )
+    {
+      static const stock<UINT> Table =
+        []( VOID )
+        {
+          stock<UINT> t;
+
+          t.resize(256);
+          for (UINT n = 0; n < 256; n++)
+          {
+            UINT c = n;
+
+            for (INT k = 0; k < 8; k++)
+              c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            t[n] = c;
+          }
+          return t;
+        }();
+      UINT crc = 0xFFFFFFFF;
+
+      for (INT s = 24; s >= 0; s -= 8)
+        Out.push_back((BYTE)(Size >> s));
+      for (INT i = 0; i < 4; i++)
+      {
+        Out.push_back(Type[i]);
+        crc = Table[(crc ^ (BYTE)Type[i]) & 0xFF] ^ (crc >> 8);
+      }
+      Out.insert(Out.end(), Data, Data + Size);
+      for (INT i = 0; i < Size; i++)
+        crc = Table[(crc ^ Data[i]) & 0xFF] ^ (crc >> 8);
+      crc ^= 0xFFFFFFFF;
+      for (INT s = 24; s >= 0; s -= 8)
+        Out.push_back((BYTE)(crc >> s));
+    } /* End of 'PngChunk' function */
+
+  public:
+    /* Encode image to RLE compressed TGA (image type 10) function.
+     * ARGUMENTS:
+     *   - image pixels (rows from top to bottom, as in frame):
+     *       const DWORD *Image;
+     *   - image size:
+     *       INT W, H;
+     *   - reference at output bytes:
+     *       stock<BYTE> &Out;
+     * RETURNS: None.
+     */
+    static VOID EncodeTga( const DWORD *Image, INT W, INT H, stock<BYTE> &Out )
+    {
+      CHAR Copyright[] = "DB6's picture";
+      tgaFILEHEADER Header =
+      {
+        sizeof(Copyright),
+        0,                // No palette
+        10,               // RLE compressed RGB image
+        0, 0, 0,          // color map info (absent)
+        0, 0,             // Start (X,Y)
+        (WORD)W, (WORD)H, // Image size
+        32,               // Bits per pixel
+        0x28,             // Upper-left image orign, 8-bit alpha-channel
+      };
+
+      Out.clear();
+      Out.insert(Out.end(), (const BYTE *)&Header, (const BYTE *)&Header + sizeof(Header));
+      Out.insert(Out.end(), (const BYTE *)Copyright, (const BYTE *)Copyright + sizeof(Copyright));
+
+      // packets do not cross rows
+      for (INT y = 0; y < H; y++)
+      {
+        const DWORD *Row = Image + y * W;
+
+        for (INT x = 0; x < W; )
+        {
+          INT n = 1;
+
+          while (x + n < W && n < 128 && Row[x + n] == Row[x])
+            n++;
+          if (n >= 2)
+          {
+            Out.push_back((BYTE)(0x80 | (n - 1)));
+            Out.insert(Out.end(), (const BYTE *)(Row + x), (const BYTE *)(Row + x + 1));
+          }
+          else
+          {
+            // raw packet lasts up to next pair of equal pixels
+            while (x + n < W && n < 128 && (x + n + 1 >= W || Row[x + n] != Row[x + n + 1]))
+              n++;
+            Out.push_back((BYTE)(n - 1));
+            Out.insert(Out.end(), (const BYTE *)(Row + x), (const BYTE *)(Row + x + n));
+          }
+          x += n;
+        }
+      }
+      Out.insert(Out.end(), (const BYTE *)TGA_EXT_SIGNATURE, (const BYTE *)TGA_EXT_SIGNATURE + sizeof(TGA_EXT_SIGNATURE));
+    } /* End of 'EncodeTga' function */
+
+    /* Encode image to PNG function.
+     * Every row is filtered by one of five PNG filters which gives
+     * fewest breaks of equal pixel runs (long LZ77 matches), ties are
+     * resolved by minimal sum of absolute differences. Alpha is dropped
+     * if image is opaque.
+     * ARGUMENTS:
+     *   - image pixels (rows from top to bottom, as in frame):
+     *       const DWORD *Image;
+     *   - image size:
+     *       INT W, H;
+     *   - reference at output bytes:
+     *       stock<BYTE> &Out;
+     * RETURNS: None.
+     */
+    static VOID EncodePng( const DWORD *Image, INT W, INT H, stock<BYTE> &Out )
+    {
+      static const BYTE Signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+      BOOL IsOpaque = TRUE;
+
+      for (INT i = 0; i < W * H && IsOpaque; i++)
+        IsOpaque = (Image[i] >> 24) == 0xFF;
+
+      INT bpp = IsOpaque ? 3 : 4, stride = W * bpp;
+      stock<BYTE> Raw, Cur, Prev, Try, Filtered;
+
+      Cur.resize(stride);
+      Prev.assign(stride, 0);
+      Try.resize(stride);
+      Raw.reserve((size_t)(stride + 1) * H);
+      for (INT y = 0; y < H; y++)
+      {
+        for (INT x = 0; x < W; x++)
+        {
+          DWORD c = Image[y * W + x];
+          BYTE *p = &Cur[x * bpp];
+
+          p[0] = (BYTE)(c >> 16), p[1] = (BYTE)(c >> 8), p[2] = (BYTE)c;
+          if (bpp == 4)
+            p[3] = (BYTE)(c >> 24);
+        }
+
+        UINT64 BestCost = ~(UINT64)0;
+        INT BestFilter = 0;
+        for (INT f = 0; f < 5; f++)
+        {
+          UINT sum = 0, breaks = 0;
+
+          for (INT i = 0; i < stride; i++)
+          {
+            INT
+              a = i >= bpp ? Cur[i - bpp] : 0,
+              b = Prev[i],
+              c = i >= bpp ? Prev[i - bpp] : 0,
+              pred = 0;
+
+            if (f == 1)
+              pred = a;
+            else if (f == 2)
+              pred = b;
+            else if (f == 3)
+              pred = (a + b) >> 1;
+            else if (f == 4)
+            {
+              INT p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+              pred = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+            }
+            Try[i] = (BYTE)(Cur[i] - pred);
+            sum += abs((signed char)Try[i]);
+            if (i >= bpp && Try[i] != Try[i - bpp])
+              breaks++;
+          }
+
+          UINT64 cost = (UINT64)breaks << 32 | sum;
+          if (cost < BestCost)
+          {
+            BestCost = cost, BestFilter = f;
+            Filtered.assign(Try.begin(), Try.end());
+          }
+        }
+        Raw.push_back((BYTE)BestFilter);
+        Raw.insert(Raw.end(), Filtered.begin(), Filtered.end());
+        Prev.swap(Cur);
+      }
+
+      BYTE Ihdr[13] =
+      {
+        (BYTE)(W >> 24), (BYTE)(W >> 16), (BYTE)(W >> 8), (BYTE)W,
+        (BYTE)(H >> 24), (BYTE)(H >> 16), (BYTE)(H >> 8), (BYTE)H,
+        8, (BYTE)(IsOpaque ? 2 : 6), 0, 0, 0 // 8-bit RGB or RGBA, deflate, adaptive filters, no interlace
+      };
+      stock<BYTE> Data;
+
+      deflater::Compress(Raw.data(), (INT)Raw.size(), Data);
+      Out.clear();
+      Out.insert(Out.end(), Signature, Signature + 8);
+      PngChunk(Out, "IHDR", Ihdr, 13);
+      PngChunk(Out, "IDAT", Data.data(), (INT)Data.size());
+      PngChunk(Out, "IEND", nullptr, 0);
+    } /* End of 'EncodePng' function */
+  }; /* End of 'image_encoder' class */
+} /* end of 'dart' namespace */
+
+#endif // __image_encoder_h_
+
+/* END OF 'image_encoder.h' FILE */
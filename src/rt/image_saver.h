@@ -0,0 +1,210 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : image_saver.h
+ * PURPOSE     : Raytracing project.
+ *               Background images saving module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __image_saver_h_
+#define __image_saver_h_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "rt/image_encoder.h"
+
+namespace dart
+{
+  /* Background images saving class.
+   * Images are copied to bounded queue and encoded (RLE TGA or PNG by
+   * file name extension) and written by encoder thread, so renderer
+   * only pays for the copy. Renderer waits only if queue is full, which
+   * bounds memory when encoding is slower than rendering.
+   */
+  class image_saver
+  {
+    /* Saving job structure */
+    struct job
+    {
+      std::string FileName; // Output file name
+      stock<DWORD> Image;   // Image pixels copy
+      INT W, H;             // Image size
+    };
+
+    std::thread Th;                   // Encoder thread
+    std::mutex Mutex;                 // Queue lock
+    std::condition_variable Changed;  // Queue state change notification
+    std::deque<job> Queue;            // Waiting jobs
+    INT Capacity;                     // Maximum waiting jobs count
+    INT Pending;                      // Waiting and encoding jobs count
+    BOOL IsDone;                      // Stop encoder thread flag
+
+    /* Encoder thread function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Run( VOID )
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+
+      for (;;)
+      {
+        Changed.wait(Lock,
+          [this]( VOID )
+          {
+            return IsDone || !Queue.empty();
+          });
+        if (Queue.empty())
+          return;
+
+        job Job = std::move(Queue.front());
+        Queue.pop_front();
+        Changed.notify_all();
+
+        Lock.unlock();
+        if (Write(Job.FileName.c_str(), Job.Image.data(), Job.W, Job.H))
+          Written++;
+        else
+          Failed++;
+        Lock.lock();
+
+        Pending--;
+        Changed.notify_all();
+      }
+    } /* End of 'Run' function */
+
+  public:
+    std::atomic<INT> Written; // Written images count
+    std::atomic<INT> Failed;  // Not written images count
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - maximum waiting images count:
+     *       INT QueueSize;
+     */
+    image_saver( INT QueueSize = 4 ) :
+      Capacity(COM_MAX(1, QueueSize)), Pending(0), IsDone(FALSE), Written(0), Failed(0)
+    {
+      Th = std::thread(&image_saver::Run, this);
+    } /* End of 'image_saver' function */
+
+    /* Class destructor (waits for all images) */
+    ~image_saver( VOID )
+    {
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        IsDone = TRUE;
+      }
+      Changed.notify_all();
+      Th.join();
+    } /* End of '~image_saver' function */
+
+    /* Encode and write image to file function.
+     * Image is written under temporary name and renamed when completed,
+     * so file either does not exist or is full.
+     * ARGUMENTS:
+     *   - file name (PNG for ".png" extension, RLE TGA overwise):
+     *       const CHAR *FileName;
+     *   - image pixels (rows from top to bottom, as in frame):
+     *       const DWORD *Image;
+     *   - image size:
+     *       INT W, H;
+     * RETURNS:
+     *   (BOOL) TRUE if file is written, FALSE overwise.
+     */
+    static BOOL Write( const CHAR *FileName, const DWORD *Image, INT W, INT H )
+    {
+      const CHAR *ext = strrchr(FileName, '.');
+      BOOL IsPng = ext != nullptr && _stricmp(ext, ".png") == 0;
+      stock<BYTE> Data;
+
+      if (W <= 0 || H <= 0 || (!IsPng && (W > 0xFFFF || H > 0xFFFF)))
+        return FALSE;
+      if (IsPng)
+        image_encoder::EncodePng(Image, W, H, Data);
+      else
+        image_encoder::EncodeTga(Image, W, H, Data);
+
+      std::string TmpName = std::string(FileName) + ".tmp";
+      FILE *F = fopen(TmpName.c_str(), "wb");
+
+      if (F == nullptr)
+        return FALSE;
+
+      BOOL IsOk = fwrite(Data.data(), 1, Data.size(), F) == Data.size();
+
+      IsOk = fclose(F) == 0 && IsOk;
+      if (IsOk)
+      {
+        remove(FileName);
+        IsOk = rename(TmpName.c_str(), FileName) == 0;
+      }
+      if (!IsOk)
+        remove(TmpName.c_str());
+      return IsOk;
+    } /* End of 'Write' function */
+
+    /* Queue image saving function.
+     * ARGUMENTS:
+     *   - file name (PNG for ".png" extension, RLE TGA overwise):
+     *       const CHAR *FileName;
+     *   - image pixels (copied, may be changed right after call):
+     *       const DWORD *Image;
+     *   - image size:
+     *       INT W, H;
+     * RETURNS: None.
+     */
+    VOID Save( const CHAR *FileName, const DWORD *Image, INT W, INT H )
+    {
+      job Job;
+
+      // copy is made before lock, so encoder is not stopped by it
+      Job.FileName = FileName;
+      Job.Image.assign(Image, Image + W * H);
+      Job.W = W, Job.H = H;
+
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Changed.wait(Lock,
+        [this]( VOID )
+        {
+          return (INT)Queue.size() < Capacity;
+        });
+      Queue.push_back(std::move(Job));
+      Pending++;
+      Changed.notify_all();
+    } /* End of 'Save' function */
+
+    /* Wait for all queued images function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Flush( VOID )
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+
+      Changed.wait(Lock,
+        [this]( VOID )
+        {
+          return Pending == 0;
+        });
+    } /* End of 'Flush' function */
+  }; /* End of 'image_saver' class */
+} /* end of 'dart' namespace */
+
+#endif // __image_saver_h_
+
+/* END OF 'image_saver.h' FILE */
@@ -0,0 +1,254 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : image_writer.h
+ * PURPOSE     : Raytracing project.
+ *               Streaming image files writing module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __image_writer_h_
+#define __image_writer_h_
+
+#include <cstring>
+#include <fstream>
+
+#include "rt/frame.h"
+
+namespace dart
+{
+  /* Image file formats */
+  enum image_format
+  {
+    IMAGE_TGA, // Uncompressed 32-bit TGA (8-bit colors and alpha)
+    IMAGE_PPM, // Binary PPM (8-bit colors)
+    IMAGE_EXR  // Scanline OpenEXR (32-bit float linear colors, no compression)
+  };
+
+  /* Streaming image writer class.
+   * Image is written by rows bands from top to bottom as they are
+   * rendered, so only one band is kept in memory. All formats are
+   * written in file order without seeking back: sizes are known
+   * before first row (EXR lines offsets table is computed in advance).
+   */
+  class image_writer
+  {
+    std::fstream F;       // Output file
+    image_format Format;  // Output format
+    INT W, H;             // Image size
+    INT Rows;             // Written rows count
+    stock<BYTE> Line;     // Row conversion buffer
+
+    /* Write EXR header attribute function.
+     * ARGUMENTS:
+     *   - attribute name and type name:
+     *       const CHAR *Name, *Type;
+     *   - attribute value:
+     *       const VOID *Data;
+     *   - attribute value size in bytes:
+     *       INT Size;
+     * RETURNS: None.
+     */
+    VOID ExrAttr( const CHAR *Name, const CHAR *Type, const VOID *Data, INT Size )
+    {
+      F.write(Name, strlen(Name) + 1);
+      F.write(Type, strlen(Type) + 1);
+      F.write((const CHAR *)&Size, 4);
+      F.write((const CHAR *)Data, Size);
+    } /* End of 'ExrAttr' function */
+
+    /* Write file header function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID WriteHeader( VOID )
+    {
+      if (Format == IMAGE_PPM)
+      {
+        CHAR Buf[50];
+
+        F.write(Buf, sprintf(Buf, "P6\n%d %d\n255\n", W, H));
+      }
+      else if (Format == IMAGE_TGA)
+      {
+        CHAR Copyright[] = "DB6's picture";
+        tgaFILEHEADER Header =
+        {
+          sizeof(Copyright),
+          0,                // No palette
+          2,                // Uncompressed RGB image
+          0, 0, 0,          // color map info (absent)
+          0, 0,             // Start (X,Y)
+          (WORD)W, (WORD)H, // Image size
+          32,               // Bits per pixel
+          0x28,             // Upper-left image orign, 8-bit alpha-channel
+        };
+
+        F.write((const CHAR *)&Header, sizeof(Header));
+        F.write(Copyright, sizeof(Copyright));
+      }
+      else
+      {
+        const BYTE Magic[8] = {0x76, 0x2F, 0x31, 0x01, 2, 0, 0, 0}; // version 2, single part scanline
+        BYTE Channels[3 * 18 + 1] = {0};
+        INT Box[4] = {0, 0, W - 1, H - 1};
+        FLT Aspect = 1, Center[2] = {0, 0}, Width = 1;
+        BYTE Compression = 0, Order = 0; // NO_COMPRESSION, INCREASING_Y
+
+        // channels are sorted by names, all are 32-bit float (type 2)
+        for (INT c = 0; c < 3; c++)
+        {
+          BYTE *ch = Channels + c * 18;
+          INT Type = 2, Sampling = 1;
+
+          ch[0] = "BGR"[c];
+          memcpy(ch + 2, &Type, 4);
+          memcpy(ch + 10, &Sampling, 4);
+          memcpy(ch + 14, &Sampling, 4);
+        }
+        F.write((const CHAR *)Magic, 8);
+        ExrAttr("channels", "chlist", Channels, sizeof(Channels));
+        ExrAttr("compression", "compression", &Compression, 1);
+        ExrAttr("dataWindow", "box2i", Box, 16);
+        ExrAttr("displayWindow", "box2i", Box, 16);
+        ExrAttr("lineOrder", "lineOrder", &Order, 1);
+        ExrAttr("pixelAspectRatio", "float", &Aspect, 4);
+        ExrAttr("screenWindowCenter", "v2f", Center, 8);
+        ExrAttr("screenWindowWidth", "float", &Width, 4);
+        F.put(0);
+
+        // every line is separate chunk of fixed size
+        UINT64 Offset = (UINT64)F.tellp() + (UINT64)H * 8;
+
+        for (INT y = 0; y < H; y++, Offset += 8 + (UINT64)W * 12)
+          F.write((const CHAR *)&Offset, 8);
+      }
+    } /* End of 'WriteHeader' function */
+
+  public:
+    /* Class default constructor */
+    image_writer( VOID ) : Format(IMAGE_TGA), W(0), H(0), Rows(0)
+    {
+    } /* End of 'image_writer' function */
+
+    /* Get image format by file name extension function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     * RETURNS:
+     *   (image_format) image format (TGA for unknown extensions).
+     */
+    static image_format FormatOf( const CHAR *FileName )
+    {
+      const CHAR *ext = strrchr(FileName, '.');
+
+      if (ext != nullptr && _stricmp(ext, ".ppm") == 0)
+        return IMAGE_PPM;
+      if (ext != nullptr && _stricmp(ext, ".exr") == 0)
+        return IMAGE_EXR;
+      return IMAGE_TGA;
+    } /* End of 'FormatOf' function */
+
+    /* Start image file function.
+     * ARGUMENTS:
+     *   - file name (format is taken by extension):
+     *       const CHAR *FileName;
+     *   - image size:
+     *       INT Width, Height;
+     * RETURNS:
+     *   (BOOL) TRUE if file is created, FALSE overwise.
+     */
+    BOOL Open( const CHAR *FileName, INT Width, INT Height )
+    {
+      Format = FormatOf(FileName);
+      W = Width, H = Height, Rows = 0;
+      if (W <= 0 || H <= 0 || (Format == IMAGE_TGA && (W > 0xFFFF || H > 0xFFFF)))
+        return FALSE;
+
+      F.open(FileName, std::fstream::out | std::fstream::binary);
+      if (!F)
+        return FALSE;
+      WriteHeader();
+      return !F.fail();
+    } /* End of 'Open' function */
+
+    /* Append frame rows to image function.
+     * ARGUMENTS:
+     *   - reference at frame (band of image just below written rows,
+     *     colors must be resolved):
+     *       const frame &Frm;
+     * RETURNS:
+     *   (BOOL) TRUE if rows are written, FALSE overwise.
+     */
+    BOOL Write( const frame &Frm )
+    {
+      if (!F.is_open() || Frm.W != W || Rows + Frm.H > H)
+        return FALSE;
+
+      for (INT y = 0; y < Frm.H; y++, Rows++)
+      {
+        const DWORD *Row = Frm.Image + y * W;
+
+        if (Format == IMAGE_TGA)
+          F.write((const CHAR *)Row, W * 4);
+        else if (Format == IMAGE_PPM)
+        {
+          Line.resize(W * 3);
+          for (INT x = 0; x < W; x++)
+          {
+            Line[x * 3 + 0] = (BYTE)(Row[x] >> 16);
+            Line[x * 3 + 1] = (BYTE)(Row[x] >> 8);
+            Line[x * 3 + 2] = (BYTE)Row[x];
+          }
+          F.write((const CHAR *)Line.data(), W * 3);
+        }
+        else
+        {
+          // line chunk: line number, data size, then B, G and R planes
+          INT Head[2] = {Rows, W * 12};
+          FLT *p;
+
+          Line.resize(W * 12);
+          p = (FLT *)Line.data();
+          for (INT x = 0; x < W; x++)
+          {
+            const FLT *c = &Frm.Hdr[Frm.Index(x, y) * 4];
+
+            p[x] = c[2] * Frm.Exposure;
+            p[W + x] = c[1] * Frm.Exposure;
+            p[W * 2 + x] = c[0] * Frm.Exposure;
+          }
+          F.write((const CHAR *)Head, 8);
+          F.write((const CHAR *)Line.data(), W * 12);
+        }
+      }
+      return !F.fail();
+    } /* End of 'Write' function */
+
+    /* Finish image file function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if all image rows are written, FALSE overwise.
+     */
+    BOOL Close( VOID )
+    {
+      if (!F.is_open())
+        return FALSE;
+      if (Format == IMAGE_TGA)
+        F.write(TGA_EXT_SIGNATURE, sizeof(TGA_EXT_SIGNATURE));
+      F.close();
+      return !F.fail() && Rows == H;
+    } /* End of 'Close' function */
+  }; /* End of 'image_writer' class */
+} /* end of 'dart' namespace */
+
+#endif // __image_writer_h_
+
+/* END OF 'image_writer.h' FILE */
@@ -8,7 +8,7 @@
  *               Ray tracing light declaration module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 27.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -39,6 +39,14 @@ namespace dart
     }; /* End of 'light_info' class */
 
 
+    /* Light source types of flat descriptions (scene snapshots) */
+    enum
+    {
+      LIGHT_DIRECT = 1,
+      LIGHT_SPOT,
+      LIGHT_POINT
+    };
+
     /* Light source class */
     class light
     {
@@ -50,6 +58,11 @@ namespace dart
       {
       } /* End of 'light' function */
 
+      /* Class destructor */
+      virtual ~light( VOID )
+      {
+      } /* End of '~light' function */
+
       /* Get shadow coefficent for point function.
        * ARGUMENTS:
        *   - reference at point:
@@ -62,6 +75,72 @@ namespace dart
       {
         return 0;
       } /* End of 'Shadow' function */
+
+      /* Determine if light source has position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE for point-like light sources, FALSE for infinite ones.
+       */
+      virtual BOOL IsLocal( VOID )
+      {
+        return FALSE;
+      } /* End of 'IsLocal' function */
+
+      /* Get light source position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (vec3) light source position.
+       */
+      virtual vec3 Position( VOID )
+      {
+        return vec3(0);
+      } /* End of 'Position' function */
+
+      /* Get light source power estimation function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (DBL) light source power.
+       */
+      virtual DBL Power( VOID )
+      {
+        return 0;
+      } /* End of 'Power' function */
+
+      /* Get light source orientation factor for point function.
+       * ARGUMENTS:
+       *   - reference at point:
+       *       const vec3 &P;
+       * RETURNS:
+       *   (DBL) orientation factor in range (0; 1].
+       */
+      virtual DBL Orientation( const vec3 & /* P */ )
+      {
+        return 1;
+      } /* End of 'Orientation' function */
+
+      /* Get light source flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add light parameters to:
+       *       stock<DBL> &Params;
+       * RETURNS:
+       *   (INT) light source type (LIGHT_*** value), 0 if light has no flat description.
+       */
+      virtual INT Flatten( stock<DBL> & /* Params */ ) const
+      {
+        return 0;
+      } /* End of 'Flatten' function */
+
+      /* Set light source by flat description function.
+       * ARGUMENTS:
+       *   - light parameters:
+       *       const DBL *Params, INT Count;
+       * RETURNS:
+       *   (BOOL) TRUE if light is set, FALSE if description is not valid.
+       */
+      virtual BOOL Restore( const DBL * /* Params */, INT /* Count */ )
+      {
+        return FALSE;
+      } /* End of 'Restore' function */
     }; /* End of 'light' class */
 
 
@@ -92,11 +171,50 @@ namespace dart
        *       ligth_info *LI;
        * RETURNS: None.
        */
-      DBL Shadow( const vec3 &P, light_info *LI ) override
+      DBL Shadow( const vec3 & /* P */, light_info *LI ) override
       {
         LI->Color = Clr, LI->Dir = Dir, LI->Dist = DBL_MAX;
         return COM_MIN(1 / (Cc + Cl * LI->Dist + Cq * LI->Dist * LI->Dist), 1);
       } /* End of 'Shadow' function */
+
+      /* Get light source power estimation function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (DBL) light source power.
+       */
+      DBL Power( VOID ) override
+      {
+        return (Clr.X + Clr.Y + Clr.Z) / 3;
+      } /* End of 'Power' function */
+
+      /* Get light source flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add light parameters to:
+       *       stock<DBL> &Params;
+       * RETURNS:
+       *   (INT) light source type (LIGHT_*** value), 0 if light has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params ) const override
+      {
+        Params << Cc << Cl << Cq << Dir.X << Dir.Y << Dir.Z << Clr.X << Clr.Y << Clr.Z;
+        return LIGHT_DIRECT;
+      } /* End of 'Flatten' function */
+
+      /* Set light source by flat description function.
+       * ARGUMENTS:
+       *   - light parameters:
+       *       const DBL *Params, INT Count;
+       * RETURNS:
+       *   (BOOL) TRUE if light is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count ) override
+      {
+        if (Count != 9)
+          return FALSE;
+        Cc = Params[0], Cl = Params[1], Cq = Params[2];
+        Dir = vec3(Params[3], Params[4], Params[5]), Clr = vec3(Params[6], Params[7], Params[8]);
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'direct' class */
 
     /* Spot light source class */
@@ -142,6 +260,80 @@ namespace dart
           LI->Dir = Dir;
         return COM_MIN(1 / (Cc + Cl * LI->Dist + Cq * LI->Dist * LI->Dist), 1);
       } /* End of 'Shadow' function */
+
+      /* Determine if light source has position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE for point-like light sources, FALSE for infinite ones.
+       */
+      BOOL IsLocal( VOID ) override
+      {
+        return TRUE;
+      } /* End of 'IsLocal' function */
+
+      /* Get light source position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (vec3) light source position.
+       */
+      vec3 Position( VOID ) override
+      {
+        return Pos;
+      } /* End of 'Position' function */
+
+      /* Get light source power estimation function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (DBL) light source power.
+       */
+      DBL Power( VOID ) override
+      {
+        return (Clr.X + Clr.Y + Clr.Z) / 3;
+      } /* End of 'Power' function */
+
+      /* Get light source orientation factor for point function.
+       * ARGUMENTS:
+       *   - reference at point:
+       *       const vec3 &P;
+       * RETURNS:
+       *   (DBL) orientation factor in range (0; 1].
+       */
+      DBL Orientation( const vec3 &P ) override
+      {
+        // points out of cone are still lit, so keep them sampleable
+        return (Dir & (Pos - P).Normalizing()) > ACos2 ? 1 : .25;
+      } /* End of 'Orientation' function */
+
+      /* Get light source flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add light parameters to:
+       *       stock<DBL> &Params;
+       * RETURNS:
+       *   (INT) light source type (LIGHT_*** value), 0 if light has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params ) const override
+      {
+        Params << Cc << Cl << Cq << Pos.X << Pos.Y << Pos.Z << Dir.X << Dir.Y << Dir.Z << ACos1 << ACos2 << Clr.X << Clr.Y << Clr.Z;
+        return LIGHT_SPOT;
+      } /* End of 'Flatten' function */
+
+      /* Set light source by flat description function.
+       * ARGUMENTS:
+       *   - light parameters:
+       *       const DBL *Params, INT Count;
+       * RETURNS:
+       *   (BOOL) TRUE if light is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count ) override
+      {
+        if (Count != 14)
+          return FALSE;
+        Cc = Params[0], Cl = Params[1], Cq = Params[2];
+        Pos = vec3(Params[3], Params[4], Params[5]), Dir = vec3(Params[6], Params[7], Params[8]);
+        ACos1 = Params[9], ACos2 = Params[10];
+        Clr = vec3(Params[11], Params[12], Params[13]);
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'spot' class */
 
     /* Point light source class */
@@ -175,6 +367,65 @@ namespace dart
         LI->Color = Clr, LI->Dir = (Pos - P).Normalizing(), LI->Dist = P.Distance(Pos);
         return COM_MIN(1 / (Cc + Cl * LI->Dist + Cq * LI->Dist * LI->Dist), 1);
       } /* End of 'Shadow' function */
+
+      /* Determine if light source has position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE for point-like light sources, FALSE for infinite ones.
+       */
+      BOOL IsLocal( VOID ) override
+      {
+        return TRUE;
+      } /* End of 'IsLocal' function */
+
+      /* Get light source position function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (vec3) light source position.
+       */
+      vec3 Position( VOID ) override
+      {
+        return Pos;
+      } /* End of 'Position' function */
+
+      /* Get light source power estimation function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (DBL) light source power.
+       */
+      DBL Power( VOID ) override
+      {
+        return (Clr.X + Clr.Y + Clr.Z) / 3;
+      } /* End of 'Power' function */
+
+      /* Get light source flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add light parameters to:
+       *       stock<DBL> &Params;
+       * RETURNS:
+       *   (INT) light source type (LIGHT_*** value), 0 if light has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params ) const override
+      {
+        Params << Cc << Cl << Cq << Pos.X << Pos.Y << Pos.Z << Clr.X << Clr.Y << Clr.Z;
+        return LIGHT_POINT;
+      } /* End of 'Flatten' function */
+
+      /* Set light source by flat description function.
+       * ARGUMENTS:
+       *   - light parameters:
+       *       const DBL *Params, INT Count;
+       * RETURNS:
+       *   (BOOL) TRUE if light is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count ) override
+      {
+        if (Count != 9)
+          return FALSE;
+        Cc = Params[0], Cl = Params[1], Cq = Params[2];
+        Pos = vec3(Params[3], Params[4], Params[5]), Clr = vec3(Params[6], Params[7], Params[8]);
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'point' class */
   } /* end of 'lgh' namespace */
 } /* end of 'dart' namespace */
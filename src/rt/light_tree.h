@@ -0,0 +1,211 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : light_tree.h
+ * PURPOSE     : Raytracing project.
+ *               Light sources hierarchy for many-lights sampling module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __light_tree_h_
+#define __light_tree_h_
+
+#include <algorithm>
+
+#include "rt/light.h"
+
+namespace dart
+{
+  namespace lgh
+  {
+    /* Light sources bounding volume hierarchy class.
+     * Local (point, spot) light sources are stored in binary tree
+     * nodes with bound box and summary power. Sampling descends the
+     * tree choosing child proportional to its importance for shading
+     * point, so one light is picked in O(log N) with known probability.
+     */
+    class tree
+    {
+      /* Tree node struct */
+      struct node
+      {
+        vec3 Min, Max;   // Node bound box
+        DBL Power;       // Summary power of node lights
+        INT Left, Right; // Children indices for inner node
+        INT Light;       // Light index for leaf, -1 for inner node
+      }; /* End of 'node' struct */
+
+      stock<node> Nodes;    // Tree nodes (root is first)
+      stock<light *> Local; // Lights in tree order
+
+      /* Build subtree function.
+       * ARGUMENTS:
+       *   - lights range to build:
+       *       INT Start, End;
+       * RETURNS:
+       *   (INT) built node index.
+       */
+      INT Build( INT Start, INT End )
+      {
+        INT Index = (INT)Nodes.size();
+        node Nd;
+
+        Nd.Min = vec3(DBL_MAX), Nd.Max = vec3(-DBL_MAX), Nd.Power = 0, Nd.Left = Nd.Right = -1, Nd.Light = -1;
+        for (INT i = Start; i < End; i++)
+        {
+          vec3 P = Local[i]->Position();
+
+          Nd.Min = vec3(COM_MIN(Nd.Min.X, P.X), COM_MIN(Nd.Min.Y, P.Y), COM_MIN(Nd.Min.Z, P.Z));
+          Nd.Max = vec3(COM_MAX(Nd.Max.X, P.X), COM_MAX(Nd.Max.Y, P.Y), COM_MAX(Nd.Max.Z, P.Z));
+          Nd.Power += Local[i]->Power();
+        }
+        Nodes.push_back(Nd);
+        if (End - Start == 1)
+        {
+          Nodes[Index].Light = Start;
+          return Index;
+        }
+
+        // split by median along the longest axis
+        vec3 Size = Nd.Max - Nd.Min;
+        INT Axis = Size.X > Size.Y ? (Size.X > Size.Z ? 0 : 2) : (Size.Y > Size.Z ? 1 : 2);
+        INT Mid = (Start + End) / 2;
+
+        std::nth_element(Local.begin() + Start, Local.begin() + Mid, Local.begin() + End,
+          [Axis]( light *A, light *B )
+          {
+            return A->Position()[Axis] < B->Position()[Axis];
+          });
+
+        INT L = Build(Start, Mid), R = Build(Mid, End);
+        Nodes[Index].Left = L, Nodes[Index].Right = R;
+        return Index;
+      } /* End of 'Build' function */
+
+      /* Evaluate node importance for shading point function.
+       * ARGUMENTS:
+       *   - reference at node:
+       *       const node &Nd;
+       *   - reference at shading point and normal:
+       *       const vec3 &P, &N;
+       * RETURNS:
+       *   (DBL) node importance (always positive for non-empty node).
+       */
+      DBL Importance( const node &Nd, const vec3 &P, const vec3 &N ) const
+      {
+        vec3 C = (Nd.Min + Nd.Max) / 2, D = C - P;
+        DBL
+          r2 = (Nd.Max - Nd.Min).Length2() / 4,
+          d2 = D.Length2(),
+          orient = 1;
+
+        if (Nd.Light >= 0)
+          orient = Local[Nd.Light]->Orientation(P);
+
+        // cone bound of angle between normal and directions to box
+        if (d2 > r2)
+        {
+          DBL
+            d = sqrt(d2),
+            cos_t = (N & D) / d,
+            sin_a = sqrt(r2) / d,
+            cos_a = sqrt(1 - sin_a * sin_a),
+            sin_t = sqrt(COM_MAX(0, 1 - cos_t * cos_t));
+
+          // cos(max(0, theta - alpha))
+          if (cos_t < cos_a)
+            cos_t = cos_t * cos_a + sin_t * sin_a;
+          else
+            cos_t = 1;
+          // never zero: back-facing lights still contribute to 'Shade'
+          orient *= COM_MAX(COM_ABS(cos_t), .05);
+        }
+        return Nd.Power * orient / COM_MAX(d2, COM_MAX(r2, Threshold));
+      } /* End of 'Importance' function */
+
+    public:
+      stock<light *> Infinite; // Lights without position (evaluated always)
+
+      /* Build tree by light sources list function.
+       * ARGUMENTS:
+       *   - reference at lights list:
+       *       const stock<light *> &Lights;
+       * RETURNS: None.
+       */
+      VOID Build( const stock<light *> &Lights )
+      {
+        Nodes.clear();
+        Local.clear();
+        Infinite.clear();
+        for (auto lgh : Lights)
+          if (!lgh->IsLocal())
+            Infinite << lgh;
+          else if (lgh->Power() > 0)
+            Local << lgh;
+        Nodes.reserve(Local.size() * 2);
+        if (!Local.empty())
+          Build(0, (INT)Local.size());
+      } /* End of 'Build' function */
+
+      /* Get local lights count function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (INT) lights in tree count.
+       */
+      INT Size( VOID ) const
+      {
+        return (INT)Local.size();
+      } /* End of 'Size' function */
+
+      /* Sample one local light function.
+       * ARGUMENTS:
+       *   - reference at shading point and normal:
+       *       const vec3 &P, &N;
+       *   - uniform random number in [0; 1):
+       *       DBL U;
+       *   - pointer at sample probability:
+       *       DBL *Pdf;
+       * RETURNS:
+       *   (light *) sampled light or nullptr if tree is empty.
+       */
+      light * Sample( const vec3 &P, const vec3 &N, DBL U, DBL *Pdf ) const
+      {
+        *Pdf = 0;
+        if (Nodes.empty())
+          return nullptr;
+
+        INT Index = 0;
+        DBL pdf = 1;
+
+        while (Nodes[Index].Light < 0)
+        {
+          INT L = Nodes[Index].Left, R = Nodes[Index].Right;
+          DBL
+            il = Importance(Nodes[L], P, N),
+            ir = Importance(Nodes[R], P, N),
+            pl = il + ir > 0 ? il / (il + ir) : .5;
+
+          // reuse random number rescaled to chosen interval
+          if (U < pl)
+            Index = L, U /= pl, pdf *= pl;
+          else
+            Index = R, U = (U - pl) / (1 - pl), pdf *= 1 - pl;
+          U = COM_MIN(U, 1 - DBL_EPSILON);
+        }
+        *Pdf = pdf;
+        return Local[Nodes[Index].Light];
+      } /* End of 'Sample' function */
+    }; /* End of 'tree' class */
+  } /* end of 'lgh' namespace */
+} /* end of 'dart' namespace */
+
+#endif // __light_tree_h_
+
+/* END OF 'light_tree.h' FILE */
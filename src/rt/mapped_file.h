@@ -0,0 +1,154 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : mapped_file.h
+ * PURPOSE     : Raytracing project.
+ *               Memory mapped files module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __mapped_file_h_
+#define __mapped_file_h_
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include "def.h"
+
+namespace dart
+{
+  /* Read only memory mapped file class.
+   * File pages are read by system when they are touched first and are
+   * shared by all processes mapping the same file.
+   */
+  class mapped_file
+  {
+#ifdef _WIN32
+    HANDLE File, Mapping; // File and mapping handles
+#else
+    INT File;             // File descriptor
+#endif
+    const BYTE *Data;     // Mapped file data
+    size_t Size;          // Mapped file size
+
+  public:
+    /* Class constructor */
+    mapped_file( VOID ) :
+#ifdef _WIN32
+      File(INVALID_HANDLE_VALUE), Mapping(nullptr),
+#else
+      File(-1),
+#endif
+      Data(nullptr), Size(0)
+    {
+    } /* End of 'mapped_file' function */
+
+    /* Class destructor */
+    ~mapped_file( VOID )
+    {
+      Close();
+    } /* End of '~mapped_file' function */
+
+    /* Copying is not allowed */
+    mapped_file( const mapped_file & ) = delete;
+    mapped_file & operator=( const mapped_file & ) = delete;
+
+    /* Map file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     * RETURNS:
+     *   (BOOL) TRUE if file is mapped, FALSE overwise (empty files are not mapped).
+     */
+    BOOL Open( const CHAR *FileName )
+    {
+      Close();
+#ifdef _WIN32
+      LARGE_INTEGER FileSize;
+
+      File = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (File == INVALID_HANDLE_VALUE || !GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0 ||
+          (Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr ||
+          (Data = (const BYTE *)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)) == nullptr)
+      {
+        Close();
+        return FALSE;
+      }
+      Size = (size_t)FileSize.QuadPart;
+#else
+      struct stat St;
+      VOID *Map;
+
+      File = open(FileName, O_RDONLY);
+      if (File < 0 || fstat(File, &St) != 0 || St.st_size == 0 ||
+          (Map = mmap(nullptr, St.st_size, PROT_READ, MAP_SHARED, File, 0)) == MAP_FAILED)
+      {
+        Close();
+        return FALSE;
+      }
+      Data = (const BYTE *)Map;
+      Size = (size_t)St.st_size;
+#endif
+      return TRUE;
+    } /* End of 'Open' function */
+
+    /* Unmap file function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Close( VOID )
+    {
+#ifdef _WIN32
+      if (Data != nullptr)
+        UnmapViewOfFile(Data);
+      if (Mapping != nullptr)
+        CloseHandle(Mapping);
+      if (File != INVALID_HANDLE_VALUE)
+        CloseHandle(File);
+      File = INVALID_HANDLE_VALUE, Mapping = nullptr;
+#else
+      if (Data != nullptr)
+        munmap((VOID *)Data, Size);
+      if (File >= 0)
+        close(File);
+      File = -1;
+#endif
+      Data = nullptr, Size = 0;
+    } /* End of 'Close' function */
+
+    /* Get mapped data function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const BYTE *) file data, nullptr if file is not mapped.
+     */
+    const BYTE * GetData( VOID ) const
+    {
+      return Data;
+    } /* End of 'GetData' function */
+
+    /* Get mapped data size function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (size_t) file size in bytes.
+     */
+    size_t GetSize( VOID ) const
+    {
+      return Size;
+    } /* End of 'GetSize' function */
+  }; /* End of 'mapped_file' class */
+} /* end of 'dart' namespace */
+
+#endif // __mapped_file_h_
+
+/* END OF 'mapped_file.h' FILE */
@@ -0,0 +1,158 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : mtl_lib.h
+ * PURPOSE     : Raytracing project.
+ *               Surfaces materials library module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __mtl_lib_h_
+#define __mtl_lib_h_
+
+#include <string>
+#include <unordered_map>
+
+#include "rt/shapes/shade_def.h"
+
+namespace dart
+{
+  /* Surfaces materials library class.
+   * Materials are interned: name is looked up once when material is
+   * referenced first and then it is used by index.
+   */
+  class mtl_lib
+  {
+    stock<surface> Surfs;                       // Materials by index
+    stock<std::string> Names;                   // Materials names by index
+    std::unordered_map<std::string, INT> Index; // Materials indices by name
+
+  public:
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - add standard materials flag:
+     *       BOOL IsStandard;
+     */
+    mtl_lib( BOOL IsStandard = TRUE )
+    {
+      if (!IsStandard)
+        return;
+      Add("Black Plastic",   surface(vec3(0.0, 0.0, 0.0),              vec3(0.01, 0.01, 0.01),           vec3(0.5, 0.5, 0.5),                 0, 0, 32));
+      Add("Brass",           surface(vec3(0.329412,0.223529,0.027451), vec3(0.780392,0.568627,0.113725), vec3(0.992157,0.941176,0.807843),    0, 0, 27.8974));
+      Add("Bronze",          surface(vec3(0.2125,0.1275,0.054),        vec3(0.714,0.4284,0.18144),       vec3(0.393548,0.271906,0.166721),    0, 0, 25.6));
+      Add("Chrome",          surface(vec3(0.25, 0.25, 0.25),           vec3(0.4, 0.4, 0.4),              vec3(0.774597, 0.774597, 0.774597),  0, 0, 76.8));
+      Add("Copper",          surface(vec3(0.19125,0.0735,0.0225),      vec3(0.7038,0.27048,0.0828),      vec3(0.256777,0.137622,0.086014),    0, 0, 12.8));
+      Add("Gold",            surface(vec3(0.24725,0.1995,0.0745),      vec3(0.75164,0.60648,0.22648),    vec3(0.628281,0.555802,0.366065),    0, 0, 51.2));
+      Add("Peweter",         surface(vec3(0.10588,0.058824,0.113725),  vec3(0.427451,0.470588,0.541176), vec3(0.3333,0.3333,0.521569),        0, 0, 9.84615));
+      Add("Silver",          surface(vec3(0.19225,0.19225,0.19225),    vec3(0.50754,0.50754,0.50754),    vec3(0.508273,0.508273,0.508273),    0, 0, 51.2));
+      Add("Polished Silver", surface(vec3(0.23125,0.23125,0.23125),    vec3(0.2775,0.2775,0.2775),       vec3(0.773911,0.773911,0.773911),    0, 0, 89.6));
+      Add("Turquoise",       surface(vec3(0.1, 0.18725, 0.1745),       vec3(0.396, 0.74151, 0.69102),    vec3(0.297254, 0.30829, 0.306678),   0, 0, 12.8));
+      Add("Ruby",            surface(vec3(0.1745, 0.01175, 0.01175),   vec3(0.61424, 0.04136, 0.04136),  vec3(0.727811, 0.626959, 0.626959),  0.1, 0, 76.8));
+      Add("Polished Gold",   surface(vec3(0.24725, 0.2245, 0.0645),    vec3(0.34615, 0.3143, 0.0903),    vec3(0.797357, 0.723991, 0.208006),  0, 0, 83.2));
+      Add("Polished Bronze", surface(vec3(0.25, 0.148, 0.06475),       vec3(0.4, 0.2368, 0.1036),        vec3(0.774597, 0.458561, 0.200621),  0, 0, 76.8));
+      Add("Polished Copper", surface(vec3(0.2295, 0.08825, 0.0275),    vec3(0.5508, 0.2118, 0.066),      vec3(0.580594, 0.223257, 0.0695701), 0, 0, 51.2));
+      Add("Jade",            surface(vec3(0.135, 0.2225, 0.1575),      vec3(0.135, 0.2225, 0.1575),      vec3(0.316228, 0.316228, 0.316228),  0, 0, 12.8));
+      Add("Obsidian",        surface(vec3(0.05375, 0.05, 0.06625),     vec3(0.18275, 0.17, 0.22525),     vec3(0.332741, 0.328634, 0.346435),  0, 0, 38.4));
+      Add("Pearl",           surface(vec3(0.25, 0.20725, 0.20725),     vec3(1.0, 0.829, 0.829),          vec3(0.296648, 0.296648, 0.296648),  0, 0, 11.264));
+      Add("Emerald",         surface(vec3(0.0215, 0.1745, 0.0215),     vec3(0.07568, 0.61424, 0.07568),  vec3(0.633, 0.727811, 0.633),        0.005, 0, 76.8));
+      Add("Black Rubber",    surface(vec3(0.02, 0.02, 0.02),           vec3(0.01, 0.01, 0.01),           vec3(0.4, 0.4, 0.4),                 0, 0, 10.0));
+    } /* End of 'mtl_lib' function */
+
+    /* Add or replace material function.
+     * ARGUMENTS:
+     *   - material name:
+     *       const std::string &Name;
+     *   - reference at material:
+     *       const surface &Surf;
+     * RETURNS:
+     *   (INT) material index.
+     */
+    INT Add( const std::string &Name, const surface &Surf )
+    {
+      auto res = Index.insert({Name, (INT)Surfs.size()});
+
+      if (!res.second)
+      {
+        Surfs[res.first->second] = Surf;
+        return res.first->second;
+      }
+      Surfs.push_back(Surf);
+      Names.push_back(Name);
+      return res.first->second;
+    } /* End of 'Add' function */
+
+    /* Find material index by name function.
+     * ARGUMENTS:
+     *   - material name:
+     *       const std::string &Name;
+     * RETURNS:
+     *   (INT) material index, -1 if there is no such material.
+     */
+    INT Find( const std::string &Name ) const
+    {
+      auto it = Index.find(Name);
+
+      return it == Index.end() ? -1 : it->second;
+    } /* End of 'Find' function */
+
+    /* Get materials count function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) materials count.
+     */
+    INT Size( VOID ) const
+    {
+      return (INT)Surfs.size();
+    } /* End of 'Size' function */
+
+    /* Get material by index function.
+     * ARGUMENTS:
+     *   - material index:
+     *       INT Mtl;
+     * RETURNS:
+     *   (const surface &) material.
+     */
+    const surface & operator[]( INT Mtl ) const
+    {
+      return Surfs[Mtl];
+    } /* End of 'operator[]' function */
+
+    /* Get material by name function.
+     * ARGUMENTS:
+     *   - material name:
+     *       const CHAR *Name;
+     * RETURNS:
+     *   (const surface &) material, default one if there is no such material.
+     */
+    const surface & operator[]( const CHAR *Name ) const
+    {
+      static const surface Default;
+      INT Mtl = Find(Name);
+
+      return Mtl < 0 ? Default : Surfs[Mtl];
+    } /* End of 'operator[]' function */
+
+    /* Get material name function.
+     * ARGUMENTS:
+     *   - material index:
+     *       INT Mtl;
+     * RETURNS:
+     *   (const std::string &) material name.
+     */
+    const std::string & Name( INT Mtl ) const
+    {
+      return Names[Mtl];
+    } /* End of 'Name' function */
+  }; /* End of 'mtl_lib' class */
+} /* end of 'dart' namespace */
+
+#endif // __mtl_lib_h_
+
+/* END OF 'mtl_lib.h' FILE */
@@ -0,0 +1,84 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : parallel.h
+ * PURPOSE     : Raytracing project.
+ *               Parallel loops support module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __parallel_h_
+#define __parallel_h_
+
+#include <atomic>
+#include <thread>
+
+#include "def.h"
+
+namespace dart
+{
+  /* Get threads count of parallel loops started by current thread function.
+   * Threads which run several parallel loops at once (like animation
+   * frames workers) set their share of processor cores here.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT &) reference at threads count.
+   */
+  inline INT & ParallelThreads( VOID )
+  {
+    static thread_local INT Count = (INT)std::thread::hardware_concurrency();
+
+    return Count;
+  } /* End of 'ParallelThreads' function */
+
+  /* Run function for all chunks of range by 'ParallelThreads' threads function.
+   * Chunks are taken by threads one by one, so chunk boundaries (and
+   * per chunk results) do not depend on threads count.
+   * ARGUMENTS:
+   *   - range size:
+   *       INT Count;
+   *   - chunk size:
+   *       INT Chunk;
+   *   - function to call for chunk (with 'INT Start, INT End' arguments):
+   *       FuncType Func;
+   * RETURNS: None.
+   */
+  template <typename FuncType>
+    VOID ParallelFor( INT Count, INT Chunk, FuncType Func )
+    {
+      INT
+        NumChunks = (Count + Chunk - 1) / Chunk,
+        NumThreads = COM_MIN(ParallelThreads(), NumChunks);
+      std::atomic<INT> Next(0);
+      auto Work =
+        [&]( VOID )
+        {
+          for (INT c = Next++; c < NumChunks; c = Next++)
+            Func(c * Chunk, COM_MIN(Count, (c + 1) * Chunk));
+        };
+
+      if (NumThreads <= 1)
+      {
+        Work();
+        return;
+      }
+
+      stock<std::thread> Ths;
+      for (INT i = 1; i < NumThreads; i++)
+        Ths.push_back(std::thread(Work));
+      Work();
+      for (auto &th : Ths)
+        th.join();
+    } /* End of 'ParallelFor' function */
+} /* end of 'dart' namespace */
+
+#endif // __parallel_h_
+
+/* END OF 'parallel.h' FILE */
@@ -0,0 +1,97 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : path.h
+ * PURPOSE     : Raytracing project.
+ *               Ray path state and termination policy module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __path_h_
+#define __path_h_
+
+#include "def.h"
+
+namespace dart
+{
+  /* Ray path termination policy class */
+  class policy
+  {
+  public:
+    DBL MinWeight;      // Fixed weight cutoff (used without roulette)
+    BOOL IsRoulette;    // Russian roulette termination flag
+    DBL RouletteWeight; // Weight below which roulette is played
+    INT RouletteLevel;  // Recursion level from which roulette is played
+    INT MaxReflLevel;   // Maximum reflection (Kr) rays in path
+    INT MaxRefrLevel;   // Maximum refraction (Kt) rays in path
+
+    /* Class default constructor */
+    policy( VOID ) : MinWeight(.003921), IsRoulette(FALSE), RouletteWeight(.1), RouletteLevel(1),
+      MaxReflLevel(2), MaxRefrLevel(2)
+    {
+    } /* End of 'policy' function */
+  }; /* End of 'policy' class */
+
+  /* Ray path termination statistics class */
+  class path_stats
+  {
+  public:
+    INT64
+      Traced,   // Traced rays count
+      Depth,    // Rays cut by global recursion level
+      Material, // Rays cut by material depth cap
+      Refl,     // Rays cut by reflection budget
+      Refr,     // Rays cut by refraction budget
+      Weight,   // Rays cut by fixed weight cutoff
+      Roulette; // Rays killed by Russian roulette
+
+    /* Class default constructor */
+    path_stats( VOID ) : Traced(0), Depth(0), Material(0), Refl(0), Refr(0), Weight(0), Roulette(0)
+    {
+    } /* End of 'path_stats' function */
+
+    /* Add other statistics function.
+     * ARGUMENTS:
+     *   - reference at statistics to add:
+     *       const path_stats &S;
+     * RETURNS:
+     *   (path_stats &) self reference.
+     */
+    path_stats & operator+=( const path_stats &S )
+    {
+      Traced += S.Traced, Depth += S.Depth, Material += S.Material;
+      Refl += S.Refl, Refr += S.Refr, Weight += S.Weight, Roulette += S.Roulette;
+      return *this;
+    } /* End of 'operator+=' function */
+  }; /* End of 'path_stats' class */
+
+  /* Ray path tracing state class.
+   * One object is owned by every rendering pixel path, so
+   * recursion level and random sequence never leak between pixels.
+   */
+  class path
+  {
+  public:
+    rnd Rnd;              // Path random numbers generator
+    INT Level;            // Current recursion level
+    INT ReflLevel;        // Reflection rays in current path
+    INT RefrLevel;        // Refraction rays in current path
+    path_stats Stats;     // Termination statistics
+
+    /* Class default constructor */
+    path( VOID ) : Rnd(), Level(0), ReflLevel(0), RefrLevel(0), Stats()
+    {
+    } /* End of 'path' function */
+  }; /* End of 'path' class */
+} /* end of 'dart' namespace */
+
+#endif // __path_h_
+
+/* END OF 'path.h' FILE */
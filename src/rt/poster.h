@@ -0,0 +1,95 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : poster.h
+ * PURPOSE     : Raytracing project.
+ *               Big images rendering by rows bands module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __poster_h_
+#define __poster_h_
+
+#include "rt/scene.h"
+#include "rt/image_writer.h"
+
+namespace dart
+{
+  /* Big image renderer class.
+   * Image of any size is rendered by bands of tiles rows from top to
+   * bottom, every band is written to file as soon as it is completed,
+   * so memory is bounded by one band (image width by 'BandH' rows).
+   */
+  class poster
+  {
+  public:
+    INT W, H;  // Image size
+    INT BandH; // Band height in rows
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - image size:
+     *       INT Width, Height;
+     *   - band height in rows:
+     *       INT BandHeight;
+     */
+    poster( INT Width, INT Height, INT BandHeight = frame::TileSize * 4 ) :
+      W(Width), H(Height), BandH(BandHeight)
+    {
+    } /* End of 'poster' function */
+
+    /* Render image to file function.
+     * ARGUMENTS:
+     *   - reference at scene:
+     *       scene &Scene;
+     *   - reference at camera (it is resized to image size):
+     *       camera &Cam;
+     *   - file name (TGA, PPM or EXR by extension):
+     *       const CHAR *FileName;
+     * RETURNS:
+     *   (BOOL) TRUE if whole image is written, FALSE overwise.
+     */
+    BOOL Render( scene &Scene, camera &Cam, const CHAR *FileName )
+    {
+      image_writer Out;
+      stock<DWORD> Image;
+      frame Frm;
+
+      if (!Out.Open(FileName, W, H))
+        return FALSE;
+
+      Cam.Resize(W, H);
+      Frm.SetTiled(TRUE);
+      Scene.Timer.IsPause = TRUE;
+      Scene.IsReproject = FALSE;
+
+      for (INT org = 0; org < H; org += BandH)
+      {
+        INT rows = COM_MIN(BandH, H - org);
+
+        Frm.Resize(W, rows);
+        Frm.OrgY = org;
+        Image.resize(W * rows);
+        Frm.Image = Image.data();
+
+        // band is other view of the same camera
+        Scene.Invalidate(scene::CHANGED_CAMERA);
+        Scene.Render(Cam, Frm);
+        if (!Out.Write(Frm))
+          return FALSE;
+      }
+      return Out.Close();
+    } /* End of 'Render' function */
+  }; /* End of 'poster' class */
+} /* end of 'dart' namespace */
+
+#endif // __poster_h_
+
+/* END OF 'poster.h' FILE */
@@ -0,0 +1,198 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : ray_gen.h
+ * PURPOSE     : Raytracing project.
+ *               Primary rays generation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __ray_gen_h_
+#define __ray_gen_h_
+
+#include <emmintrin.h>
+
+#include "def.h"
+
+namespace dart
+{
+  /* Primary rays generator class.
+   * Camera basis is reduced once per frame to the direction of frame
+   * corner and steps between pixels, so ray of any sample costs two
+   * multiply-adds per component. Rays of a row are built as structure
+   * of arrays and normalized by pairs, they are bit-equal to 'Get' rays.
+   */
+  class ray_gen
+  {
+    vec3 Loc;          // Camera location
+    vec3 Corner;       // Direction to frame point (0, 0)
+    vec3 StepX, StepY; // Direction steps by one pixel
+    vec3 Center;       // Direction to frame center
+
+  public:
+    /* Rays block (structure of arrays) */
+    struct block
+    {
+      static const INT MaxCount = 64; // Maximum rays in block
+
+      alignas(16) DBL
+        Ox[MaxCount], Oy[MaxCount], Oz[MaxCount], // Origins
+        Dx[MaxCount], Dy[MaxCount], Dz[MaxCount]; // Normalized directions
+      INT Count;                                  // Rays count
+
+      /* Get ray by index function.
+       * ARGUMENTS:
+       *   - ray index:
+       *       INT I;
+       * RETURNS:
+       *   (ray) ray (direction is normalized already).
+       */
+      ray Get( INT I ) const
+      {
+        ray R;
+
+        R.Org = vec3(Ox[I], Oy[I], Oz[I]);
+        R.Dir = vec3(Dx[I], Dy[I], Dz[I]);
+        return R;
+      } /* End of 'Get' function */
+    }; /* End of 'block' structure */
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - reference at camera (it should be resized to frame):
+     *       const camera &Cam;
+     */
+    ray_gen( const camera &Cam ) :
+      Loc(Cam.Loc),
+      Corner(Cam.Dir * Cam.ProjDist - Cam.Right * (Cam.Wp * .5) + Cam.Up * (Cam.Hp * .5)),
+      StepX(Cam.Right * (Cam.Wp / Cam.Ws)),
+      StepY(Cam.Up * (-Cam.Hp / Cam.Hs)),
+      Center(Cam.Dir * Cam.ProjDist)
+    {
+    } /* End of 'ray_gen' function */
+
+    /* Get ray through frame point function.
+     * ARGUMENTS:
+     *   - frame point coordinates (in pixels):
+     *       DBL Xs, Ys;
+     *   - sub-pixel offsets (X and Y, nullptr for none):
+     *       const DBL *Jitter;
+     * RETURNS:
+     *   (ray) ray from camera.
+     */
+    ray Get( DBL Xs, DBL Ys, const DBL *Jitter = nullptr ) const
+    {
+      vec3 D = Jitter == nullptr ?
+        Corner + StepY * Ys + StepX * Xs :
+        Corner + StepY * Ys + StepY * Jitter[1] + StepX * (Xs + Jitter[0]);
+
+      return ray(Loc + D, D);
+    } /* End of 'Get' function */
+
+    /* Get rays of frame row function.
+     * ARGUMENTS:
+     *   - first frame point coordinates (in pixels):
+     *       DBL Xs, Ys;
+     *   - rays count (not more than 'block::MaxCount'):
+     *       INT Count;
+     *   - reference at block to fill:
+     *       block &Blk;
+     *   - sub-pixel offsets (X and Y by rays, nullptr for none):
+     *       const DBL *Jitter;
+     * RETURNS: None.
+     */
+    VOID Row( DBL Xs, DBL Ys, INT Count, block &Blk, const DBL *Jitter = nullptr ) const
+    {
+      vec3 Base = Corner + StepY * Ys;
+
+      Blk.Count = Count;
+      if (Jitter == nullptr)
+        for (INT i = 0; i < Count; i++)
+        {
+          DBL x = Xs + i;
+
+          Blk.Dx[i] = Base.X + StepX.X * x;
+          Blk.Dy[i] = Base.Y + StepX.Y * x;
+          Blk.Dz[i] = Base.Z + StepX.Z * x;
+        }
+      else
+        for (INT i = 0; i < Count; i++)
+        {
+          DBL x = Xs + i + Jitter[i * 2], y = Jitter[i * 2 + 1];
+
+          Blk.Dx[i] = Base.X + StepY.X * y + StepX.X * x;
+          Blk.Dy[i] = Base.Y + StepY.Y * y + StepX.Y * x;
+          Blk.Dz[i] = Base.Z + StepY.Z * y + StepX.Z * x;
+        }
+      if (Count % 2 != 0)
+        Blk.Dx[Count] = Blk.Dy[Count] = Blk.Dz[Count] = 0;
+
+      // the same rounding as 'vec3::Normalizing' (unit and zero vectors are kept)
+      __m128d
+        lx = _mm_set1_pd(Loc.X), ly = _mm_set1_pd(Loc.Y), lz = _mm_set1_pd(Loc.Z),
+        one = _mm_set1_pd(1), zero = _mm_setzero_pd();
+      for (INT i = 0; i < Count; i += 2)
+      {
+        __m128d
+          dx = _mm_load_pd(Blk.Dx + i), dy = _mm_load_pd(Blk.Dy + i), dz = _mm_load_pd(Blk.Dz + i),
+          len2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz)),
+          keep = _mm_or_pd(_mm_cmpeq_pd(len2, one), _mm_cmpeq_pd(len2, zero)),
+          len = _mm_or_pd(_mm_and_pd(keep, one), _mm_andnot_pd(keep, _mm_sqrt_pd(len2)));
+
+        _mm_store_pd(Blk.Ox + i, _mm_add_pd(lx, dx));
+        _mm_store_pd(Blk.Oy + i, _mm_add_pd(ly, dy));
+        _mm_store_pd(Blk.Oz + i, _mm_add_pd(lz, dz));
+        _mm_store_pd(Blk.Dx + i, _mm_div_pd(dx, len));
+        _mm_store_pd(Blk.Dy + i, _mm_div_pd(dy, len));
+        _mm_store_pd(Blk.Dz + i, _mm_div_pd(dz, len));
+      }
+    } /* End of 'Row' function */
+
+    /* Get primary ray differentials function.
+     * Rays start at frame points, so origins change by pixel steps.
+     * Direction to frame point is D * s with the same projection to
+     * frame center direction, differentials of normalized direction
+     * are the steps without their part along D divided by s.
+     * ARGUMENTS:
+     *   - reference at primary ray normalized direction:
+     *       const vec3 &D;
+     * RETURNS:
+     *   (ray_diff) ray differentials.
+     */
+    ray_diff Diff( const vec3 &D ) const
+    {
+      DBL dc = D & Center, inv = dc > 0 ? dc / (Center & Center) : 0;
+
+      return ray_diff(StepX, StepY, (StepX - D * (D & StepX)) * inv, (StepY - D * (D & StepY)) * inv);
+    } /* End of 'Diff' function */
+
+    /* Get sample offsets inside pixel function.
+     * Offsets do not depend on rays path random numbers of the same sample.
+     * ARGUMENTS:
+     *   - pixel coordinates and pass number:
+     *       INT X, Y, Pass;
+     *   - offsets to fill (X and Y from -0.5 to 0.5):
+     *       DBL *Offs;
+     * RETURNS: None.
+     */
+    static VOID Jitter( INT X, INT Y, INT Pass, DBL *Offs )
+    {
+      rnd r;
+
+      r.Seed(X, Y, ~(UINT64)Pass);
+      Offs[0] = r() - .5;
+      Offs[1] = r() - .5;
+    } /* End of 'Jitter' function */
+  }; /* End of 'ray_gen' class */
+} /* end of 'dart' namespace */
+
+#endif // __ray_gen_h_
+
+/* END OF 'ray_gen.h' FILE */
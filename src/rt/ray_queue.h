@@ -0,0 +1,268 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : ray_queue.h
+ * PURPOSE     : Raytracing project.
+ *               Coherent rays generation and shadow rays batches module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __ray_queue_h_
+#define __ray_queue_h_
+
+#include "rt/shapes/shape_def.h"
+
+namespace dart
+{
+  /* Queued ray path state class */
+  class ray_state
+  {
+  public:
+    envi Media;   // Ray environment
+    DBL Weight;   // Ray weight
+    vec3 Factor;  // Multiplier of ray color in pixel color
+    INT Pixel;    // Frame pixel index
+    INT Level, ReflLevel, RefrLevel; // Path levels at ray start
+    rnd Rnd;      // Path random numbers generator
+    ray_diff Diff; // Ray differentials by frame pixel steps
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - reference at ray environment:
+     *       const envi &RayMedia;
+     *   - ray weight:
+     *       DBL RayWeight;
+     *   - reference at ray color multiplier:
+     *       const vec3 &RayFactor;
+     *   - frame pixel index:
+     *       INT PixelIndex;
+     *   - path levels:
+     *       INT PathLevel, PathReflLevel, PathRefrLevel;
+     *   - reference at path random numbers generator:
+     *       const rnd &PathRnd;
+     *   - reference at ray differentials:
+     *       const ray_diff &RayDiff;
+     */
+    ray_state( const envi &RayMedia, DBL RayWeight, const vec3 &RayFactor, INT PixelIndex,
+               INT PathLevel, INT PathReflLevel, INT PathRefrLevel, const rnd &PathRnd, const ray_diff &RayDiff ) :
+      Media(RayMedia), Weight(RayWeight), Factor(RayFactor), Pixel(PixelIndex),
+      Level(PathLevel), ReflLevel(PathReflLevel), RefrLevel(PathRefrLevel), Rnd(PathRnd), Diff(RayDiff)
+    {
+    } /* End of 'ray_state' function */
+  }; /* End of 'ray_state' class */
+
+  /* Rays generation queue class.
+   * Holds all rays of one bounce generation as structure of arrays,
+   * so every pipeline stage touches only the fields it needs. Before
+   * tracing rays are sorted by direction octant and origin cell
+   * (Morton order of grid over scene bound box), so neighbour rays
+   * in queue walk through the same tree nodes and hit the same shapes.
+   */
+  class ray_queue
+  {
+    stock<UINT64> Keys, TmpKeys; // Sort keys with rays indices in low 32 bits
+
+    /* Spread 9 bits of integer to every third bit function.
+     * ARGUMENTS:
+     *   - integer to spread:
+     *       UINT64 V;
+     * RETURNS:
+     *   (UINT64) spread bits.
+     */
+    static UINT64 Spread( UINT64 V )
+    {
+      V &= 0x1FF;
+      V = (V | (V << 16)) & 0x030000FF;
+      V = (V | (V << 8)) & 0x0300F00F;
+      V = (V | (V << 4)) & 0x030C30C3;
+      V = (V | (V << 2)) & 0x09249249;
+      return V;
+    } /* End of 'Spread' function */
+
+    /* Reorder array by sorted keys function.
+     * ARGUMENTS:
+     *   - reference at array to reorder:
+     *       stock<Type> &A;
+     * RETURNS: None.
+     */
+    template <typename Type>
+      VOID Permute( stock<Type> &A )
+      {
+        stock<Type> tmp;
+
+        tmp.resize(A.size());
+        for (size_t i = 0; i < Keys.size(); i++)
+          tmp[i] = A[(INT)(Keys[i] & 0xFFFFFFFF)];
+        A.swap(tmp);
+      } /* End of 'Permute' function */
+
+  public:
+    stock<ray> Rays;       // Rays
+    stock<envi> Media;     // Rays environments
+    stock<DBL> Weight;     // Rays weights
+    stock<vec3> Factor;    // Multipliers of rays colors in pixel colors
+    stock<INT>
+      Pixel,               // Frame pixels indices
+      Level,               // Path recursion levels at ray start
+      ReflLevel,           // Path reflection levels at ray start
+      RefrLevel;           // Path refraction levels at ray start
+    stock<rnd> Rnd;        // Path random numbers generators
+    stock<ray_diff> Diff;  // Rays differentials
+
+    /* Remove all rays function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Clear( VOID )
+    {
+      Resize(0);
+    } /* End of 'Clear' function */
+
+    /* Get queued rays count function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) rays count.
+     */
+    INT Size( VOID ) const
+    {
+      return (INT)Rays.size();
+    } /* End of 'Size' function */
+
+    /* Change rays count function.
+     * ARGUMENTS:
+     *   - new rays count:
+     *       INT N;
+     * RETURNS: None.
+     */
+    VOID Resize( INT N )
+    {
+      Rays.resize(N), Media.resize(N), Weight.resize(N), Factor.resize(N);
+      Pixel.resize(N), Level.resize(N), ReflLevel.resize(N), RefrLevel.resize(N), Rnd.resize(N), Diff.resize(N);
+    } /* End of 'Resize' function */
+
+    /* Set ray function.
+     * ARGUMENTS:
+     *   - ray index:
+     *       INT I;
+     *   - reference at ray:
+     *       const ray &R;
+     *   - reference at ray path state:
+     *       const ray_state &State;
+     * RETURNS: None.
+     */
+    VOID Set( INT I, const ray &R, const ray_state &State )
+    {
+      Rays[I] = R, Media[I] = State.Media, Weight[I] = State.Weight, Factor[I] = State.Factor;
+      Pixel[I] = State.Pixel, Level[I] = State.Level, ReflLevel[I] = State.ReflLevel, RefrLevel[I] = State.RefrLevel;
+      Rnd[I] = State.Rnd, Diff[I] = State.Diff;
+    } /* End of 'Set' function */
+
+    /* Get ray path state function.
+     * ARGUMENTS:
+     *   - ray index:
+     *       INT I;
+     * RETURNS:
+     *   (ray_state) ray path state.
+     */
+    ray_state Get( INT I ) const
+    {
+      return ray_state(Media[I], Weight[I], Factor[I], Pixel[I], Level[I], ReflLevel[I], RefrLevel[I], Rnd[I], Diff[I]);
+    } /* End of 'Get' function */
+
+    /* Add ray to queue function.
+     * ARGUMENTS:
+     *   - reference at ray:
+     *       const ray &R;
+     *   - reference at ray path state:
+     *       const ray_state &State;
+     * RETURNS: None.
+     */
+    VOID Push( const ray &R, const ray_state &State )
+    {
+      INT n = Size();
+
+      Resize(n + 1);
+      Set(n, R, State);
+    } /* End of 'Push' function */
+
+    /* Sort rays for coherent tracing function.
+     * ARGUMENTS:
+     *   - references at scene bound box corners:
+     *       const vec3 &Min, &Max;
+     * RETURNS: None.
+     */
+    VOID Sort( const vec3 &Min, const vec3 &Max )
+    {
+      INT n = Size();
+      vec3 Ext = Max - Min;
+      DBL
+        sx = Ext.X > Threshold ? 511 / Ext.X : 0,
+        sy = Ext.Y > Threshold ? 511 / Ext.Y : 0,
+        sz = Ext.Z > Threshold ? 511 / Ext.Z : 0;
+
+      // 30-bit key: direction octant, then Morton code of 512^3 origin grid
+      Keys.resize(n);
+      TmpKeys.resize(n);
+      for (INT i = 0; i < n; i++)
+      {
+        const ray &R = Rays[i];
+        UINT64
+          octant = (R.Dir.X < 0) | (R.Dir.Y < 0) << 1 | (R.Dir.Z < 0) << 2,
+          cx = (UINT64)COM_MIN(COM_MAX((R.Org.X - Min.X) * sx, 0), 511),
+          cy = (UINT64)COM_MIN(COM_MAX((R.Org.Y - Min.Y) * sy, 0), 511),
+          cz = (UINT64)COM_MIN(COM_MAX((R.Org.Z - Min.Z) * sz, 0), 511);
+
+        Keys[i] = (octant << 27 | Spread(cx) | Spread(cy) << 1 | Spread(cz) << 2) << 32 | (UINT64)i;
+      }
+
+      // stable radix sort by three 10-bit digits
+      for (INT shift = 32; shift < 62; shift += 10)
+      {
+        INT Count[1025] = {0};
+
+        for (INT i = 0; i < n; i++)
+          Count[((Keys[i] >> shift) & 0x3FF) + 1]++;
+        for (INT d = 0; d < 1024; d++)
+          Count[d + 1] += Count[d];
+        for (INT i = 0; i < n; i++)
+          TmpKeys[Count[(Keys[i] >> shift) & 0x3FF]++] = Keys[i];
+        Keys.swap(TmpKeys);
+      }
+
+      Permute(Rays), Permute(Media), Permute(Weight), Permute(Factor);
+      Permute(Pixel), Permute(Level), Permute(ReflLevel), Permute(RefrLevel), Permute(Rnd), Permute(Diff);
+    } /* End of 'Sort' function */
+  }; /* End of 'ray_queue' class */
+
+  /* Shadow rays batch class (structure of arrays) */
+  class shadow_batch
+  {
+  public:
+    stock<ray> Rays;        // Rays from shading points to light sources
+    stock<DBL> Dist;        // Distances to light sources
+    stock<vec3> Color;      // Light contributions if not shadowed
+    stock<BYTE> IsOccluded; // Occlusion test results
+
+    /* Change rays count function.
+     * ARGUMENTS:
+     *   - new rays count:
+     *       INT N;
+     * RETURNS: None.
+     */
+    VOID Resize( INT N )
+    {
+      Rays.resize(N), Dist.resize(N), Color.resize(N), IsOccluded.resize(N);
+    } /* End of 'Resize' function */
+  }; /* End of 'shadow_batch' class */
+} /* end of 'dart' namespace */
+
+#endif // __ray_queue_h_
+
+/* END OF 'ray_queue.h' FILE */
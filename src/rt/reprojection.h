@@ -0,0 +1,224 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : reprojection.h
+ * PURPOSE     : Raytracing project.
+ *               Temporal reprojection cache module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __reprojection_h_
+#define __reprojection_h_
+
+#include <cmath>
+#include <cstring>
+
+#include "rt/shapes/shape_def.h"
+#include "rt/frame.h"
+
+namespace dart
+{
+  /* Temporal reprojection cache class.
+   * Keeps shaded primary hits of previous frame (world points and
+   * colors) and moves them to the new view by its 'VxP' matrix. Only
+   * pixels not covered by old hits (disocclusions, frame borders,
+   * background) and pixels of rolling refresh pattern are traced again.
+   * Pixels are indexed in frame colors layout (see 'frame::Index').
+   */
+  class reprojection
+  {
+    INT W, H;                 // Cached frame size
+    BOOL IsTiled;             // Cached frame layout
+    INT Frame;                // Reprojected frames counter (for refresh pattern)
+    stock<vec3> Pos, Color;   // Cached hit points and shaded colors
+    stock<INT> Age;           // Frames since pixel was traced (-1 for no hit)
+    stock<vec3> NewPos, NewColor; // Reprojected frame hit points and colors
+    stock<INT> NewAge;        // Reprojected frame ages
+    stock<DBL> Depth;         // Reprojected frame view depths
+
+  public:
+    INT RefreshPeriod; // Every pixel is retraced once in this frames count
+    INT MaxAge;        // Maximum frames count of reprojected pixel life
+
+    /* Class default constructor */
+    reprojection( VOID ) : W(0), H(0), IsTiled(FALSE), Frame(0), RefreshPeriod(8), MaxAge(16)
+    {
+    } /* End of 'reprojection' function */
+
+    /* Check if cache holds frame of specified size and layout function.
+     * ARGUMENTS:
+     *   - reference at frame:
+     *       const frame &Frm;
+     * RETURNS:
+     *   (BOOL) TRUE if cached frame can be reprojected, FALSE overwise.
+     */
+    BOOL IsValid( const frame &Frm ) const
+    {
+      return W == Frm.W && H == Frm.H && IsTiled == Frm.IsTiled && W * H > 0;
+    } /* End of 'IsValid' function */
+
+    /* Forget cached frame function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Invalidate( VOID )
+    {
+      W = H = 0;
+    } /* End of 'Invalidate' function */
+
+    /* Get cached pixel color function.
+     * ARGUMENTS:
+     *   - pixel index:
+     *       INT I;
+     * RETURNS:
+     *   (const vec3 &) pixel color.
+     */
+    const vec3 & operator[]( INT I ) const
+    {
+      return Color[I];
+    } /* End of 'operator[]' function */
+
+    /* Move cached frame to new view function.
+     * ARGUMENTS:
+     *   - reference at new camera:
+     *       const camera &Cam;
+     *   - reference at frame:
+     *       const frame &Frm;
+     *   - pointer at flags of pixels to trace ('Frm.Size()' bytes):
+     *       BYTE *IsTrace;
+     * RETURNS:
+     *   (INT) pixels to trace count.
+     */
+    INT Reproject( const camera &Cam, const frame &Frm, BYTE *IsTrace )
+    {
+      const matr &M = Cam.VxP;
+      INT n = Frm.Size(), count = 0;
+
+      NewPos.resize(n);
+      NewColor.resize(n);
+      NewAge.assign(n, -1);
+      Depth.assign(n, 0);
+
+      // splat old hits to new frame, the nearest one wins
+      for (INT i = 0; i < n; i++)
+      {
+        if (Age[i] < 0)
+          continue;
+
+        const vec3 &P = Pos[i];
+        DBL
+          w = P.X * M.M[0][3] + P.Y * M.M[1][3] + P.Z * M.M[2][3] + M.M[3][3],
+          x = (P.X * M.M[0][0] + P.Y * M.M[1][0] + P.Z * M.M[2][0] + M.M[3][0]) / w,
+          y = (P.X * M.M[0][1] + P.Y * M.M[1][1] + P.Z * M.M[2][1] + M.M[3][1]) / w;
+
+        // point is behind projection plane
+        if (w < Cam.ProjDist)
+          continue;
+
+        // pixel (X, Y) is sampled at (X + 0.5, Y - 0.5) by 'ray_gen'
+        INT
+          X = (INT)floor((x + 1) * W * .5),
+          Y = (INT)floor((y + 1) * H * .5) + 1;
+
+        if (X < 0 || X >= W || Y < 0 || Y >= H)
+          continue;
+
+        INT j = Frm.Index(X, Y);
+
+        if (NewAge[j] < 0 || w < Depth[j])
+        {
+          NewPos[j] = P;
+          NewColor[j] = Color[i];
+          NewAge[j] = Age[i] + 1;
+          Depth[j] = w;
+        }
+      }
+      Pos.swap(NewPos);
+      Color.swap(NewColor);
+      Age.swap(NewAge);
+
+      // close one pixel cracks between neighbours of the same surface
+      for (INT Y = 1; Y < H - 1; Y++)
+        for (INT X = 1; X < W - 1; X++)
+        {
+          INT i = Frm.Index(X, Y);
+
+          if (Age[i] >= 0)
+            continue;
+          for (INT d = 0; d < 2; d++)
+          {
+            INT
+              a = d == 0 ? Frm.Index(X - 1, Y) : Frm.Index(X, Y - 1),
+              b = d == 0 ? Frm.Index(X + 1, Y) : Frm.Index(X, Y + 1);
+
+            if (Age[a] >= 0 && Age[b] >= 0 && Age[a] < MaxAge && Age[b] < MaxAge &&
+                fabs(Depth[a] - Depth[b]) < .02 * Depth[a])
+            {
+              Pos[i] = (Pos[a] + Pos[b]) * .5;
+              Color[i] = (Color[a] + Color[b]) * .5;
+              Age[i] = MaxAge - 1;
+              break;
+            }
+          }
+        }
+
+      // holes, too old pixels and rolling refresh pattern are traced
+      Frame++;
+      memset(IsTrace, 0, n);
+      for (INT Y = 0; Y < H; Y++)
+        for (INT X = 0; X < W; X++)
+        {
+          INT i = Frm.Index(X, Y);
+
+          IsTrace[i] = Age[i] < 0 || Age[i] >= MaxAge || (X + Y * 3 + Frame) % RefreshPeriod == 0;
+          count += IsTrace[i];
+        }
+      return count;
+    } /* End of 'Reproject' function */
+
+    /* Store traced pixels of frame function.
+     * ARGUMENTS:
+     *   - reference at frame:
+     *       const frame &Frm;
+     *   - primary hits array:
+     *       const intr *Hits;
+     *   - accumulated colors array:
+     *       const vec3 *Accum;
+     *   - accumulated frames count:
+     *       INT AccumCount;
+     *   - flags of traced pixels (nullptr if all pixels are traced):
+     *       const BYTE *IsTraced;
+     * RETURNS: None.
+     */
+    VOID Store( const frame &Frm, const intr *Hits, const vec3 *Accum, INT AccumCount, const BYTE *IsTraced )
+    {
+      INT n = Frm.Size();
+
+      if (!IsValid(Frm))
+      {
+        W = Frm.W, H = Frm.H, IsTiled = Frm.IsTiled;
+        Pos.resize(n);
+        Color.resize(n);
+        Age.resize(n);
+      }
+      for (INT i = 0; i < n; i++)
+        if (IsTraced == nullptr || IsTraced[i])
+        {
+          Pos[i] = Hits[i].P;
+          Color[i] = Accum[i] / AccumCount;
+          Age[i] = Hits[i].Shp != nullptr ? 0 : -1;
+        }
+    } /* End of 'Store' function */
+  }; /* End of 'reprojection' class */
+} /* end of 'dart' namespace */
+
+#endif // __reprojection_h_
+
+/* END OF 'reprojection.h' FILE */
@@ -8,7 +8,7 @@
  *               Window base class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 23.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -17,15 +17,70 @@
 #ifndef __rt_win_h_
 #define __rt_win_h_
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include "win/win.h"
 #include "rt/timer.h"
 #include "rt/scene.h"
+#include "rt/swap_chain.h"
+#include "rt/image_saver.h"
 
 namespace dart
 {
-  /* Ray trayccing scene window handle class */
+  /* Ray trayccing scene window handle class.
+   * Scene is rendered by separate thread to back buffer of swap chain,
+   * window thread only shows last completed image and posts changes
+   * to rendering thread, so input never waits for long frames.
+   */
   class rt : public win
   {
+    /* Presented frame information (for window title) */
+    struct frame_info
+    {
+      DBL FPS;          // Rendering frames per second
+      path_stats Stats; // Frame path termination statistics
+      BOOL IsWavefront, IsReproject, IsRoulette; // Rendering modes
+    };
+
+    swap_chain<frame_info> Chain; // Presented images
+    image_saver Saver;            // Saved images encoder
+    std::thread RenderTh;         // Rendering thread
+    std::atomic<BOOL> IsDone;     // Stop rendering thread flag
+
+    std::mutex CommandsMutex;            // Posted commands lock
+    std::condition_variable CommandsCV;  // Posted commands signal
+    stock<std::function<VOID( VOID )>> Commands; // Commands to run before next frame
+
+    std::string WatchName;  // Watched scene description file name (empty if none)
+    time_t WatchTime;       // Watched file modification time
+    DBL WatchCheckTime;     // Last watched file check time (in seconds)
+    camera WatchCam;        // Camera of last loaded description
+    std::string WatchError; // Last reload error message
+
+    /* Reload watched scene description if it is changed function.
+     * Window thread parses file to new scene and posts merging it.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID CheckWatched( VOID );
+
+    /* Rendering thread function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID RenderThread( VOID );
+
+    /* Publish rendered frame (rendering thread side) function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Present( VOID );
+
   public:
     /* Class default constructor.
      * ARGUMENTS:
@@ -47,15 +102,45 @@ namespace dart
     dart::scene Scene;   // Ray tracing scene
     dart::camera Camera; // Scene camera
 
+    /* Post command to rendering thread function.
+     * Frame, camera and scene are owned by rendering thread after 'Run'
+     * is called, so window thread changes them by commands only.
+     * Commands are run before next frame.
+     * ARGUMENTS:
+     *   - command to run:
+     *       const std::function<VOID( VOID )> &Cmd;
+     *   - cancel frame in progress flag (if command changes view):
+     *       BOOL IsCancel;
+     * RETURNS: None.
+     */
+    VOID Post( const std::function<VOID( VOID )> &Cmd, BOOL IsCancel = FALSE );
+
+    /* Watch scene description file function.
+     * Scene should be loaded from the file, it is reloaded when file
+     * is saved (changes are merged to scene, see 'scene::Merge').
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at camera set by file:
+     *       const camera &Cam;
+     * RETURNS: None.
+     */
+    VOID Watch( const CHAR *FileName, const camera &Cam );
+
     /* Resize scene function.
-     * ARGUMENTS: None.
+     * ARGUMENTS:
+     *   - new frame size:
+     *       INT NewW, NewH;
      * RETURNS: None.
      */
     VOID Resize( INT NewW, INT NewH )
     {
-      Frame.Resize(NewW, NewH);
-      Camera.Resize(NewW, NewH);
-      InvalidateRect(hWnd, nullptr, FALSE);
+      Post(
+        [this, NewW, NewH]( VOID )
+        {
+          Frame.Resize(NewW, NewH);
+          Camera.Resize(NewW, NewH);
+        }, TRUE);
     } /* End of 'Resize' function */
 
   private:
@@ -8,15 +8,22 @@
  *               rt_window functions implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 25.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
  * Computer Graphics Support Group of 30 Phys-Math Lyceum
  */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <thread>
 
+#include <sys/stat.h>
+
 #include "rt/rt.h"
+#include "rt/scene_file.h"
 #include "rt/shapes/sphere.h"
 #include "rt/shapes/plane.h"
 #include "rt/shapes/cylinder.h"
@@ -27,7 +34,8 @@
  *   - application instance handle
  *       HINSTANCE hInst;
  */
-dart::rt::rt( HINSTANCE hInst ) : win(hInst), Frame(600, 400), Camera(), Scene()
+dart::rt::rt( HINSTANCE hInst ) : win(hInst), Chain(), RenderTh(), IsDone(FALSE), Commands(),
+  WatchName(), WatchTime(0), WatchCheckTime(0), WatchCam(), WatchError(), Frame(600, 400), Camera(), Scene()
 {
   hWnd = CreateWindow("RT window class name", "DB6's window",
     WS_OVERLAPPEDWINDOW | WS_VISIBLE | WS_HSCROLL | WS_VSCROLL,
@@ -67,29 +75,174 @@ VOID dart::rt::Run( VOID )
 {
   MSG msg;
 
-///  std::thread WinTh(
-///    [&msg]( VOID )
-///    {
-      while (TRUE)
-      {
-        /* Check message at window message queue */
-        if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
-          if (msg.message == WM_QUIT)
-            break;
-          else
-          {
-           /* Displatch message to window */
-           TranslateMessage(&msg);
-           DispatchMessage(&msg);
-          }
-        else
+  // scene is filled by now, so it is given to rendering thread
+  RenderTh = std::thread(
+    [this]( VOID )
+    {
+      RenderThread();
+    });
+
+  // window thread only waits for messages, idle time belongs to rendering
+  while (GetMessage(&msg, nullptr, 0, 0))
+  {
+    /* Displatch message to window */
+    TranslateMessage(&msg);
+    DispatchMessage(&msg);
+  }
+
+  IsDone = TRUE;
+  CommandsCV.notify_one();
+  RenderTh.join();
+} /* End of 'dart::rt::Run' function */
+
+/* Rendering thread function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID dart::rt::RenderThread( VOID )
+{
+  stock<std::function<VOID( VOID )>> cmds;
+
+  while (!IsDone)
+  {
+    // take window changes, they are older than any cancel request
+    {
+      std::lock_guard<std::mutex> Lock(CommandsMutex);
+
+      cmds.swap(Commands);
+      Scene.IsCancel = FALSE;
+    }
+    for (auto &cmd : cmds)
+      cmd();
+    cmds.clear();
+
+    Scene.Timer.Response();
+    Frame.Image = Chain.GetBack(Frame.W, Frame.H);
+    if (Scene.Render(Camera, Frame))
+      Present();
+    else if (!Scene.IsCancel)
+    {
+      // frame is final, sleep until something is changed
+      std::unique_lock<std::mutex> Lock(CommandsMutex);
+
+      CommandsCV.wait_for(Lock, std::chrono::milliseconds(30),
+        [this]( VOID )
         {
- 
-        /* Idle */
-        }
+          return IsDone || !Commands.empty();
+        });
+    }
+  }
+} /* End of 'dart::rt::RenderThread' function */
+
+/* Publish rendered frame (rendering thread side) function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID dart::rt::Present( VOID )
+{
+  frame_info Info;
+
+  Info.FPS = Scene.Timer.FPS;
+  Info.Stats = Scene.Stats;
+  Info.IsWavefront = Scene.IsWavefront;
+  Info.IsReproject = Scene.IsReproject;
+  Info.IsRoulette = Scene.Policy.IsRoulette;
+  Chain.Present(Info);
+} /* End of 'dart::rt::Present' function */
+
+/* Post command to rendering thread function.
+ * ARGUMENTS:
+ *   - command to run:
+ *       const std::function<VOID( VOID )> &Cmd;
+ *   - cancel frame in progress flag (if command changes view):
+ *       BOOL IsCancel;
+ * RETURNS: None.
+ */
+VOID dart::rt::Post( const std::function<VOID( VOID )> &Cmd, BOOL IsCancel )
+{
+  std::lock_guard<std::mutex> Lock(CommandsMutex);
+
+  Commands.push_back(Cmd);
+  if (IsCancel)
+    Scene.IsCancel = TRUE;
+  CommandsCV.notify_one();
+} /* End of 'dart::rt::Post' function */
+
+/* Get file modification time function.
+ * ARGUMENTS:
+ *   - file name:
+ *       const CHAR *FileName;
+ * RETURNS:
+ *   (time_t) modification time, 0 if file is not found.
+ */
+static time_t GetModifyTime( const CHAR *FileName )
+{
+  struct stat St;
+
+  return stat(FileName, &St) == 0 ? St.st_mtime : 0;
+} /* End of 'GetModifyTime' function */
+
+/* Watch scene description file function.
+ * ARGUMENTS:
+ *   - file name:
+ *       const CHAR *FileName;
+ *   - reference at camera set by file:
+ *       const camera &Cam;
+ * RETURNS: None.
+ */
+VOID dart::rt::Watch( const CHAR *FileName, const camera &Cam )
+{
+  WatchName = FileName;
+  WatchTime = GetModifyTime(FileName);
+  WatchCam = Cam;
+} /* End of 'dart::rt::Watch' function */
+
+/* Reload watched scene description if it is changed function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID dart::rt::CheckWatched( VOID )
+{
+  DBL Now = std::chrono::duration<DBL>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  if (WatchName.empty() || Now - WatchCheckTime < .3)
+    return;
+  WatchCheckTime = Now;
+
+  time_t Time = GetModifyTime(WatchName.c_str());
+
+  if (Time == 0 || Time == WatchTime)
+    return;
+  WatchTime = Time;
+
+  // new description is parsed here, rendering thread only merges it
+  std::shared_ptr<scene> Src = std::make_shared<scene>();
+  camera Cam = WatchCam;
+  scene_file Loader;
+
+  if (!Loader.Load(WatchName.c_str(), *Src, Cam))
+  {
+    WatchError = Loader.Error;
+    return;
+  }
+  WatchError.clear();
+
+  // camera is moved only if file camera is changed ('Set' keeps up-vector with opposite sign)
+  BOOL IsCamera = Src->Timer.IsPause &&
+    (Cam.Loc.Distance(WatchCam.Loc) != 0 || Cam.At.Distance(WatchCam.At) != 0 || Cam.Up.Distance(WatchCam.Up) != 0);
+
+  WatchCam = Cam;
+  Post(
+    [this, Src, Cam, IsCamera]( VOID )
+    {
+      Scene.Merge(*Src);
+      if (IsCamera)
+      {
+        Camera.Set(Cam.Loc, Cam.At, -Cam.Up);
+        Scene.Timer.IsPause = TRUE;
       }
-///    });
-} /* End of 'dart::rt::Run' function */
+    }, TRUE);
+} /* End of 'dart::rt::CheckWatched' function */
 
 /* WM_CREATE window message handle function.
  * ARGUMENTS:
@@ -100,13 +253,6 @@ VOID dart::rt::Run( VOID )
  */
 BOOL dart::rt::OnCreate( CREATESTRUCT *CS )
 {
-  HDC hDC = GetDC(hWnd);
-  Frame.hMemDC = CreateCompatibleDC(hDC);
-  Frame.CreateDIB(hDC);
-  BitBlt(hDC, W / 2 - Frame.W / 2, H / 2 - Frame.H / 2,
-    W / 2 + Frame.W / 2, H / 2 + Frame.H / 2, Frame.hMemDC, 0, 0, SRCCOPY);
-  ReleaseDC(hWnd, hDC);
-
   SetTimer(hWnd, 47, 0, nullptr);
   return TRUE;
 } /* End of 'dart::rt_win::OnCreate' function */
@@ -117,8 +263,6 @@ BOOL dart::rt::OnCreate( CREATESTRUCT *CS )
  */
 VOID dart::rt::OnDestroy( VOID )
 {
-  ReleaseDC(hWnd, Frame.hMemDC);
-  DeleteObject(Frame.hBm);
   KillTimer(hWnd, 47);
   PostQuitMessage(47);
 } /* End of 'dart::rt_win::OnDestroy' function */
@@ -133,10 +277,7 @@ VOID dart::rt::OnDestroy( VOID )
  */
 VOID dart::rt::OnSize( UINT State, INT W, INT H )
 {
-  HDC hDC = GetDC(hWnd);
-  //Frame.Resize(W, H);
-  Frame.CreateDIB(hDC);
-  ReleaseDC(hWnd, hDC);
+  // last image is kept by swap chain, it is centered again only
   InvalidateRect(hWnd, nullptr, FALSE);
 } /* End of 'dart::rt_win::OnSize' function */
 
@@ -162,9 +303,7 @@ BOOL dart::rt::OnEraseBkgnd( HDC hDC )
  */
 VOID dart::rt::OnPaint( HDC hDC, PAINTSTRUCT *PS )
 {
-  Scene.Render(Camera, Frame);
-  BitBlt(hDC, W / 2 - Frame.W / 2, H / 2 - Frame.H / 2,
-    W / 2 + Frame.W / 2, H / 2 + Frame.H / 2, Frame.hMemDC, 0, 0, SRCCOPY);
+  Chain.Draw(hDC, W, H);
 } /* End of 'dart::rt_win::OnPaint' function */
 
 /* WM_TIMER window message handle function.
@@ -175,9 +314,24 @@ VOID dart::rt::OnPaint( HDC hDC, PAINTSTRUCT *PS )
  */
 VOID dart::rt::OnTimer( INT Id )
 {
-  Scene.Timer.Response();
+  CheckWatched();
+
+  // repaint only if rendering thread has completed new frame
+  if (!Chain.Acquire())
+    return;
   InvalidateRect(hWnd, nullptr, FALSE);
-  UpdateWindow(hWnd);
+
+  // report rays saved by each termination policy
+  static CHAR Buf[300];
+  const frame_info &I = Chain.GetFront().Info;
+  const path_stats &S = I.Stats;
+  sprintf(Buf, "DB6's window | FPS: %.2f%s%s | rays: %lld | saved by depth: %lld, material: %lld, "
+    "refl: %lld, refr: %lld, weight: %lld, roulette%s: %lld",
+    I.FPS, I.IsWavefront ? " (wavefront)" : "", I.IsReproject ? " (reprojection)" : "", S.Traced, S.Depth, S.Material, S.Refl, S.Refr, S.Weight,
+    I.IsRoulette ? "" : " (off)", S.Roulette);
+  if (!WatchError.empty())
+    strncat(Buf, (" | " + WatchError).c_str(), sizeof(Buf) - strlen(Buf) - 1);
+  SetWindowText(hWnd, Buf);
 } /* End of 'dart::rt::OnTimer' function */
 
 /* WM_HSCROLL message handle function.
@@ -234,21 +388,91 @@ VOID dart::rt::OnKeyDown( UINT vk, BOOL fDown, INT cRepeat, UINT flags )
     DestroyWindow(hWnd);
     break;
   case 'S':
-    Frame.Save();
+    Post(
+      [this]( VOID )
+      {
+        CHAR FileName[102];
+
+        // published buffer may be shown now, so back one is resolved
+        Frame.Image = Chain.GetBack(Frame.W, Frame.H);
+        Frame.Resolve();
+        // encoding and writing are done by saver thread
+        Saver.Save(frame::TimeFileName(FileName, "png"), Frame.Image, Frame.W, Frame.H);
+      });
     break;
   case VK_SPACE:
-    Scene.Timer.IsPause = !Scene.Timer.IsPause;
+    Post(
+      [this]( VOID )
+      {
+        Scene.Timer.IsPause = !Scene.Timer.IsPause;
+      });
     break;
   case VK_F11:
     FlipFullScreen();
     break;
+
+  // view changes make frame in progress useless
   case '1':
-    if (Scene.CamDist > 5)
-    Scene.CamDist -= .3;
-    break;
   case '2':
-    if (Scene.CamDist < 25)
-    Scene.CamDist += .3;
+    Post(
+      [this, vk]( VOID )
+      {
+        if (vk == '1' && Scene.CamDist > 5)
+          Scene.CamDist -= .3;
+        else if (vk == '2' && Scene.CamDist < 25)
+          Scene.CamDist += .3;
+      }, TRUE);
+    break;
+  case 'L':
+  case 'R':
+  case 'A':
+    Post(
+      [this, vk]( VOID )
+      {
+        if (vk == 'L')
+          Scene.IsManyLights = !Scene.IsManyLights;
+        else if (vk == 'R')
+          Scene.Policy.IsRoulette = !Scene.Policy.IsRoulette;
+        else
+          Scene.IsJitter = !Scene.IsJitter;
+        Scene.Invalidate(scene::CHANGED_SHADING);
+      }, TRUE);
+    break;
+  case 'B':
+  case 'T':
+  case 'Z':
+    Post(
+      [this, vk]( VOID )
+      {
+        if (vk == 'B')
+          Scene.IsWavefront = !Scene.IsWavefront;
+        else if (vk == 'T')
+          Scene.IsReproject = !Scene.IsReproject;
+        else
+          Frame.SetTiled(!Frame.IsTiled);
+      });
+    break;
+
+  // display parameters need resolve pass only
+  case VK_ADD:
+  case VK_SUBTRACT:
+  case 'M':
+  case 'G':
+    Post(
+      [this, vk]( VOID )
+      {
+        if (vk == VK_ADD)
+          Frame.Exposure *= 1.25f;
+        else if (vk == VK_SUBTRACT)
+          Frame.Exposure /= 1.25f;
+        else if (vk == 'M')
+          Frame.ToneMap = (tonemap)((Frame.ToneMap + 1) % 3);
+        else
+          Frame.Gamma = Frame.Gamma == 1 ? 2.2f : 1;
+        Frame.Image = Chain.GetBack(Frame.W, Frame.H);
+        Frame.Resolve();
+        Present();
+      });
     break;
   }
 } /* End of 'dart::rt::OnKeyDown' function */
@@ -8,18 +8,23 @@
  *               Ray tracing scene implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 26.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
  * Computer Graphics Support Group of 30 Phys-Math Lyceum
  */
 #include <cmath>
+#include <utility>
 
-#include "rt/rt.h"
+#include "rt/scene.h"
+#include "rt/parallel.h"
 
 namespace dart
 {
+  /* Relative refraction index of refracted rays */
+  const DBL RefractEta = .95;
+
   /* Add shape to scene function.
    * ARGUMENTS:
    *   - pointer at shape to add:
@@ -30,6 +35,7 @@ namespace dart
   scene & scene::operator<< ( shape *Shp )
   {
     Shapes.push_back(Shp);
+    Invalidate(CHANGED_SHAPES);
     return *this;
   } /* End of 'operator<<' function */
 
@@ -43,78 +49,659 @@ namespace dart
   scene & scene::operator<< ( lgh::light *Lgh )
   {
     Lights.push_back(Lgh);
+    Invalidate(CHANGED_LIGHTS);
     return *this;
   } /* End of 'operator<<' function */
 
+  /* Move camera and rebuild hierarchies function.
+   * ARGUMENTS:
+   *   - reference at current camera:
+   *       camera &Cam;
+   * RETURNS: None.
+   */
+  VOID scene::Prepare( camera &Cam )
+  {
+    // move camera (modifiers are animated by the same time)
+    if (!Timer.IsPause)
+    {
+      Cam.Set(vec3(CamDist * sin(Timer.Time), CamDist, CamDist * cos(Timer.Time)), vec3(0), vec3(0, 1, 0));
+      if (IsAnimated)
+        Changes |= CHANGED_SHADING;
+    }
+
+    // modifiers are evaluated for time once per frame (moved shapes get their transformations)
+    if (!IsBvhValid || (IsAnimated && (!Timer.IsPause || (Changes & CHANGED_SHAPES))))
+    {
+      BOOL IsMoved = FALSE;
+
+      for (auto shp : Shapes)
+        IsMoved = shp->Animate(Timer) || IsMoved;
+      if (IsMoved)
+      {
+        Changes |= CHANGED_SHAPES;
+        if (IsBvhValid && !Bvh.Refit())
+          IsBvhValid = FALSE;
+      }
+    }
+
+    if (!IsLightTreeValid)
+    {
+      LightTree.Build(Lights);
+      IsLightTreeValid = TRUE;
+    }
+    if (!IsBvhValid)
+    {
+      Bvh.Build(Shapes);
+      IsBvhValid = TRUE;
+
+      IsAnimated = FALSE;
+      for (auto shp : Shapes)
+        for (auto mod : shp->Mods)
+          IsAnimated = IsAnimated || mod->IsAnimated();
+    }
+  } /* End of 'Prepare' function */
+
+  /* Prepare scene to frame rendering function.
+   * ARGUMENTS:
+   *   - reference at current camera:
+   *       camera &Cam;
+   *   - reference at frame:
+   *       frame &Frm;
+   * RETURNS:
+   *   (BOOL) TRUE if frame should be rendered, FALSE overwise.
+   */
+  BOOL scene::Update( camera &Cam, frame &Frm )
+  {
+    Prepare(Cam);
+
+    if ((INT)Accum.size() != Frm.Size() || IsAccumTiled != Frm.IsTiled ||
+        AccumLoc.Distance(Cam.Loc) > Threshold || AccumDir.Distance(Cam.Dir) > Threshold)
+      Changes |= CHANGED_CAMERA;
+    // samples of other sampling modes (e.g. toggled while paused) are not mixed
+    if (AccumMode != SamplingMode())
+      Changes |= CHANGED_SHADING;
+    if (Changes & (CHANGED_SHAPES | CHANGED_CAMERA))
+      IsGBufferValid = FALSE;
+
+    // reprojected frame is approximate, so it is replaced by traced one when view stops
+    if (Changes == 0 && IsReprojected)
+      Changes |= CHANGED_SHADING;
+    IsReprojected = IsReproject && Changes == CHANGED_CAMERA && Cache.IsValid(Frm);
+
+    // restart progressive accumulation if anything has changed
+    if (Changes != 0)
+    {
+      Accum.assign(Frm.Size(), vec3(0));
+      GBuffer.resize(Frm.Size());
+      IsAccumTiled = Frm.IsTiled;
+      AccumCount = 0;
+      AccumLoc = Cam.Loc, AccumDir = Cam.Dir;
+      AccumMode = SamplingMode();
+      IsPassOpen = FALSE;
+      Changes = 0;
+    }
+    else if (IsPassOpen)
+      return TRUE; // the same samples for tiles left by cancelled pass
+    else if (AccumCount >= (IsStochastic() ? MaxAccumCount : 1))
+      return FALSE;
+    AccumCount++;
+    TilesDone.assign(Frm.TilesW * Frm.TilesH, 0);
+    IsPassOpen = TRUE;
+    return TRUE;
+  } /* End of 'Update' function */
+
+  /* Check if frames accumulation converges by random samples function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) TRUE if frames differ by random decisions, FALSE overwise.
+   */
+  BOOL scene::IsStochastic( VOID )
+  {
+    return IsJitter || Policy.IsRoulette || (IsManyLights && LightTree.Size() > LightsBudget);
+  } /* End of 'IsStochastic' function */
+
+  /* Get sampling modes which change accumulated image function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (UINT) many-lights, jitter and roulette flags with lights budget.
+   */
+  UINT scene::SamplingMode( VOID ) const
+  {
+    return (IsManyLights ? 1 : 0) | (IsJitter ? 2 : 0) | (Policy.IsRoulette ? 4 : 0) | (UINT)LightsBudget << 3;
+  } /* End of 'SamplingMode' function */
+
   /* Render scene function.
    * ARGUMENTS:
    *   - reference at current camera:
    *       camera &Cam;
    *   - reference at frame:
    *       frame &Frm;
-   * RETURNS: None.
+   * RETURNS:
+   *   (BOOL) TRUE if frame has been changed, FALSE if nothing changed since last frame
+   *          or frame is cancelled.
    */
-  VOID scene::Render( camera &Cam, frame &Frm )
+  BOOL scene::Render( camera &Cam, frame &Frm )
   {
+    if (!Update(Cam, Frm))
+      return FALSE;
     IsRendered = FALSE;
 
-    // prepare threads
-    INT ThreadsAmount = std::thread::hardware_concurrency() - 1;
-    std::vector<std::thread> Ths;
-    Ths.resize(ThreadsAmount);
-
-    // move camera
-    if (!Timer.IsPause)
-      Cam.Set(vec3(CamDist * sin(Timer.Time), CamDist, CamDist * cos(Timer.Time)), vec3(0), vec3(0, 1, 0));
+    // take colors of pixels still visible from previous frame
+    const BYTE *mask = nullptr;
+    if (IsReprojected)
+    {
+      TraceMask.resize(Frm.Size());
+      Cache.Reproject(Cam, Frm, TraceMask.data());
+      for (INT i = 0; i < Frm.Size(); i++)
+        if (!TraceMask[i])
+          Accum[i] = Cache[i];
+      mask = TraceMask.data();
+    }
 
-    /*
-    ThreadsAmount = 1;
-    for (INT i = 0; i < ThreadsAmount; i++)
+    // draw all scene
+    path Path;
+    DBL norm = 1.0 / AccumCount;
+    if (IsWavefront)
     {
-      Ths[i] = std::thread(
-        [&, i]( VOID )
+      RenderWavefront(Cam, Frm, Path, mask);
+      for (INT i = 0; i < Frm.Size(); i++)
+        Frm.Put(i, Accum[i] * norm);
+    }
+    else
+    {
+      // every worker owns whole tiles of frame
+      INT tiles = Frm.TilesW * Frm.TilesH;
+      stock<path_stats> stats;
+
+      stats.resize(tiles);
+      ParallelFor(tiles, 1,
+        [&]( INT Start, INT End )
         {
-          // draw all scene
-          for (INT Y = i; Y < Frm.H; Y += ThreadsAmount)
-            for (INT X = 0; X < Frm.W; X++)
+          path P;
+          ray_gen Gen(Cam);
+          ray_gen::block Blk;
+          DBL Jitter[frame::TileSize * 2];
+
+          for (INT t = Start; t < End && !IsCancel; t++)
+          {
+            INT
+              X0 = t % Frm.TilesW * frame::TileSize,
+              Y0 = t / Frm.TilesW * frame::TileSize,
+              W = COM_MIN(Frm.W, X0 + frame::TileSize) - X0;
+
+            for (INT Y = Y0; Y < COM_MIN(Frm.H, Y0 + frame::TileSize); Y++)
             {
-              Frm.PutPixel(X, Y, vec4(Trace((Cam.CastRayToFrame(X + .5, Y - .5)), Air, 1, RecLevel < MaxRecLevel)));
+              // tile of continued pass needs only hits for next passes
+              if (TilesDone[t])
+              {
+                if (!IsGBufferValid)
+                  Gen.Row(X0 + .5, Y + Frm.OrgY - .5, W, Blk);
+                for (INT x = 0; x < W; x++)
+                {
+                  INT i = Frm.Index(X0 + x, Y);
+
+                  if (!IsGBufferValid)
+                    Intersect(Blk.Get(x), &GBuffer[i]);
+                  Frm.Put(i, Accum[i] * norm);
+                }
+                continue;
+              }
+
+              if (IsJitter)
+                for (INT x = 0; x < W; x++)
+                  ray_gen::Jitter(X0 + x, Y + Frm.OrgY, AccumCount, Jitter + x * 2);
+              Gen.Row(X0 + .5, Y + Frm.OrgY - .5, W, Blk, IsJitter ? Jitter : nullptr);
+              for (INT x = 0; x < W; x++)
+              {
+                INT X = X0 + x, i = Frm.Index(X, Y);
+                vec3 &A = Accum[i];
+                intr &Hit = GBuffer[i];
+
+                if (mask != nullptr && !mask[i])
+                {
+                  Frm.Put(i, A);
+                  continue;
+                }
+
+                ray R = Blk.Get(x);
+
+                // primary hits do not depend on shading, so they are kept while view is the same
+                if (!IsGBufferValid || IsJitter)
+                  Intersect(R, &Hit);
+                P.Rnd.Seed(X, Y + Frm.OrgY, AccumCount);
+                A += Trace(R, Gen.Diff(R.Dir), Air, 1, P, &Hit);
+                Frm.Put(i, A * norm);
+              }
             }
+            TilesDone[t] = 1;
+          }
+          stats[Start] = P.Stats;
         });
+      for (auto &st : stats)
+        Path.Stats += st;
     }
-    for (INT i = 0; i < ThreadsAmount; i++)
-      Ths[i].join();
-    */
-    // draw all scene
-    for (INT Y = 0; Y < Frm.H; Y++)
-      for (INT X = 0; X < Frm.W; X++)
-        Frm.PutPixel(X, Y, vec4(Trace((Cam.CastRayToFrame(X + .5, Y - .5)), Air, 1, RecLevel < MaxRecLevel)));
+
+    // cancelled frame is incomplete, so it is not shown, only whole tiles are kept
+    if (IsCancel)
+    {
+      if (IsWavefront || IsReprojected)
+      {
+        Changes |= CHANGED_SHADING;
+        IsGBufferValid = FALSE;
+      }
+      Cache.Invalidate();
+      return FALSE;
+    }
+    Frm.Resolve();
+    if (IsReproject)
+      Cache.Store(Frm, GBuffer.data(), Accum.data(), AccumCount, mask);
+    else
+      Cache.Invalidate();
+
+    // reprojected frame has hits of traced pixels only, jittered one has hits of shifted samples
+    IsGBufferValid = !IsReprojected && !IsJitter;
+    std::fill(TilesDone.begin(), TilesDone.end(), 1);
+    IsPassOpen = FALSE;
+    Stats = Path.Stats;
     IsRendered = TRUE;
+    return TRUE;
   } /* End of 'Render' function */
 
+  /* Render rectangle of frame pixels function.
+   * Pixels get the same colors as by 'Render' after 'Samples' recursive
+   * passes (every sample is seeded by pixel and pass number), so parts
+   * of one frame may be rendered separately (by other processes).
+   * ARGUMENTS:
+   *   - reference at current camera (it should be resized to frame):
+   *       camera &Cam;
+   *   - rectangle position and size in frame:
+   *       INT X0, INT Y0, INT W, INT H;
+   *   - samples per pixel (used by stochastic scenes only):
+   *       INT Samples;
+   *   - colors array to fill (3 components per pixel, rows of rectangle):
+   *       FLT *Out;
+   * RETURNS: None.
+   */
+  VOID scene::RenderRect( camera &Cam, INT X0, INT Y0, INT W, INT H, INT Samples, FLT *Out )
+  {
+    Prepare(Cam);
+
+    INT passes = IsStochastic() ? COM_MAX(1, Samples) : 1;
+    DBL norm = 1.0 / passes;
+
+    ParallelFor(H, 1,
+      [&]( INT Start, INT End )
+      {
+        path P;
+        ray_gen Gen(Cam);
+
+        for (INT y = Start; y < End; y++)
+          for (INT x = 0; x < W; x++)
+          {
+            INT X = X0 + x, Y = Y0 + y;
+            ray R = Gen.Get(X + .5, Y - .5);
+            intr Hit;
+            vec3 A(0);
+
+            if (!IsJitter)
+              Intersect(R, &Hit);
+            for (INT s = 1; s <= passes; s++)
+            {
+              if (IsJitter)
+              {
+                DBL Offs[2];
+
+                ray_gen::Jitter(X, Y, s, Offs);
+                R = Gen.Get(X + .5, Y - .5, Offs);
+                Intersect(R, &Hit);
+              }
+              P.Rnd.Seed(X, Y, s);
+              A += Trace(R, Gen.Diff(R.Dir), Air, 1, P, &Hit);
+            }
+            A = A * norm;
+
+            FLT *o = Out + (y * W + x) * 3;
+            o[0] = (FLT)A.X, o[1] = (FLT)A.Y, o[2] = (FLT)A.Z;
+          }
+      });
+  } /* End of 'RenderRect' function */
+
+  /* Render frame by wavefront pipeline function.
+   * ARGUMENTS:
+   *   - reference at current camera:
+   *       camera &Cam;
+   *   - reference at frame:
+   *       frame &Frm;
+   *   - reference at ray path state (for statistics):
+   *       path &Path;
+   *   - flags of pixels to trace (nullptr to trace all pixels):
+   *       const BYTE *Mask;
+   * RETURNS: None.
+   */
+  VOID scene::RenderWavefront( camera &Cam, frame &Frm, path &Path, const BYTE *Mask )
+  {
+    ray_queue *Cur = &Queues[0], *Next = &Queues[1];
+    INT slots = LightSamples();
+    vec3 Min(-1), Max(1);
+
+    Bvh.Bound(&Min, &Max);
+    WavefrontGenerate(Cam, Frm, *Cur, Mask);
+    for (INT gen = 0; Cur->Size() > 0 && !IsCancel; gen++)
+    {
+      INT n = Cur->Size();
+
+      // primary rays are coherent in pixels order already
+      if (gen > 0)
+        Cur->Sort(Min, Max);
+      if (gen == 0 && IsGBufferValid && !IsJitter && Mask == nullptr)
+      {
+        Ins.resize(n);
+        for (INT i = 0; i < n; i++)
+          Ins[i] = GBuffer[Cur->Pixel[i]];
+      }
+      else
+      {
+        WavefrontIntersect(*Cur);
+        if (gen == 0)
+          for (INT i = 0; i < n; i++)
+            GBuffer[Cur->Pixel[i]] = Ins[i];
+      }
+
+      // shade by waves to keep shadow slots memory bounded
+      INT wave = COM_MAX(bvh::MaxBatch, (1 << 20) / COM_MAX(slots, 1));
+
+      Next->Clear();
+      for (INT start = 0; start < n && !IsCancel; start += wave)
+      {
+        INT end = COM_MIN(n, start + wave);
+
+        WavefrontShade(*Cur, start, end, slots, Path);
+        WavefrontShadow((end - start) * slots);
+        WavefrontGather(*Cur, start, end, slots, *Next);
+      }
+      std::swap(Cur, Next);
+    }
+  } /* End of 'RenderWavefront' function */
+
+  /* Wavefront primary rays generation stage function.
+   * ARGUMENTS:
+   *   - reference at current camera:
+   *       camera &Cam;
+   *   - reference at frame:
+   *       frame &Frm;
+   *   - reference at rays queue to fill:
+   *       ray_queue &Q;
+   *   - flags of pixels to trace (nullptr to trace all pixels):
+   *       const BYTE *Mask;
+   * RETURNS: None.
+   */
+  VOID scene::WavefrontGenerate( camera &Cam, frame &Frm, ray_queue &Q, const BYTE *Mask )
+  {
+    ray_gen Gen(Cam);
+
+    if (Mask != nullptr)
+    {
+      INT n = 0;
+
+      for (INT i = 0; i < Frm.Size(); i++)
+        n += Mask[i];
+      Q.Resize(n);
+      n = 0;
+      for (INT Y = 0; Y < Frm.H; Y++)
+        for (INT X = 0; X < Frm.W; X++)
+          if (Mask[Frm.Index(X, Y)])
+          {
+            rnd r;
+            DBL Offs[2];
+
+            if (IsJitter)
+              ray_gen::Jitter(X, Y + Frm.OrgY, AccumCount, Offs);
+            r.Seed(X, Y + Frm.OrgY, AccumCount);
+
+            ray R = Gen.Get(X + .5, Y + Frm.OrgY - .5, IsJitter ? Offs : nullptr);
+
+            Q.Set(n++, R, ray_state(Air, 1, vec3(1), Frm.Index(X, Y), 0, 0, 0, r, Gen.Diff(R.Dir)));
+          }
+      return;
+    }
+
+    Q.Resize(Frm.W * Frm.H);
+    ParallelFor(Frm.H, 8,
+      [&]( INT Start, INT End )
+      {
+        ray_gen::block Blk;
+        DBL Jitter[ray_gen::block::MaxCount * 2];
+
+        for (INT Y = Start; Y < End; Y++)
+          for (INT X0 = 0; X0 < Frm.W; X0 += ray_gen::block::MaxCount)
+          {
+            INT W = COM_MIN(Frm.W - X0, ray_gen::block::MaxCount);
+
+            if (IsJitter)
+              for (INT x = 0; x < W; x++)
+                ray_gen::Jitter(X0 + x, Y + Frm.OrgY, AccumCount, Jitter + x * 2);
+            Gen.Row(X0 + .5, Y + Frm.OrgY - .5, W, Blk, IsJitter ? Jitter : nullptr);
+            for (INT x = 0; x < W; x++)
+            {
+              INT X = X0 + x;
+              rnd r;
+              ray R = Blk.Get(x);
+
+              r.Seed(X, Y + Frm.OrgY, AccumCount);
+              Q.Set(Y * Frm.W + X, R, ray_state(Air, 1, vec3(1), Frm.Index(X, Y), 0, 0, 0, r, Gen.Diff(R.Dir)));
+            }
+          }
+      });
+  } /* End of 'WavefrontGenerate' function */
+
+  /* Wavefront closest hits stage function.
+   * ARGUMENTS:
+   *   - reference at rays queue:
+   *       ray_queue &Q;
+   * RETURNS: None.
+   */
+  VOID scene::WavefrontIntersect( ray_queue &Q )
+  {
+    Ins.resize(Q.Size());
+    ParallelFor(Q.Size(), bvh::MaxBatch * 16,
+      [&]( INT Start, INT End )
+      {
+        Bvh.Intersect(Q.Rays.data() + Start, End - Start, Ins.data() + Start);
+      });
+  } /* End of 'WavefrontIntersect' function */
+
+  /* Wavefront shading stage function.
+   * ARGUMENTS:
+   *   - reference at rays queue:
+   *       ray_queue &Q;
+   *   - wave rays range:
+   *       INT Start, End;
+   *   - shadow slots per ray:
+   *       INT Slots;
+   *   - reference at ray path state (for statistics):
+   *       path &Path;
+   * RETURNS: None.
+   */
+  VOID scene::WavefrontShade( ray_queue &Q, INT Start, INT End, INT Slots, path &Path )
+  {
+    INT n = End - Start, chunk = 256;
+    stock<path_stats> stats;
+
+    Radiance.resize(n);
+    ShadowCount.resize(n);
+    Infos.resize(n);
+    Shadows.Resize(n * Slots);
+    Children.Resize(n * 2);
+    IsChild.resize(n * 2);
+    stats.resize((n + chunk - 1) / chunk);
+
+    ParallelFor(n, chunk,
+      [&]( INT ChunkStart, INT ChunkEnd )
+      {
+        path P;
+
+        // shading parameters of chunk hits are modified together
+        for (INT j = ChunkStart; j < ChunkEnd; j++)
+        {
+          INT i = Start + j;
+          const intr &in = Ins[i];
+
+          ShadowCount[j] = 0;
+          IsChild[j * 2] = IsChild[j * 2 + 1] = 0;
+          for (INT k = j * Slots; k < (j + 1) * Slots; k++)
+            Shadows.Dist[k] = 0;
+          Infos[j].Shp = nullptr;
+
+          // same rules as in 'Trace' and 'Shade', but light samples and secondary rays are deferred
+          if (Q.Level[i] >= MaxRecLevel)
+          {
+            P.Stats.Depth++;
+            Radiance[j] = Q.Factor[i] * BackgroundColor;
+            continue;
+          }
+          P.Stats.Traced++;
+
+          if (in.Shp == nullptr)
+          {
+            Radiance[j] = Q.Factor[i] * exp(-in.T * Q.Media[i].Decay) * BackgroundColor;
+            continue;
+          }
+
+          ray_diff d = Q.Diff[i];
+
+          d.Transfer(Q.Rays[i].Dir, in.T, in.N);
+          Infos[j] = shade_info {in.P, in.N, in.Shp, in.Shp->Surf, Q.Media[i], {1, 0, 0}, {0, 1, 0}, d.dOdx, d.dOdy, d.Width()};
+        }
+        ApplyModifiers(Infos.data() + ChunkStart, ChunkEnd - ChunkStart);
+
+        for (INT j = ChunkStart; j < ChunkEnd; j++)
+        {
+          INT i = Start + j;
+          shade_info &si = Infos[j];
+
+          if (si.Shp == nullptr)
+            continue;
+
+          vec3 f = Q.Factor[i] * exp(-Ins[i].T * Q.Media[i].Decay);
+          const vec3 &V = Q.Rays[i].Dir;
+          ray_diff d(si.dPdx, si.dPdy, Q.Diff[i].dDdx, Q.Diff[i].dDdy);
+          vec3 R;
+
+          P.Level = Q.Level[i] + 1, P.ReflLevel = Q.ReflLevel[i], P.RefrLevel = Q.RefrLevel[i];
+          P.Rnd = Q.Rnd[i];
+          Radiance[j] = f * Illuminate(V, si, &R, P, &Shadows, j * Slots, &ShadowCount[j]);
+          for (INT k = j * Slots; k < j * Slots + ShadowCount[j]; k++)
+            Shadows.Color[k] *= f;
+
+          // child rays get own generators, so their random decisions are independent
+          DBL q, w = si.Surf.Kr * Q.Weight[i];
+          if (Continue(w, TRUE, si.Surf, P, &q))
+          {
+            Children.Set(j * 2, ray(si.P + R * Threshold, R),
+              ray_state(Q.Media[i], w / q, f / q, Q.Pixel[i], P.Level, P.ReflLevel + 1, P.RefrLevel, rnd(P.Rnd.Next()),
+                d.Reflect(V, si.N)));
+            IsChild[j * 2] = 1;
+          }
+
+          w = si.Surf.Kt * Q.Weight[i];
+          if (Continue(w, FALSE, si.Surf, P, &q))
+          {
+            vec3 T = Refract(V, si.N);
+
+            Children.Set(j * 2 + 1, ray(si.P + T * Threshold, T),
+              ray_state(envi(1.05, .028), w / q, f / q, Q.Pixel[i], P.Level, P.ReflLevel, P.RefrLevel + 1, rnd(P.Rnd.Next()),
+                d.Refract(V, si.N, RefractEta)));
+            IsChild[j * 2 + 1] = 1;
+          }
+        }
+        stats[ChunkStart / chunk] = P.Stats;
+      });
+
+    for (auto &st : stats)
+      Path.Stats += st;
+  } /* End of 'WavefrontShade' function */
+
+  /* Wavefront shadow rays stage function.
+   * ARGUMENTS:
+   *   - shadow slots count:
+   *       INT Count;
+   * RETURNS: None.
+   */
+  VOID scene::WavefrontShadow( INT Count )
+  {
+    // unused slots have zero length and are skipped by tree
+    ParallelFor(Count, bvh::MaxBatch * 16,
+      [&]( INT Start, INT End )
+      {
+        Bvh.IsOccluded(Shadows.Rays.data() + Start, Shadows.Dist.data() + Start, End - Start, Shadows.IsOccluded.data() + Start);
+      });
+  } /* End of 'WavefrontShadow' function */
+
+  /* Wavefront gathering stage function.
+   * ARGUMENTS:
+   *   - reference at rays queue:
+   *       ray_queue &Q;
+   *   - wave rays range:
+   *       INT Start, End;
+   *   - shadow slots per ray:
+   *       INT Slots;
+   *   - reference at next generation queue:
+   *       ray_queue &Next;
+   * RETURNS: None.
+   */
+  VOID scene::WavefrontGather( ray_queue &Q, INT Start, INT End, INT Slots, ray_queue &Next )
+  {
+    INT n = Next.Size(), count = 0;
+
+    for (INT c = 0; c < (End - Start) * 2; c++)
+      count += IsChild[c];
+    Next.Resize(n + count);
+    for (INT j = 0; j < End - Start; j++)
+    {
+      vec3 &A = Accum[Q.Pixel[Start + j]];
+
+      A += Radiance[j];
+      for (INT k = j * Slots; k < j * Slots + ShadowCount[j]; k++)
+        if (!Shadows.IsOccluded[k])
+          A += Shadows.Color[k];
+      for (INT c = j * 2; c < j * 2 + 2; c++)
+        if (IsChild[c])
+          Next.Set(n++, Children.Rays[c], Children.Get(c));
+    }
+  } /* End of 'WavefrontGather' function */
+
   /* Trace ray in scene function.
    * ARGUMENTS:
    *   - reference at ray:
    *       const ray &Ray;
+   *   - reference at ray differentials:
+   *       const ray_diff &Diff;
    *   - reference at tracing environment:
    *       const envi &Media;
    *   - weigth:
    *       DBL Weight;
-   *   - is recurcy ray tracing avaible flag:
-   *       BOOL IsRecAvaible;
+   *   - reference at ray path state:
+   *       path &Path;
+   *   - pointer at already found closest hit (nullptr to find it):
+   *       const intr *Hit;
    * RETURNS:
    *   (vec3) Pixel color.
    */
-  vec3 scene::Trace( const ray &Ray, const envi &Media, DBL Weight, BOOL IsRecAvaible )
+  vec3 scene::Trace( const ray &Ray, const ray_diff &Diff, const envi &Media, DBL Weight, path &Path, const intr *Hit )
   {
     vec3 color = BackgroundColor;
 
     intr in;
-    if (IsRecAvaible)
+    if (Path.Level < MaxRecLevel)
     {
-      RecLevel++;
-      if (Intersect(Ray, &in))
-        color = Shade(Ray.Dir, Media, &in, Weight);
+      Path.Level++;
+      Path.Stats.Traced++;
+      if (Hit != nullptr)
+        in = *Hit;
+      else
+        Intersect(Ray, &in);
+      if (in.Shp != nullptr)
+        color = Shade(Ray.Dir, Diff, Media, &in, Weight, Path);
 
       // fog attenuation
 #if 0
@@ -129,8 +716,10 @@ namespace dart
 #endif
       color *= exp(-in.T * Media.Decay);
 
-      RecLevel--;
+      Path.Level--;
     }
+    else
+      Path.Stats.Depth++;
     return color;
   } /* End of 'Trace' funciton */
 
@@ -145,17 +734,7 @@ namespace dart
    */
   BOOL scene::Intersect( const ray &R, intr *In )
   {
-    intr best_in, in;
-    Shapes.Walk(
-      [R, &best_in, &in]( shape *Shp )
-      {
-        if (Shp->Intersect(R, &in))
-          if (best_in.Shp == nullptr || best_in.T > in.T)
-            best_in = in;
-      });
-    best_in.P = R(best_in.T);
-    *In = best_in;
-    return best_in.Shp != nullptr;
+    return Bvh.Intersect(R, In);
   } /* End of 'Intersect' function */
 
   /* Find all intersections with ray function.
@@ -173,7 +752,7 @@ namespace dart
     Shapes.Walk(
       [R, &Ins, &ins_count]( shape *Shp )
       {
-        ins_count += Shp->AllIntersect(R, Ins);
+        ins_count += Shp->WorldAllIntersect(R, Ins);
       });
     return ins_count++;
   } /* End of 'AllIntersect' function */
@@ -182,76 +761,314 @@ namespace dart
    * ARGUMENTS:
    *   - reference at light direction:
    *       const vec3 &V;
+   *   - reference at ray differentials:
+   *       const ray_diff &Diff;
    *   - reference at tracing environment:
    *       const envi &Media;
    *   - point at intersection:
    *       const intr *In;
    *   - weigth:
    *       DBL Weight;
+   *   - reference at ray path state:
+   *       path &Path;
    * RETURNS:
    *   (vec3) Pixel color.
    */
-  vec3 scene::Shade( const vec3 &V, const envi &Media, intr *In, DBL Weight )
+  vec3 scene::Shade( const vec3 &V, const ray_diff &Diff, const envi &Media, intr *In, DBL Weight, path &Path )
   {
-    shade_info si {In->P, In->N, In->Shp, In->Shp->Surf, Media, {1, 0, 0}, {0, 1, 0}}; //((In->N & V) > Threshold) ? -In->N : 
-    In->Shp->Mods.Walk(
-      [this, &si]( modifier *Mod)
-      {
-        Mod->Apply(&si, Timer);
-      });
+    ray_diff d = Diff;
 
-    if ((si.N & V) > Threshold)
-      si.N *= -1;
-    vec3 color = si.Surf.Ka * AmbientColor;
-    vec3 R = (V - si.N * (2 * (V & si.N))).Normalizing();
-    for (auto lgh : Lights)
-    {
-      // attenuation
-      lgh::light_info lgh_info;
-      color *= lgh->Shadow(si.P, &lgh_info);
+    d.Transfer(V, In->T, In->N);
 
-      // cast shadow
-      intr_list intr_list;
-      if (AllIntersect(ray(si.P + lgh_info.Dir * Threshold, lgh_info.Dir), intr_list) > 0 && intr_list[0].T < lgh_info.Dist)
-        continue;
+    shade_info si {In->P, In->N, In->Shp, In->Shp->Surf, Media, {1, 0, 0}, {0, 1, 0}, d.dOdx, d.dOdy, d.Width()}; //((In->N & V) > Threshold) ? -In->N : 
+    vec3 R;
 
+    ApplyModifiers(&si, 1);
+    vec3 color = Illuminate(V, si, &R, Path);
 
-      // diffuse
-      DBL nl = si.N & lgh_info.Dir;
-      if (abs(nl) > Threshold)
-      {
-        color += si.Surf.Kd * lgh_info.Color * nl;
-
-#if 1
-        // specular
-        DBL rl = R & lgh_info.Dir;
-        if (rl > Threshold)
-        {
-          color += si.Surf.Ks * lgh_info.Color * pow(rl, si.Surf.Ph);
-        }
-#endif
-      }
-    }
     // Reflection other scene shapes
-    DBL w = si.Surf.Kr * Weight;
-    if (w > .003921)
-      color += Trace(ray(si.P + R * Threshold, R), Media, w, RecLevel < MaxRecLevel);
+    DBL q, w = si.Surf.Kr * Weight;
+    if (Continue(w, TRUE, si.Surf, Path, &q))
+    {
+      Path.ReflLevel++;
+      color += Trace(ray(si.P + R * Threshold, R), d.Reflect(V, si.N), Media, w / q, Path) / q;
+      Path.ReflLevel--;
+    }
 
     if (color.MaxComp() > .9)
       w = w * 2;
 #if 1
     // Refraction
     w = si.Surf.Kt * Weight;
-    if (w > .003921)
+    if (Continue(w, FALSE, si.Surf, Path, &q))
     {
-      DBL n = .95;
-      vec3 T = (((V - si.N * (V & si.N)) * n) -
-        si.N * sqrt(1 - (1 - (-V & si.N) * (-V & si.N)) * n * n)).Normalizing();
-      vec3 c = Trace(ray(si.P + T * Threshold, T), envi(1.05, .028), w, RecLevel < MaxRecLevel);
+      vec3 T = Refract(V, si.N);
+      Path.RefrLevel++;
+      vec3 c = Trace(ray(si.P + T * Threshold, T), d.Refract(V, si.N, RefractEta), envi(1.05, .028), w / q, Path) / q;
+      Path.RefrLevel--;
       color += c;
     }
 #endif
     return color;
   } /* End of 'Shade' funciton */
+
+  /* Apply shapes modifiers to shading points function.
+   * Points are grouped by shapes, so every modifier is called once
+   * for all points of its shape (textures evaluate them by packs).
+   * ARGUMENTS:
+   *   - shading parameters array (points with no shape are skipped):
+   *       shade_info *Si;
+   *   - points count:
+   *       INT Count;
+   * RETURNS: None.
+   */
+  VOID scene::ApplyModifiers( shade_info *Si, INT Count )
+  {
+    const INT MaxGroup = 256;
+    INT Order[MaxGroup];
+
+    for (INT first = 0; first < Count; first += MaxGroup)
+    {
+      INT n = 0;
+
+      for (INT k = first; k < COM_MIN(Count, first + MaxGroup); k++)
+        if (Si[k].Shp != nullptr && !Si[k].Shp->Mods.empty())
+          Order[n++] = k;
+      std::sort(Order, Order + n,
+        [Si]( INT A, INT B )
+        {
+          return Si[A].Shp < Si[B].Shp;
+        });
+      for (INT a = 0, b; a < n; a = b)
+      {
+        shape *Shp = Si[Order[a]].Shp;
+
+        for (b = a + 1; b < n && Si[Order[b]].Shp == Shp; b++)
+          ;
+        for (auto mod : Shp->Mods)
+          mod->ApplyBatch(Si, Order + a, b - a, Timer);
+      }
+    }
+  } /* End of 'ApplyModifiers' function */
+
+  /* Get local (ambient and light sources) color of point function.
+   * ARGUMENTS:
+   *   - reference at light direction:
+   *       const vec3 &V;
+   *   - reference at shading parameters (shape modifiers are applied already):
+   *       shade_info &Si;
+   *   - pointer at reflected view direction:
+   *       vec3 *R;
+   *   - reference at ray path state:
+   *       path &Path;
+   *   - pointer at shadow rays batch to defer shadow tests to
+   *     (nullptr to test shadows immediately):
+   *       shadow_batch *Batch;
+   *   - first batch slot to fill:
+   *       INT First;
+   *   - pointer at filled batch slots count:
+   *       INT *Count;
+   * RETURNS:
+   *   (vec3) Point color without secondary rays (and without
+   *          deferred light samples).
+   */
+  vec3 scene::Illuminate( const vec3 &V, shade_info &Si, vec3 *R, path &Path, shadow_batch *Batch, INT First, INT *Count )
+  {
+    if ((Si.N & V) > Threshold)
+      Si.N *= -1;
+    vec3 color = Si.Surf.Ka * AmbientColor;
+    *R = (V - Si.N * (2 * (V & Si.N))).Normalizing();
+
+    INT slot = First;
+    auto Add =
+      [&]( lgh::light *Lgh, DBL Div )
+      {
+        if (Batch == nullptr)
+        {
+          color += ShadeLight(Si, *R, Lgh) / Div;
+          return;
+        }
+
+        lgh::light_info lgh_info;
+        vec3 c = LightColor(Si, *R, Lgh, &lgh_info);
+
+        if (c.X != 0 || c.Y != 0 || c.Z != 0)
+        {
+          Batch->Rays[slot] = ray(Si.P + lgh_info.Dir * Threshold, lgh_info.Dir);
+          Batch->Dist[slot] = lgh_info.Dist;
+          Batch->Color[slot] = c / Div;
+          slot++;
+        }
+      };
+
+    if (IsManyLights && LightTree.Size() > LightsBudget)
+    {
+      for (auto lgh : LightTree.Infinite)
+        Add(lgh, 1);
+
+      // estimate sum over local lights by few importance sampled ones
+      for (INT i = 0; i < LightsBudget; i++)
+      {
+        DBL pdf;
+        lgh::light *lgh = LightTree.Sample(Si.P, Si.N, Path.Rnd(), &pdf);
+
+        if (lgh != nullptr && pdf > 0)
+          Add(lgh, pdf * LightsBudget);
+      }
+    }
+    else
+      for (auto lgh : Lights)
+        Add(lgh, 1);
+    if (Count != nullptr)
+      *Count = slot - First;
+    return color;
+  } /* End of 'Illuminate' function */
+
+  /* Get maximum light samples per shading point function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT) light samples count.
+   */
+  INT scene::LightSamples( VOID )
+  {
+    if (IsManyLights && LightTree.Size() > LightsBudget)
+      return (INT)LightTree.Infinite.size() + LightsBudget;
+    return (INT)Lights.size();
+  } /* End of 'LightSamples' function */
+
+  /* Get refracted direction function.
+   * ARGUMENTS:
+   *   - reference at light direction:
+   *       const vec3 &V;
+   *   - reference at surface normal:
+   *       const vec3 &N;
+   * RETURNS:
+   *   (vec3) Refracted direction.
+   */
+  vec3 scene::Refract( const vec3 &V, const vec3 &N )
+  {
+    DBL n = RefractEta;
+
+    return (((V - N * (V & N)) * n) - N * sqrt(1 - (1 - (-V & N) * (-V & N)) * n * n)).Normalizing();
+  } /* End of 'Refract' function */
+
+  /* Get one light source contribution function.
+   * ARGUMENTS:
+   *   - reference at shading parameters:
+   *       const shade_info &Si;
+   *   - reference at reflected view direction:
+   *       const vec3 &R;
+   *   - pointer at light source:
+   *       lgh::light *Lgh;
+   * RETURNS:
+   *   (vec3) Light source color contribution (zero if shadowed).
+   */
+  vec3 scene::ShadeLight( const shade_info &Si, const vec3 &R, lgh::light *Lgh )
+  {
+    lgh::light_info lgh_info;
+    vec3 color = LightColor(Si, R, Lgh, &lgh_info);
+
+    // cast shadow
+    if ((color.X != 0 || color.Y != 0 || color.Z != 0) &&
+        Bvh.IsOccluded(ray(Si.P + lgh_info.Dir * Threshold, lgh_info.Dir), lgh_info.Dist))
+      return vec3(0);
+    return color;
+  } /* End of 'ShadeLight' funciton */
+
+  /* Get one light source contribution without shadow test function.
+   * ARGUMENTS:
+   *   - reference at shading parameters:
+   *       const shade_info &Si;
+   *   - reference at reflected view direction:
+   *       const vec3 &R;
+   *   - pointer at light source:
+   *       lgh::light *Lgh;
+   *   - pointer at light source parameters:
+   *       lgh::light_info *Info;
+   * RETURNS:
+   *   (vec3) Light source color contribution.
+   */
+  vec3 scene::LightColor( const shade_info &Si, const vec3 &R, lgh::light *Lgh, lgh::light_info *Info )
+  {
+    vec3 color(0);
+
+    // attenuation
+    DBL att = Lgh->Shadow(Si.P, Info);
+
+    // diffuse
+    DBL nl = Si.N & Info->Dir;
+    if (abs(nl) > Threshold)
+    {
+      color += Si.Surf.Kd * Info->Color * nl;
+
+#if 1
+      // specular
+      DBL rl = R & Info->Dir;
+      if (rl > Threshold)
+      {
+        color += Si.Surf.Ks * Info->Color * pow(rl, Si.Surf.Ph);
+      }
+#endif
+    }
+    return color * att;
+  } /* End of 'LightColor' function */
+
+  /* Decide if secondary ray should be traced function.
+   * ARGUMENTS:
+   *   - secondary ray weight:
+   *       DBL W;
+   *   - reflection (TRUE) or refraction (FALSE) ray flag:
+   *       BOOL IsRefl;
+   *   - reference at shading surface:
+   *       const surface &Surf;
+   *   - reference at ray path state:
+   *       path &Path;
+   *   - pointer at ray survival probability (to divide ray color by):
+   *       DBL *Q;
+   * RETURNS:
+   *   (BOOL) TRUE if ray should be traced, FALSE overwise.
+   */
+  BOOL scene::Continue( DBL W, BOOL IsRefl, const surface &Surf, path &Path, DBL *Q )
+  {
+    *Q = 1;
+    if (W <= 0)
+      return FALSE;
+
+    // separate budgets for reflection and refraction
+    if (IsRefl && Path.ReflLevel >= Policy.MaxReflLevel)
+    {
+      Path.Stats.Refl++;
+      return FALSE;
+    }
+    if (!IsRefl && Path.RefrLevel >= Policy.MaxRefrLevel)
+    {
+      Path.Stats.Refr++;
+      return FALSE;
+    }
+
+    // material depth cap
+    if (Surf.MaxLevel > 0 && Path.Level >= Surf.MaxLevel)
+    {
+      Path.Stats.Material++;
+      return FALSE;
+    }
+
+    if (!Policy.IsRoulette)
+    {
+      if (W > Policy.MinWeight)
+        return TRUE;
+      Path.Stats.Weight++;
+      return FALSE;
+    }
+
+    // Russian roulette: survivors are reweighted by 1 / Q, so estimation stays unbiased
+    if (W >= Policy.RouletteWeight || Path.Level < Policy.RouletteLevel)
+      return TRUE;
+    *Q = W / Policy.RouletteWeight;
+    if (Path.Rnd() < *Q)
+      return TRUE;
+    Path.Stats.Roulette++;
+    return FALSE;
+  } /* End of 'Continue' function */
 } /* end of 'dart' namespce */
 /* END OF 'scene.h' FILE */
@@ -8,7 +8,7 @@
  *               Ray tracing scene declaration module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 26.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -17,11 +17,19 @@
 #ifndef __scene_h_
 #define __scene_h_
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 #include "rt/shapes/shape_def.h"
 #include "rt/frame.h"
 #include "rt/light.h"
+#include "rt/light_tree.h"
+#include "rt/bvh.h"
+#include "rt/ray_queue.h"
+#include "rt/ray_gen.h"
+#include "rt/reprojection.h"
+#include "rt/path.h"
 
 namespace dart
 {
@@ -31,22 +39,109 @@ namespace dart
     vec3 AmbientColor, BackgroundColor, FogColor; // Scene colors
     DBL FogStart, FogEnd; // Fog start and maximum distances;
     envi Air; // Default scene environment
+    INT MaxRecLevel; // Maximum recurcy level
 
     BOOL IsRendered; // Is scene rendered flag (for threads syncronization)
 
     stock<shape *> Shapes; // Shapes on scene
     stock<lgh::light *> Lights; // Light sources on scene
 
-    INT RecLevel, MaxRecLevel; // Current and maximum recurcy level
+    lgh::tree LightTree;   // Light sources hierarchy for many-lights mode
+    BOOL IsLightTreeValid; // Is light hierarchy built for current lights flag
+
+    bvh Bvh;         // Shapes hierarchy
+    BOOL IsBvhValid; // Is shapes hierarchy built for current shapes flag
+    BOOL IsAnimated; // Are there shapes with time dependent modifiers flag
+
+    UINT Changes;        // Changes since last rendered frame (CHANGED_*** flags)
+    stock<intr> GBuffer; // Primary rays closest hits of current view
+    BOOL IsGBufferValid; // Are primary hits valid for current shapes and view flag
+
+    reprojection Cache;     // Shaded primary hits of previous frames
+    stock<BYTE> TraceMask;  // Pixels to trace in reprojected frame
+    BOOL IsReprojected;     // Is current frame reprojected from previous one flag
+
+    // wavefront pipeline buffers
+    ray_queue Queues[2];     // Current and next rays generations
+    stock<intr> Ins;         // Current generation closest hits
+    stock<vec3> Radiance;    // Ambient (or background) color of wave rays
+    shadow_batch Shadows;    // Shadow rays of wave (fixed slots per ray)
+    stock<INT> ShadowCount;  // Used shadow slots per wave ray
+    stock<shade_info> Infos; // Shading parameters of wave rays hits
+    ray_queue Children;      // Secondary rays of wave (two slots per ray)
+    stock<BYTE> IsChild;     // Used secondary ray slots flags
+
+    stock<vec3> Accum;       // Progressive accumulation buffer
+    INT AccumCount;          // Frames accumulated count
+    vec3 AccumLoc, AccumDir; // Camera position of accumulated frames
+    BOOL IsAccumTiled;       // Frame layout of accumulated frames
+    stock<BYTE> TilesDone;   // Tiles with samples of current pass flags
+    BOOL IsPassOpen;         // Current pass is cancelled before all tiles flag
+    UINT AccumMode;          // Sampling modes of accumulated frames (see 'SamplingMode')
 
   public:
+    /* Scene change flags */
+    enum
+    {
+      CHANGED_SHAPES = 1,  // Shapes added or moved
+      CHANGED_LIGHTS = 2,  // Light sources added or changed
+      CHANGED_CAMERA = 4,  // View or frame size changed
+      CHANGED_SHADING = 8  // Materials, modifiers or path parameters changed
+    };
+
+    /* Progressive accumulation state structure.
+     * Pixels of done tiles have 'Count' samples, other pixels have
+     * 'Count - 1' samples. Random numbers of every pixel sample are
+     * seeded by pixel position and sample number, so this is all state
+     * needed to continue rendering exactly as without interruption.
+     */
+    struct accum_state
+    {
+      INT W, H;              // Frame size
+      BOOL IsTiled;          // Frame layout of accumulation buffer
+      INT Count;             // Current pass number
+      vec3 Loc, Dir;         // Camera of accumulated frames
+      stock<BYTE> TilesDone; // Tiles with current pass samples flags
+      stock<vec3> Accum;     // Accumulated colors sums
+    };
+
+    /* Scene environment structure */
+    struct environment
+    {
+      vec3 Ambient, Background, Fog; // Scene colors
+      DBL FogStart, FogEnd;          // Fog start and maximum distances
+      envi Air;                      // Default scene environment
+      INT MaxRecLevel;               // Maximum recursion level
+    };
+
     DBL CamDist; // Camera distance from (0, 0, 0)
 
+    BOOL IsManyLights; // Stochastic many-lights sampling flag
+    INT LightsBudget;  // Sampled local lights per shading point
+
+    BOOL IsWavefront; // Render by wavefront pipeline stages flag (off by default: recursive mode is faster
+                      // on most scenes, wavefront one wins when procedural textures dominate shading)
+    INT MaxAccumCount; // Accumulated frames count after which stochastic image is final
+    BOOL IsReproject;  // Reproject previous frame when only camera moves flag
+    BOOL IsJitter;     // Jitter primary rays inside pixels by passes (antialiasing) flag
+
+    policy Policy;    // Ray path termination policy
+    path_stats Stats; // Last frame path termination statistics
+
+    std::atomic<BOOL> IsCancel; // Stop current frame request flag (may be set by other thread)
+
     timer Timer; // Scene timer
 
     /* Class default constructor */
     scene( VOID ) : AmbientColor(vec3(.13)), BackgroundColor(vec3(0, .17, .5)), FogColor(vec3(.1, .1, .3)),
-      FogStart(15), FogEnd(30), Air(1, .028), RecLevel(0), MaxRecLevel(3), IsRendered(FALSE), Shapes(), Lights(), Timer(), CamDist(15)
+      FogStart(15), FogEnd(30), Air(1, .028), MaxRecLevel(3), IsRendered(FALSE), Shapes(), Lights(),
+      LightTree(), IsLightTreeValid(FALSE), Bvh(), IsBvhValid(FALSE), IsAnimated(FALSE),
+      Changes(CHANGED_SHAPES | CHANGED_LIGHTS | CHANGED_CAMERA), GBuffer(), IsGBufferValid(FALSE),
+      Cache(), TraceMask(), IsReprojected(FALSE),
+      Queues(), Ins(), Radiance(), Shadows(), ShadowCount(), Infos(), Children(), IsChild(),
+      Accum(), AccumCount(0), AccumLoc(), AccumDir(), IsAccumTiled(FALSE), TilesDone(), IsPassOpen(FALSE), AccumMode(0),
+      CamDist(15), IsManyLights(FALSE), LightsBudget(4), IsWavefront(FALSE), MaxAccumCount(256), IsReproject(TRUE),
+      IsJitter(FALSE), Policy(), Stats(), IsCancel(FALSE), Timer()
     {
     } /* End of 'scene' function */
 
@@ -83,30 +178,303 @@ namespace dart
      */
     scene & operator<< ( lgh::light *Lgh );
 
+    /* Mark scene parts as changed function.
+     * Shapes and light sources added by 'operator<<' and camera moves
+     * are tracked automatically, other changes (moved shapes, changed
+     * materials or rendering parameters) should be reported here.
+     * ARGUMENTS:
+     *   - changed parts (CHANGED_*** flags):
+     *       UINT Flags;
+     * RETURNS: None.
+     */
+    VOID Invalidate( UINT Flags )
+    {
+      Changes |= Flags;
+      if (Flags & CHANGED_SHAPES)
+        IsBvhValid = FALSE;
+      if (Flags & CHANGED_LIGHTS)
+        IsLightTreeValid = FALSE;
+    } /* End of 'Invalidate' function */
+
+    /* Get progressive accumulation state function.
+     * Should be called between frames (state of cancelled frame is
+     * consistent: tiles are either done or not touched).
+     * ARGUMENTS:
+     *   - reference at state to fill (its buffers are reused):
+     *       accum_state &State;
+     *   - reference at frame:
+     *       const frame &Frm;
+     * RETURNS: None.
+     */
+    VOID GetAccum( accum_state &State, const frame &Frm ) const
+    {
+      State.W = Frm.W, State.H = Frm.H;
+      State.IsTiled = IsAccumTiled;
+      State.Count = AccumCount;
+      State.Loc = AccumLoc, State.Dir = AccumDir;
+      State.TilesDone.assign(TilesDone.begin(), TilesDone.end());
+      State.Accum.assign(Accum.begin(), Accum.end());
+    } /* End of 'GetAccum' function */
+
+    /* Get scene environment function.
+     * ARGUMENTS:
+     *   - reference at environment to fill:
+     *       environment &Env;
+     * RETURNS: None.
+     */
+    VOID GetEnvironment( environment &Env ) const
+    {
+      Env.Ambient = AmbientColor, Env.Background = BackgroundColor, Env.Fog = FogColor;
+      Env.FogStart = FogStart, Env.FogEnd = FogEnd;
+      Env.Air = Air;
+      Env.MaxRecLevel = MaxRecLevel;
+    } /* End of 'GetEnvironment' function */
+
+    /* Set scene environment function.
+     * ARGUMENTS:
+     *   - reference at environment:
+     *       const environment &Env;
+     * RETURNS: None.
+     */
+    VOID SetEnvironment( const environment &Env )
+    {
+      AmbientColor = Env.Ambient, BackgroundColor = Env.Background, FogColor = Env.Fog;
+      FogStart = Env.FogStart, FogEnd = Env.FogEnd;
+      Air = Env.Air;
+      MaxRecLevel = Env.MaxRecLevel;
+      Invalidate(CHANGED_SHADING);
+    } /* End of 'SetEnvironment' function */
+
+    /* Set progressive accumulation state function.
+     * Rendering continues from this state if frame and camera are the
+     * same as stored ones (see 'Update'), it restarts overwise.
+     * ARGUMENTS:
+     *   - reference at state:
+     *       const accum_state &State;
+     * RETURNS: None.
+     */
+    VOID SetAccum( const accum_state &State )
+    {
+      Accum.assign(State.Accum.begin(), State.Accum.end());
+      GBuffer.resize(Accum.size());
+      TilesDone.assign(State.TilesDone.begin(), State.TilesDone.end());
+      AccumCount = State.Count;
+      AccumLoc = State.Loc, AccumDir = State.Dir;
+      IsAccumTiled = State.IsTiled;
+      IsPassOpen = std::count(TilesDone.begin(), TilesDone.end(), 0) > 0;
+      AccumMode = SamplingMode();
+      Changes = 0;
+      IsGBufferValid = FALSE;
+      IsReprojected = FALSE;
+      Cache.Invalidate();
+    } /* End of 'SetAccum' function */
+
+    /* Save compiled scene snapshot function.
+     * Shapes, materials, modifiers, light sources, settings, camera and
+     * shapes hierarchy are written as flat records with indices instead
+     * of pointers (see 'scene_snapshot.cpp'), hierarchy is built if needed.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at camera:
+     *       const camera &Cam;
+     * RETURNS:
+     *   (BOOL) TRUE if snapshot is written, FALSE overwise (e.g. shape has no flat description).
+     */
+    BOOL SaveSnapshot( const CHAR *FileName, const camera &Cam );
+
+    /* Load compiled scene snapshot function.
+     * File is memory mapped and checked, scene shapes and light sources
+     * are replaced by snapshot ones and saved hierarchy is used as is.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at camera to set:
+     *       camera &Cam;
+     * RETURNS:
+     *   (BOOL) TRUE if snapshot is loaded, FALSE overwise (scene is not changed).
+     */
+    BOOL LoadSnapshot( const CHAR *FileName, camera &Cam );
+
+    /* Update scene by changed description function.
+     * Shapes and light sources are compared place by place with new
+     * ones by flat descriptions (see 'scene_reload.cpp'): equal ones are
+     * kept, changed materials and modifiers are moved to kept shapes,
+     * changed geometry replaces shapes and refits hierarchy. Everything
+     * is replaced if shapes or lights count is changed. Settings are
+     * copied and accumulation is restarted.
+     * ARGUMENTS:
+     *   - reference at scene with new description (gets replaced content):
+     *       scene &Src;
+     * RETURNS:
+     *   (INT) changed shapes and light sources count.
+     */
+    INT Merge( scene &Src );
+
+    /* Move camera and rebuild hierarchies function.
+     * ARGUMENTS:
+     *   - reference at current camera:
+     *       camera &Cam;
+     * RETURNS: None.
+     */
+    VOID Prepare( camera &Cam );
+
+    /* Prepare scene to frame rendering function.
+     * Moves camera, rebuilds hierarchies and decides what should be
+     * recomputed: nothing (frame is final), shading only (primary hits
+     * of previous frame are reused), pixels not covered by reprojected
+     * previous frame (only camera has moved) or everything.
+     * ARGUMENTS:
+     *   - reference at current camera:
+     *       camera &Cam;
+     *   - reference at frame:
+     *       frame &Frm;
+     * RETURNS:
+     *   (BOOL) TRUE if frame should be rendered, FALSE overwise.
+     */
+    BOOL Update( camera &Cam, frame &Frm );
+
+    /* Check if frames accumulation converges by random samples function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if frames differ by random decisions, FALSE overwise.
+     */
+    BOOL IsStochastic( VOID );
+
+    /* Get sampling modes which change accumulated image function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (UINT) many-lights, jitter and roulette flags with lights budget.
+     */
+    UINT SamplingMode( VOID ) const;
+
     /* Render scene function.
+     * Frame is not resolved if 'IsCancel' is set during rendering. Tiles
+     * done by cancelled pass are kept and next frame renders only other
+     * ones, wavefront or reprojected pass is restarted by next frame.
+     * ARGUMENTS:
+     *   - reference at current camera:
+     *       camera &Cam;
+     *   - reference at frame:
+     *       frame &Frm;
+     * RETURNS:
+     *   (BOOL) TRUE if frame has been changed, FALSE if nothing changed since last frame
+     *          or frame is cancelled.
+     */
+    BOOL Render( camera &Cam, frame &Frm );
+
+    /* Render rectangle of frame pixels function.
+     * Pixels get the same colors as by 'Render' after 'Samples' recursive
+     * passes, so parts of one frame may be rendered by other processes.
+     * ARGUMENTS:
+     *   - reference at current camera (it should be resized to frame):
+     *       camera &Cam;
+     *   - rectangle position and size in frame:
+     *       INT X0, INT Y0, INT W, INT H;
+     *   - samples per pixel (used by stochastic scenes only):
+     *       INT Samples;
+     *   - colors array to fill (3 components per pixel, rows of rectangle):
+     *       FLT *Out;
+     * RETURNS: None.
+     */
+    VOID RenderRect( camera &Cam, INT X0, INT Y0, INT W, INT H, INT Samples, FLT *Out );
+
+    /* Render frame by wavefront pipeline function.
+     * Instead of recursive 'Trace' every bounce generation passes
+     * separate stages over whole arrays of rays: closest hits search,
+     * shading (materials, modifiers and light samples), shadow rays
+     * resolving and gathering to pixels. Stages run in parallel.
+     * ARGUMENTS:
+     *   - reference at current camera:
+     *       camera &Cam;
+     *   - reference at frame:
+     *       frame &Frm;
+     *   - reference at ray path state (for statistics):
+     *       path &Path;
+     *   - flags of pixels to trace (nullptr to trace all pixels):
+     *       const BYTE *Mask;
+     * RETURNS: None.
+     */
+    VOID RenderWavefront( camera &Cam, frame &Frm, path &Path, const BYTE *Mask = nullptr );
+
+    /* Wavefront primary rays generation stage function.
      * ARGUMENTS:
      *   - reference at current camera:
      *       camera &Cam;
      *   - reference at frame:
      *       frame &Frm;
+     *   - reference at rays queue to fill:
+     *       ray_queue &Q;
+     *   - flags of pixels to trace (nullptr to trace all pixels):
+     *       const BYTE *Mask;
+     * RETURNS: None.
+     */
+    VOID WavefrontGenerate( camera &Cam, frame &Frm, ray_queue &Q, const BYTE *Mask );
+
+    /* Wavefront closest hits stage function.
+     * ARGUMENTS:
+     *   - reference at rays queue:
+     *       ray_queue &Q;
+     * RETURNS: None.
+     */
+    VOID WavefrontIntersect( ray_queue &Q );
+
+    /* Wavefront shading stage function.
+     * ARGUMENTS:
+     *   - reference at rays queue:
+     *       ray_queue &Q;
+     *   - wave rays range:
+     *       INT Start, End;
+     *   - shadow slots per ray:
+     *       INT Slots;
+     *   - reference at ray path state (for statistics):
+     *       path &Path;
+     * RETURNS: None.
+     */
+    VOID WavefrontShade( ray_queue &Q, INT Start, INT End, INT Slots, path &Path );
+
+    /* Wavefront shadow rays stage function.
+     * ARGUMENTS:
+     *   - shadow slots count:
+     *       INT Count;
      * RETURNS: None.
      */
-    VOID Render( camera &Cam, frame &Frm );
+    VOID WavefrontShadow( INT Count );
+
+    /* Wavefront gathering stage function.
+     * Adds wave colors to accumulation buffer and moves
+     * secondary rays to next generation.
+     * ARGUMENTS:
+     *   - reference at rays queue:
+     *       ray_queue &Q;
+     *   - wave rays range:
+     *       INT Start, End;
+     *   - shadow slots per ray:
+     *       INT Slots;
+     *   - reference at next generation queue:
+     *       ray_queue &Next;
+     * RETURNS: None.
+     */
+    VOID WavefrontGather( ray_queue &Q, INT Start, INT End, INT Slots, ray_queue &Next );
 
     /* Trace ray in scene function.
      * ARGUMENTS:
      *   - reference at ray:
      *       const ray &Ray;
+     *   - reference at ray differentials:
+     *       const ray_diff &Diff;
      *   - reference at tracing environment:
      *       const envi &Media;
      *   - weigth:
      *       DBL Weight;
-     *   - is recurcy ray tracing avaible flag:
-     *       BOOL IsRecAvaible;
+     *   - reference at ray path state:
+     *       path &Path;
+     *   - pointer at already found closest hit (nullptr to find it):
+     *       const intr *Hit;
      * RETURNS:
      *   (vec3) Pixel color.
      */
-    vec3 Trace( const ray &Ray, const envi &Media, DBL Weight, BOOL IsRecAvaible );
+    vec3 Trace( const ray &Ray, const ray_diff &Diff, const envi &Media, DBL Weight, path &Path, const intr *Hit = nullptr );
 
     /* Find intersection with ray function.
      * ARGUMENTS:
@@ -134,16 +502,119 @@ namespace dart
      * ARGUMENTS:
      *   - reference at light direction:
      *       const vec3 &V;
+     *   - reference at ray differentials:
+     *       const ray_diff &Diff;
      *   - reference at tracing environment:
      *       const envi &Media;
      *   - point at intersection:
      *       const intr *In;
      *   - weigth:
      *       DBL Weight;
+     *   - reference at ray path state:
+     *       path &Path;
      * RETURNS:
      *   (vec3) Pixel color.
      */
-    vec3 Shade( const vec3 &V, const envi &Media, intr *In, DBL Weight );
+    vec3 Shade( const vec3 &V, const ray_diff &Diff, const envi &Media, intr *In, DBL Weight, path &Path );
+
+    /* Apply shapes modifiers to shading points function.
+     * Points are grouped by shapes, so every modifier is called once
+     * for all points of its shape (textures evaluate them by packs).
+     * ARGUMENTS:
+     *   - shading parameters array (points with no shape are skipped):
+     *       shade_info *Si;
+     *   - points count:
+     *       INT Count;
+     * RETURNS: None.
+     */
+    VOID ApplyModifiers( shade_info *Si, INT Count );
+
+    /* Get local (ambient and light sources) color of point function.
+     * ARGUMENTS:
+     *   - reference at light direction:
+     *       const vec3 &V;
+     *   - reference at shading parameters (shape modifiers are applied already):
+     *       shade_info &Si;
+     *   - pointer at reflected view direction:
+     *       vec3 *R;
+     *   - reference at ray path state:
+     *       path &Path;
+     *   - pointer at shadow rays batch to defer shadow tests to
+     *     (nullptr to test shadows immediately):
+     *       shadow_batch *Batch;
+     *   - first batch slot to fill:
+     *       INT First;
+     *   - pointer at filled batch slots count:
+     *       INT *Count;
+     * RETURNS:
+     *   (vec3) Point color without secondary rays (and without
+     *          deferred light samples).
+     */
+    vec3 Illuminate( const vec3 &V, shade_info &Si, vec3 *R, path &Path,
+                     shadow_batch *Batch = nullptr, INT First = 0, INT *Count = nullptr );
+
+    /* Get maximum light samples per shading point function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) light samples count.
+     */
+    INT LightSamples( VOID );
+
+    /* Get refracted direction function.
+     * ARGUMENTS:
+     *   - reference at light direction:
+     *       const vec3 &V;
+     *   - reference at surface normal:
+     *       const vec3 &N;
+     * RETURNS:
+     *   (vec3) Refracted direction.
+     */
+    static vec3 Refract( const vec3 &V, const vec3 &N );
+
+    /* Get one light source contribution function.
+     * ARGUMENTS:
+     *   - reference at shading parameters:
+     *       const shade_info &Si;
+     *   - reference at reflected view direction:
+     *       const vec3 &R;
+     *   - pointer at light source:
+     *       lgh::light *Lgh;
+     * RETURNS:
+     *   (vec3) Light source color contribution (zero if shadowed).
+     */
+    vec3 ShadeLight( const shade_info &Si, const vec3 &R, lgh::light *Lgh );
+
+    /* Get one light source contribution without shadow test function.
+     * ARGUMENTS:
+     *   - reference at shading parameters:
+     *       const shade_info &Si;
+     *   - reference at reflected view direction:
+     *       const vec3 &R;
+     *   - pointer at light source:
+     *       lgh::light *Lgh;
+     *   - pointer at light source parameters:
+     *       lgh::light_info *Info;
+     * RETURNS:
+     *   (vec3) Light source color contribution.
+     */
+    vec3 LightColor( const shade_info &Si, const vec3 &R, lgh::light *Lgh, lgh::light_info *Info );
+
+    /* Decide if secondary ray should be traced function.
+     * ARGUMENTS:
+     *   - secondary ray weight:
+     *       DBL W;
+     *   - reflection (TRUE) or refraction (FALSE) ray flag:
+     *       BOOL IsRefl;
+     *   - reference at shading surface:
+     *       const surface &Surf;
+     *   - reference at ray path state:
+     *       path &Path;
+     *   - pointer at ray survival probability (to divide ray color by):
+     *       DBL *Q;
+     * RETURNS:
+     *   (BOOL) TRUE if ray should be traced, FALSE overwise.
+     */
+    BOOL Continue( DBL W, BOOL IsRefl, const surface &Surf, path &Path, DBL *Q );
   }; /* End of 'scene' class */
 }/* end of 'dart' namespace */
 
@@ -0,0 +1,717 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : scene_file.cpp
+ * PURPOSE     : Raytracing project.
+ *               Scene description files loading implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "rt/scene_file.h"
+#include "rt/shapes/shape.h"
+
+namespace dart
+{
+  /* Check if character separates tokens function.
+   * ARGUMENTS:
+   *   - character:
+   *       CHAR Ch;
+   * RETURNS:
+   *   (BOOL) TRUE if character is space or comment start, FALSE overwise.
+   */
+  static BOOL IsSeparator( CHAR Ch )
+  {
+    return Ch == ' ' || Ch == '\t' || Ch == '\r' || Ch == '\n' || Ch == '#';
+  } /* End of 'IsSeparator' function */
+
+  /* Compare token with keyword function.
+   * ARGUMENTS:
+   *   - token start and length:
+   *       const CHAR *S, INT Len;
+   *   - keyword:
+   *       const CHAR *Kw;
+   * RETURNS:
+   *   (BOOL) TRUE if token is keyword, FALSE overwise.
+   */
+  static BOOL IsKeyword( const CHAR *S, INT Len, const CHAR *Kw )
+  {
+    return strncmp(S, Kw, Len) == 0 && Kw[Len] == 0;
+  } /* End of 'IsKeyword' function */
+
+  /* Convert text to number function.
+   * Numbers with up to 15 significant digits and decimal exponent up to
+   * 22 are exact in double arithmetics (and correctly rounded by one
+   * multiplication or division), others are converted by 'strtod'.
+   * ARGUMENTS:
+   *   - number text (not zero-terminated):
+   *       const CHAR *S, *E;
+   *   - pointer at number to fill:
+   *       DBL *X;
+   * RETURNS:
+   *   (BOOL) TRUE if whole text is number, FALSE overwise.
+   */
+  static BOOL ToNumber( const CHAR *S, const CHAR *E, DBL *X )
+  {
+    static const DBL Pow10[] =
+    {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const CHAR *p = S;
+    BOOL IsNeg = FALSE;
+    UINT64 m = 0;
+    INT digits = 0, sig = 0, exp = 0;
+
+    if (p < E && (*p == '-' || *p == '+'))
+      IsNeg = *p++ == '-';
+    for (; p < E && *p >= '0' && *p <= '9'; p++, digits++)
+    {
+      if (sig < 19 && (m != 0 || *p != '0'))
+        m = m * 10 + (*p - '0'), sig++;
+      else if (m != 0)
+        sig++, exp++;
+    }
+    if (p < E && *p == '.')
+      for (p++; p < E && *p >= '0' && *p <= '9'; p++, digits++)
+      {
+        if (sig < 19 && (m != 0 || *p != '0'))
+          m = m * 10 + (*p - '0'), sig++, exp--;
+        else if (m != 0)
+          sig++;
+        else
+          exp--;
+      }
+    if (digits == 0)
+      return FALSE;
+    if (p < E && (*p == 'e' || *p == 'E'))
+    {
+      BOOL IsExpNeg = FALSE;
+      INT e = 0;
+
+      if (++p < E && (*p == '-' || *p == '+'))
+        IsExpNeg = *p++ == '-';
+      if (p == E || *p < '0' || *p > '9')
+        return FALSE;
+      for (; p < E && *p >= '0' && *p <= '9'; p++)
+        e = COM_MIN(e * 10 + (*p - '0'), 100000);
+      exp += IsExpNeg ? -e : e;
+    }
+    if (p != E)
+      return FALSE;
+
+    if (sig <= 15 && exp >= -22 && exp <= 22)
+    {
+      DBL x = (DBL)m;
+
+      x = exp < 0 ? x / Pow10[-exp] : x * Pow10[exp];
+      *X = IsNeg ? -x : x;
+      return TRUE;
+    }
+
+    // long numbers are rare, so library conversion is used
+    CHAR Buf[64];
+    CHAR *End;
+
+    if (E - S >= (INT)sizeof(Buf))
+      return FALSE;
+    memcpy(Buf, S, E - S);
+    Buf[E - S] = 0;
+    *X = strtod(Buf, &End);
+    return End == Buf + (E - S);
+  } /* End of 'ToNumber' function */
+
+  /* Skip spaces and comments function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) TRUE if there is next token, FALSE at text end.
+   */
+  BOOL scene_file::Skip( VOID )
+  {
+    while (Ptr < End)
+      if (*Ptr == '\n')
+        Line++, Ptr++;
+      else if (*Ptr == ' ' || *Ptr == '\t' || *Ptr == '\r')
+        Ptr++;
+      else if (*Ptr == '#')
+        while (Ptr < End && *Ptr != '\n')
+          Ptr++;
+      else
+        return TRUE;
+    return FALSE;
+  } /* End of 'Skip' function */
+
+  /* Read next token function.
+   * ARGUMENTS:
+   *   - pointer at token to fill:
+   *       token *T;
+   * RETURNS:
+   *   (BOOL) TRUE if token is read, FALSE overwise.
+   */
+  BOOL scene_file::Token( token *T )
+  {
+    if (!Skip())
+      return Fail("unexpected end of file");
+    if (*Ptr == '"')
+    {
+      const CHAR *S = ++Ptr;
+
+      while (Ptr < End && *Ptr != '"' && *Ptr != '\n')
+        Ptr++;
+      if (Ptr == End || *Ptr != '"')
+        return Fail("unterminated name");
+      T->S = S, T->Len = (INT)(Ptr++ - S);
+      return TRUE;
+    }
+    T->S = Ptr;
+    while (Ptr < End && !IsSeparator(*Ptr))
+      Ptr++;
+    T->Len = (INT)(Ptr - T->S);
+    return TRUE;
+  } /* End of 'Token' function */
+
+  /* Check if next token is number function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) TRUE if next token starts as number, FALSE overwise.
+   */
+  BOOL scene_file::IsNumberNext( VOID )
+  {
+    return Skip() && ((*Ptr >= '0' && *Ptr <= '9') || *Ptr == '-' || *Ptr == '+' || *Ptr == '.');
+  } /* End of 'IsNumberNext' function */
+
+  /* Read number function.
+   * ARGUMENTS:
+   *   - pointer at number to fill:
+   *       DBL *X;
+   * RETURNS:
+   *   (BOOL) TRUE if number is read, FALSE overwise.
+   */
+  BOOL scene_file::Number( DBL *X )
+  {
+    token T;
+
+    if (!Skip())
+      return Fail("number expected at end of file");
+    T.S = Ptr;
+    while (Ptr < End && !IsSeparator(*Ptr))
+      Ptr++;
+    T.Len = (INT)(Ptr - T.S);
+    if (!ToNumber(T.S, Ptr, X))
+      return Fail("number expected", &T);
+    return std::isfinite(*X) || Fail("number is out of range", &T);
+  } /* End of 'Number' function */
+
+  /* Read integer number function.
+   * ARGUMENTS:
+   *   - pointer at number to fill:
+   *       INT *X;
+   * RETURNS:
+   *   (BOOL) TRUE if number is read, FALSE overwise.
+   */
+  BOOL scene_file::Integer( INT *X )
+  {
+    DBL x;
+
+    if (!Number(&x))
+      return FALSE;
+    if (x != floor(x) || x < -2147483647.0 || x > 2147483647.0)
+      return Fail("integer expected");
+    *X = (INT)x;
+    return TRUE;
+  } /* End of 'Integer' function */
+
+  /* Read vector function.
+   * ARGUMENTS:
+   *   - pointer at vector to fill:
+   *       vec3 *V;
+   * RETURNS:
+   *   (BOOL) TRUE if vector is read, FALSE overwise.
+   */
+  BOOL scene_file::Vector( vec3 *V )
+  {
+    DBL x, y, z;
+
+    if (!Number(&x) || !Number(&y) || !Number(&z))
+      return FALSE;
+    *V = vec3(x, y, z);
+    return TRUE;
+  } /* End of 'Vector' function */
+
+  /* Read material reference function.
+   * ARGUMENTS:
+   *   - pointer at material to fill:
+   *       surface *Surf;
+   * RETURNS:
+   *   (BOOL) TRUE if material is read, FALSE overwise.
+   */
+  BOOL scene_file::Material( surface *Surf )
+  {
+    token T;
+
+    if (!Token(&T))
+      return FALSE;
+    if (IsKeyword(T.S, T.Len, "solid"))
+    {
+      vec3 Color;
+
+      if (!Vector(&Color))
+        return FALSE;
+      *Surf = SOLID_MTL(Color);
+      return TRUE;
+    }
+
+    // neighbour shapes usually share material, so its name is compared first
+    if (LastMtlIndex < 0 || T.Len != LastMtl.Len || memcmp(T.S, LastMtl.S, T.Len) != 0)
+    {
+      INT Mtl = Mtls.Find(std::string(T.S, T.Len));
+
+      if (Mtl < 0)
+        return Fail("unknown material", &T);
+      LastMtl = T;
+      LastMtlIndex = Mtl;
+    }
+    *Surf = Mtls[LastMtlIndex];
+    return TRUE;
+  } /* End of 'Material' function */
+
+  /* Read file name function.
+   * ARGUMENTS:
+   *   - pointer at file path to fill (relative names are taken from scene file directory):
+   *       std::string *Name;
+   *   - pointer at name token to fill (for error messages):
+   *       token *T;
+   * RETURNS:
+   *   (BOOL) TRUE if file name is read, FALSE overwise.
+   */
+  BOOL scene_file::FileName( std::string *Name, token *T )
+  {
+    if (!Token(T))
+      return FALSE;
+
+    BOOL IsAbsolute = T->Len > 0 && (T->S[0] == '/' || T->S[0] == '\\' || (T->Len > 1 && T->S[1] == ':'));
+
+    *Name = IsAbsolute ? std::string(T->S, T->Len) : Dir + std::string(T->S, T->Len);
+    return TRUE;
+  } /* End of 'FileName' function */
+
+  /* Read shape modifiers function.
+   * ARGUMENTS:
+   *   - reference at shape:
+   *       shape *Shp;
+   * RETURNS:
+   *   (BOOL) TRUE if modifiers are read, FALSE overwise.
+   */
+  BOOL scene_file::Modifiers( shape *Shp )
+  {
+    for (;;)
+    {
+      const CHAR *Start = Ptr;
+      INT StartLine = Line;
+      token T;
+      DBL x;
+      vec3 C0, C1;
+
+      if (!Skip())
+        return TRUE;
+      Token(&T);
+      if (IsKeyword(T.S, T.Len, "cheker"))
+      {
+        if (!Number(&x))
+          return FALSE;
+        if (x <= 0)
+          return Fail("cheker cell size should be positive");
+        (*Shp)[new cheker(x)];
+      }
+      else if (IsKeyword(T.S, T.Len, "rotator"))
+      {
+        if (!Number(&x))
+          return FALSE;
+        (*Shp)[new rotator(x)];
+      }
+      else if (IsKeyword(T.S, T.Len, "noise") || IsKeyword(T.S, T.Len, "marble") || IsKeyword(T.S, T.Len, "wood"))
+      {
+        if (!Number(&x) || !Vector(&C0) || !Vector(&C1))
+          return FALSE;
+        if (x <= 0)
+          return Fail("texture scale should be positive");
+        (*Shp)[IsKeyword(T.S, T.Len, "noise") ? texture::Noise(x, C0, C1) :
+               IsKeyword(T.S, T.Len, "marble") ? texture::Marble(x, C0, C1) : texture::Wood(x, C0, C1)];
+      }
+      else if (IsKeyword(T.S, T.Len, "gradient"))
+      {
+        vec3 Dir;
+
+        if (!Vector(&Dir) || !Vector(&C0) || !Vector(&C1))
+          return FALSE;
+        (*Shp)[texture::Gradient(Dir, C0, C1)];
+      }
+      else if (IsKeyword(T.S, T.Len, "image"))
+      {
+        std::string Name;
+        token N;
+
+        if (!FileName(&Name, &N) || !Number(&x))
+          return FALSE;
+        if (x <= 0)
+          return Fail("image size should be positive");
+
+        std::shared_ptr<tiled_image> Img = tiled_image::Share(Name);
+
+        if (Img == nullptr)
+          return Fail("image file is not found or it is not tiled image", &N);
+        (*Shp)[new image_texture(Img, x)];
+      }
+      else
+      {
+        // other statement starts here
+        Ptr = Start, Line = StartLine;
+        return TRUE;
+      }
+    }
+  } /* End of 'Modifiers' function */
+
+  /* Read shape function.
+   * ARGUMENTS:
+   *   - shape keyword token:
+   *       const token &Kw;
+   *   - pointer at created shape (nullptr if keyword is not shape one):
+   *       shape **Shp;
+   * RETURNS:
+   *   (BOOL) TRUE if shape is read or keyword is not shape, FALSE overwise.
+   */
+  BOOL scene_file::Shape( const token &Kw, shape **Shp )
+  {
+    vec3 A, B, C;
+    DBL x;
+    surface Surf;
+
+    *Shp = nullptr;
+    if (IsKeyword(Kw.S, Kw.Len, "sphere"))
+    {
+      if (!Vector(&A) || !Number(&x) || !Material(&Surf))
+        return FALSE;
+      if (x <= 0)
+        return Fail("sphere radius should be positive");
+      *Shp = new sphere(A, x, Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "cube"))
+    {
+      if (!Vector(&A) || !Vector(&B) || !Material(&Surf))
+        return FALSE;
+      *Shp = new cube(A, B, Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "plane"))
+    {
+      if (!Vector(&A) || !Vector(&B) || !Vector(&C) || !Material(&Surf))
+        return FALSE;
+      if ((!((A - B) % (A - C))) < Threshold)
+        return Fail("plane points are on one line");
+      *Shp = new plane(A, B, C, Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "cylinder"))
+    {
+      if (!Vector(&A) || !Vector(&B) || !Number(&x) || !Material(&Surf))
+        return FALSE;
+      *Shp = new cylinder(A, B, x, Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "triangle"))
+    {
+      vec3 N0, N1, N2;
+
+      if (!Vector(&A) || !Vector(&B) || !Vector(&C))
+        return FALSE;
+      if (IsNumberNext())
+      {
+        if (!Vector(&N0) || !Vector(&N1) || !Vector(&N2))
+          return FALSE;
+      }
+      else
+        N0 = N1 = N2 = (B - A) % (C - A);
+      if (!Material(&Surf))
+        return FALSE;
+      *Shp = new triangle(A, B, C, N0, N1, N2, Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "model"))
+    {
+      token T;
+      std::string Name;
+
+      if (!FileName(&Name, &T) || !Material(&Surf))
+        return FALSE;
+
+      FILE *F = fopen(Name.c_str(), "r");
+
+      if (F == nullptr)
+        return Fail("model file is not found", &T);
+      fclose(F);
+      *Shp = new model(Name.c_str(), Surf);
+    }
+    else if (IsKeyword(Kw.S, Kw.Len, "intersection") || IsKeyword(Kw.S, Kw.Len, "substract"))
+    {
+      shape *ShpA = nullptr, *ShpB = nullptr;
+      token T;
+
+      for (shape **Arg : {&ShpA, &ShpB})
+        if (!Token(&T) || !Shape(T, Arg) || *Arg == nullptr)
+        {
+          delete ShpA;
+          return *Arg == nullptr && Error.empty() ? Fail("shape expected", &T) : FALSE;
+        }
+      if (Kw.S[0] == 'i')
+        *Shp = new csg::intersection(ShpA, ShpB);
+      else
+        *Shp = new csg::substract(ShpA, ShpB);
+    }
+    else
+      return TRUE;
+
+    if (!Modifiers(*Shp))
+    {
+      delete *Shp;
+      *Shp = nullptr;
+      return FALSE;
+    }
+    return TRUE;
+  } /* End of 'Shape' function */
+
+  /* Set error function.
+   * ARGUMENTS:
+   *   - error message:
+   *       const CHAR *Message;
+   *   - pointer at wrong token (may be nullptr):
+   *       const token *T;
+   * RETURNS:
+   *   (BOOL) FALSE.
+   */
+  BOOL scene_file::Fail( const CHAR *Message, const token *T )
+  {
+    CHAR Buf[200];
+
+    if (T != nullptr)
+    {
+      const CHAR *L = T->S;
+
+      while (L > Begin && L[-1] != '\n')
+        L--;
+      snprintf(Buf, sizeof(Buf), "line %d, column %d: %s '%.*s'",
+        Line, (INT)(T->S - L) + 1, Message, COM_MIN(T->Len, 60), T->S);
+    }
+    else
+      snprintf(Buf, sizeof(Buf), "line %d: %s", Line, Message);
+    Error = Buf;
+    return FALSE;
+  } /* End of 'Fail' function */
+
+  /* Load scene description file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const CHAR *FileName;
+   *   - reference at scene to add shapes, lights and settings to:
+   *       scene &Scene;
+   *   - reference at camera:
+   *       camera &Cam;
+   * RETURNS:
+   *   (BOOL) TRUE if file is loaded, FALSE overwise ('Error' is set).
+   */
+  BOOL scene_file::Load( const CHAR *FileName, scene &Scene, camera &Cam )
+  {
+    FILE *F = fopen(FileName, "rb");
+    stock<CHAR> Text;
+
+    Line = 0;
+    if (F == nullptr)
+    {
+      Error = std::string(FileName) + ": file is not found";
+      return FALSE;
+    }
+    fseek(F, 0, SEEK_END);
+    LONG Size = ftell(F);
+    fseek(F, 0, SEEK_SET);
+    if (Size > 0)
+    {
+      Text.resize(Size);
+      Size = (LONG)fread(Text.data(), 1, Size, F);
+    }
+    fclose(F);
+    if (Size < 0)
+    {
+      Error = std::string(FileName) + ": file is not read";
+      return FALSE;
+    }
+
+    std::string Name(FileName);
+    size_t Slash = Name.find_last_of("/\\");
+
+    if (Parse(Text.data(), Size, Slash == std::string::npos ? "" : Name.substr(0, Slash + 1), Scene, Cam))
+      return TRUE;
+    Error = Name + ": " + Error;
+    return FALSE;
+  } /* End of 'Load' function */
+
+  /* Load scene description from memory function.
+   * ARGUMENTS:
+   *   - description text (not necessarily zero-terminated):
+   *       const CHAR *Text, size_t Size;
+   *   - directory of relative files paths (empty or with separator):
+   *       const std::string &BaseDir;
+   *   - reference at scene to add shapes, lights and settings to:
+   *       scene &Scene;
+   *   - reference at camera:
+   *       camera &Cam;
+   * RETURNS:
+   *   (BOOL) TRUE if description is loaded, FALSE overwise ('Error' is set).
+   */
+  BOOL scene_file::Parse( const CHAR *Text, size_t Size, const std::string &BaseDir, scene &Scene, camera &Cam )
+  {
+    Begin = Ptr = Text, End = Text + Size;
+    Dir = BaseDir;
+    Line = 1;
+    Error.clear();
+    LastMtl = {nullptr, 0}, LastMtlIndex = -1;
+
+    // everything is read to copies and applied when whole file is valid
+    scene::environment Env;
+    policy Policy = Scene.Policy;
+    INT MaxAccumCount = Scene.MaxAccumCount, LightsBudget = Scene.LightsBudget;
+    BOOL IsWavefront = Scene.IsWavefront, IsManyLights = Scene.IsManyLights, IsJitter = Scene.IsJitter, IsCamera = FALSE;
+    DBL CamDist = Scene.CamDist;
+    INT TextureMemory = (INT)(tile_cache::Get().GetBudget() >> 20);
+    vec3 Loc, At, Up;
+    stock<shape *> Shapes;
+    stock<lgh::light *> Lights;
+    BOOL IsOk = TRUE;
+
+    Scene.GetEnvironment(Env);
+    while (IsOk && Skip())
+    {
+      token Kw;
+      shape *Shp;
+      vec3 A, B, C;
+      DBL x, y;
+      INT n;
+
+      Token(&Kw);
+      if (!(IsOk = Shape(Kw, &Shp)))
+        break;
+      if (Shp != nullptr)
+        Shapes.push_back(Shp);
+      else if (IsKeyword(Kw.S, Kw.Len, "point"))
+      {
+        if ((IsOk = Vector(&A) && Vector(&B)))
+          Lights.push_back(new lgh::point(A, B));
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "direct"))
+      {
+        if ((IsOk = Vector(&A) && Vector(&B)))
+          Lights.push_back(new lgh::direct(A, B));
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "spot"))
+      {
+        if ((IsOk = Vector(&A) && Vector(&B) && Number(&x) && Number(&y) && Vector(&C)))
+          Lights.push_back(new lgh::spot(A, B, x, y, C));
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "material"))
+      {
+        token T;
+        surface Surf;
+
+        if ((IsOk = Token(&T) && Vector(&Surf.Ka) && Vector(&Surf.Kd) && Vector(&Surf.Ks) &&
+                    Number(&Surf.Kr) && Number(&Surf.Kt) && Number(&Surf.Ph) &&
+                    (!IsNumberNext() || Integer(&Surf.MaxLevel))))
+        {
+          if (IsKeyword(T.S, T.Len, "solid"))
+            IsOk = Fail("material name is reserved", &T);
+          else
+            Mtls.Add(std::string(T.S, T.Len), Surf);
+        }
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "background"))
+        IsOk = Vector(&Env.Background);
+      else if (IsKeyword(Kw.S, Kw.Len, "ambient"))
+        IsOk = Vector(&Env.Ambient);
+      else if (IsKeyword(Kw.S, Kw.Len, "fog"))
+        IsOk = Vector(&Env.Fog) && Number(&Env.FogStart) && Number(&Env.FogEnd);
+      else if (IsKeyword(Kw.S, Kw.Len, "air"))
+      {
+        if ((IsOk = Number(&x) && Number(&y)))
+          Env.Air = envi(x, y);
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "depth"))
+        IsOk = Integer(&Env.MaxRecLevel);
+      else if (IsKeyword(Kw.S, Kw.Len, "samples"))
+        IsOk = Integer(&MaxAccumCount) && (MaxAccumCount > 0 || Fail("samples count should be positive"));
+      else if (IsKeyword(Kw.S, Kw.Len, "roulette"))
+      {
+        if ((IsOk = Integer(&n)))
+          Policy.IsRoulette = n != 0;
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "lights_budget"))
+      {
+        if ((IsOk = Integer(&n)))
+          IsManyLights = n > 0, LightsBudget = n > 0 ? n : LightsBudget;
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "wavefront"))
+      {
+        if ((IsOk = Integer(&n)))
+          IsWavefront = n != 0;
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "antialias"))
+      {
+        if ((IsOk = Integer(&n)))
+          IsJitter = n != 0;
+      }
+      else if (IsKeyword(Kw.S, Kw.Len, "orbit"))
+        IsOk = Number(&CamDist);
+      else if (IsKeyword(Kw.S, Kw.Len, "camera"))
+        IsOk = IsCamera = Vector(&Loc) && Vector(&At) && Vector(&Up);
+      else if (IsKeyword(Kw.S, Kw.Len, "texture_memory"))
+        IsOk = Integer(&TextureMemory) && (TextureMemory > 0 || Fail("texture memory should be positive"));
+      else
+        IsOk = Fail("unknown statement", &Kw);
+    }
+
+    if (!IsOk)
+    {
+      for (auto shp : Shapes)
+        delete shp;
+      for (auto lgh : Lights)
+        delete lgh;
+      return FALSE;
+    }
+
+    Scene.SetEnvironment(Env);
+    Scene.Policy = Policy;
+    Scene.MaxAccumCount = MaxAccumCount;
+    Scene.IsWavefront = IsWavefront;
+    Scene.IsJitter = IsJitter;
+    Scene.IsManyLights = IsManyLights, Scene.LightsBudget = LightsBudget;
+    Scene.CamDist = CamDist;
+    tile_cache::Get().SetBudget((size_t)TextureMemory << 20);
+    if (IsCamera)
+    {
+      Cam.Set(Loc, At, Up);
+      Scene.Timer.IsPause = TRUE;
+    }
+    for (auto shp : Shapes)
+      Scene << shp;
+    for (auto lgh : Lights)
+      Scene << lgh;
+    ShapesCount = (INT)Shapes.size();
+    LightsCount = (INT)Lights.size();
+    return TRUE;
+  } /* End of 'Parse' function */
+} /* end of 'dart' namespace */
+
+/* END OF 'scene_file.cpp' FILE */
@@ -0,0 +1,218 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : scene_file.h
+ * PURPOSE     : Raytracing project.
+ *               Scene description files loading module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __scene_file_h_
+#define __scene_file_h_
+
+#include <string>
+
+#include "rt/scene.h"
+#include "rt/mtl_lib.h"
+
+namespace dart
+{
+  /* Scene description file loader class.
+   * File is a sequence of statements separated by spaces or new lines,
+   * '#' starts comment up to line end, names with spaces are quoted.
+   * Vectors (V) are three numbers, materials (M) are names of defined or
+   * standard materials or 'solid R G B'. Shapes may be followed by
+   * modifiers ('cheker Size', 'rotator DegreesPerSecond' around Y axis)
+   * procedural textures ('noise|marble|wood Scale V V', 'gradient
+   * Dir V V' with colors for pattern values 0 and 1) and image textures
+   * ('image "File.dtx" Size', tiled images built by "-mktex" option).
+   *
+   *   background V               ambient V
+   *   fog V Start End            air Refraction Decay
+   *   depth MaxRecLevel          samples MaxAccumCount
+   *   roulette 0|1               lights_budget Count (many-lights mode)
+   *   wavefront 0|1              orbit CameraDistance
+   *   antialias 0|1              (jittered samples, scene is accumulated)
+   *   camera Loc At Up           (fixed camera, scene timer is paused)
+   *   texture_memory Megabytes   (decoded image tiles cache size)
+   *   material Name Ka Kd Ks Kr Kt Ph [MaxLevel]
+   *   point Pos Color            direct Dir Color
+   *   spot Pos Dir Angle1 Angle2 Color
+   *   sphere Center Radius M     cube Min Max M
+   *   plane P0 P1 P2 M           cylinder Center Axis Height M
+   *   triangle P0 P1 P2 [N0 N1 N2] M
+   *   model "File.obj" M         (path is relative to scene file)
+   *   intersection Shape Shape   substract Shape Shape
+   *
+   * File is parsed in one pass from memory, materials names are
+   * resolved to library indices once per statement (repeated names are
+   * not looked up again). Scene is changed only if whole file is valid.
+   */
+  class scene_file
+  {
+    /* File token structure */
+    struct token
+    {
+      const CHAR *S; // Token start
+      INT Len;       // Token length (without quotes)
+    };
+
+    const CHAR *Begin, *Ptr, *End; // Parsed text start, position and end
+    std::string Dir;               // Scene file directory (with separator)
+    token LastMtl;                 // Last referenced material name
+    INT LastMtlIndex;              // Last referenced material index
+
+    /* Skip spaces and comments function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if there is next token, FALSE at text end.
+     */
+    BOOL Skip( VOID );
+
+    /* Read next token function.
+     * ARGUMENTS:
+     *   - pointer at token to fill:
+     *       token *T;
+     * RETURNS:
+     *   (BOOL) TRUE if token is read, FALSE overwise.
+     */
+    BOOL Token( token *T );
+
+    /* Check if next token is number function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if next token starts as number, FALSE overwise.
+     */
+    BOOL IsNumberNext( VOID );
+
+    /* Read number function.
+     * ARGUMENTS:
+     *   - pointer at number to fill:
+     *       DBL *X;
+     * RETURNS:
+     *   (BOOL) TRUE if number is read, FALSE overwise.
+     */
+    BOOL Number( DBL *X );
+
+    /* Read integer number function.
+     * ARGUMENTS:
+     *   - pointer at number to fill:
+     *       INT *X;
+     * RETURNS:
+     *   (BOOL) TRUE if number is read, FALSE overwise.
+     */
+    BOOL Integer( INT *X );
+
+    /* Read vector function.
+     * ARGUMENTS:
+     *   - pointer at vector to fill:
+     *       vec3 *V;
+     * RETURNS:
+     *   (BOOL) TRUE if vector is read, FALSE overwise.
+     */
+    BOOL Vector( vec3 *V );
+
+    /* Read material reference function.
+     * ARGUMENTS:
+     *   - pointer at material to fill:
+     *       surface *Surf;
+     * RETURNS:
+     *   (BOOL) TRUE if material is read, FALSE overwise.
+     */
+    BOOL Material( surface *Surf );
+
+    /* Read file name function.
+     * ARGUMENTS:
+     *   - pointer at file path to fill (relative names are taken from scene file directory):
+     *       std::string *Name;
+     *   - pointer at name token to fill (for error messages):
+     *       token *T;
+     * RETURNS:
+     *   (BOOL) TRUE if file name is read, FALSE overwise.
+     */
+    BOOL FileName( std::string *Name, token *T );
+
+    /* Read shape modifiers function.
+     * ARGUMENTS:
+     *   - reference at shape:
+     *       shape *Shp;
+     * RETURNS:
+     *   (BOOL) TRUE if modifiers are read, FALSE overwise.
+     */
+    BOOL Modifiers( shape *Shp );
+
+    /* Read shape function.
+     * ARGUMENTS:
+     *   - shape keyword token:
+     *       const token &Kw;
+     *   - pointer at created shape (nullptr if keyword is not shape one):
+     *       shape **Shp;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is read or keyword is not shape, FALSE overwise.
+     */
+    BOOL Shape( const token &Kw, shape **Shp );
+
+    /* Set error function.
+     * ARGUMENTS:
+     *   - error message:
+     *       const CHAR *Message;
+     *   - pointer at wrong token (may be nullptr):
+     *       const token *T;
+     * RETURNS:
+     *   (BOOL) FALSE.
+     */
+    BOOL Fail( const CHAR *Message, const token *T = nullptr );
+
+  public:
+    mtl_lib Mtls;      // Materials (standard and defined by files)
+    INT Line;          // Current (error) line number
+    std::string Error; // Last error message, empty if there was no error
+    INT ShapesCount;   // Shapes count of last loaded file
+    INT LightsCount;   // Light sources count of last loaded file
+
+    /* Class constructor */
+    scene_file( VOID ) :
+      Begin(nullptr), Ptr(nullptr), End(nullptr), LastMtl{nullptr, 0}, LastMtlIndex(-1), Line(0), ShapesCount(0), LightsCount(0)
+    {
+    } /* End of 'scene_file' function */
+
+    /* Load scene description file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - reference at scene to add shapes, lights and settings to:
+     *       scene &Scene;
+     *   - reference at camera:
+     *       camera &Cam;
+     * RETURNS:
+     *   (BOOL) TRUE if file is loaded, FALSE overwise ('Error' is set).
+     */
+    BOOL Load( const CHAR *FileName, scene &Scene, camera &Cam );
+
+    /* Load scene description from memory function.
+     * ARGUMENTS:
+     *   - description text (not necessarily zero-terminated):
+     *       const CHAR *Text, size_t Size;
+     *   - directory of relative files paths (empty or with separator):
+     *       const std::string &BaseDir;
+     *   - reference at scene to add shapes, lights and settings to:
+     *       scene &Scene;
+     *   - reference at camera:
+     *       camera &Cam;
+     * RETURNS:
+     *   (BOOL) TRUE if description is loaded, FALSE overwise ('Error' is set).
+     */
+    BOOL Parse( const CHAR *Text, size_t Size, const std::string &BaseDir, scene &Scene, camera &Cam );
+  }; /* End of 'scene_file' class */
+} /* end of 'dart' namespace */
+
+#endif // __scene_file_h_
+
+/* END OF 'scene_file.h' FILE */
@@ -0,0 +1,202 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : scene_reload.cpp
+ * PURPOSE     : Raytracing project.
+ *               Scene hot reload implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#include <utility>
+
+#include "rt/scene.h"
+
+namespace dart
+{
+  /* Compare vectors function.
+   * ARGUMENTS:
+   *   - references at vectors:
+   *       const vec3 &A, &B;
+   * RETURNS:
+   *   (BOOL) TRUE if vectors are equal, FALSE overwise.
+   */
+  static BOOL IsSame( const vec3 &A, const vec3 &B )
+  {
+    return A.X == B.X && A.Y == B.Y && A.Z == B.Z;
+  } /* End of 'IsSame' function */
+
+  /* Compare shapes materials and modifiers function.
+   * ARGUMENTS:
+   *   - pointers at shapes:
+   *       const shape *A, *B;
+   * RETURNS:
+   *   (BOOL) TRUE if shapes look the same, FALSE overwise.
+   */
+  static BOOL IsSameLook( const shape *A, const shape *B )
+  {
+    const surface &Sa = A->Surf, &Sb = B->Surf;
+
+    if (!IsSame(Sa.Ka, Sb.Ka) || !IsSame(Sa.Kd, Sb.Kd) || !IsSame(Sa.Ks, Sb.Ks) ||
+        Sa.Kr != Sb.Kr || Sa.Kt != Sb.Kt || Sa.Ph != Sb.Ph || Sa.MaxLevel != Sb.MaxLevel ||
+        A->Mods.size() != B->Mods.size())
+      return FALSE;
+    for (size_t i = 0; i < A->Mods.size(); i++)
+      if (!A->Mods[i]->IsSame(B->Mods[i]))
+        return FALSE;
+    return TRUE;
+  } /* End of 'IsSameLook' function */
+
+  /* Compare shapes geometry function.
+   * Nested shapes (CSG operands, model triangles) are compared with
+   * their materials, shapes without flat description always differ.
+   * ARGUMENTS:
+   *   - pointers at shapes:
+   *       const shape *A, *B;
+   *   - references at parameters buffers (reused by calls):
+   *       stock<DBL> &Pa, &Pb;
+   * RETURNS:
+   *   (BOOL) TRUE if shapes have the same geometry, FALSE overwise.
+   */
+  static BOOL IsSameGeometry( const shape *A, const shape *B, stock<DBL> &Pa, stock<DBL> &Pb )
+  {
+    stock<shape *> Ca, Cb;
+
+    Pa.clear();
+    Pb.clear();
+
+    INT Ta = A->Flatten(Pa, Ca), Tb = B->Flatten(Pb, Cb);
+
+    if (Ta == 0 || Ta != Tb || Pa != Pb || Ca.size() != Cb.size())
+      return FALSE;
+    for (size_t i = 0; i < Ca.size(); i++)
+      if (!IsSameGeometry(Ca[i], Cb[i], Pa, Pb) || !IsSameLook(Ca[i], Cb[i]))
+        return FALSE;
+    return TRUE;
+  } /* End of 'IsSameGeometry' function */
+
+  /* Compare light sources function.
+   * ARGUMENTS:
+   *   - pointers at light sources:
+   *       const lgh::light *A, *B;
+   *   - references at parameters buffers (reused by calls):
+   *       stock<DBL> &Pa, &Pb;
+   * RETURNS:
+   *   (BOOL) TRUE if light sources are equal, FALSE overwise.
+   */
+  static BOOL IsSameLight( const lgh::light *A, const lgh::light *B, stock<DBL> &Pa, stock<DBL> &Pb )
+  {
+    Pa.clear();
+    Pb.clear();
+
+    INT Ta = A->Flatten(Pa), Tb = B->Flatten(Pb);
+
+    return Ta != 0 && Ta == Tb && Pa == Pb;
+  } /* End of 'IsSameLight' function */
+
+  /* Update scene by changed description function.
+   * ARGUMENTS:
+   *   - reference at scene with new description (gets replaced content):
+   *       scene &Src;
+   * RETURNS:
+   *   (INT) changed shapes and light sources count.
+   */
+  INT scene::Merge( scene &Src )
+  {
+    INT Count = 0;
+
+    // replaced objects are moved to 'Src' and deleted with it
+    if (Shapes.size() != Src.Shapes.size())
+    {
+      Count += (INT)Src.Shapes.size();
+      Shapes.swap(Src.Shapes);
+      Invalidate(CHANGED_SHAPES);
+    }
+    else
+    {
+      stock<std::pair<shape *, shape *>> Replaced;
+      stock<DBL> Pa, Pb;
+      BOOL IsMoved = FALSE;
+
+      for (size_t i = 0; i < Shapes.size(); i++)
+      {
+        shape *&Old = Shapes[i], *&New = Src.Shapes[i];
+
+        if (!IsSameGeometry(Old, New, Pa, Pb))
+        {
+          Replaced.push_back({Old, New});
+          std::swap(Old, New);
+        }
+        else if (!IsSameLook(Old, New))
+        {
+          BOOL WasMoving = Old->IsMoving;
+
+          Old->Surf = New->Surf;
+          Old->Mods.swap(New->Mods);
+          if (Old->Animate(Timer) || WasMoving)
+            IsMoved = TRUE;
+        }
+        else
+          continue;
+        Count++;
+      }
+      if (!Replaced.empty())
+      {
+        if (IsBvhValid && !Bvh.Refit(Replaced))
+          IsBvhValid = FALSE;
+        Changes |= CHANGED_SHAPES;
+      }
+      if (IsMoved)
+      {
+        if (IsBvhValid && !Bvh.Refit())
+          IsBvhValid = FALSE;
+        Changes |= CHANGED_SHAPES;
+      }
+    }
+    IsAnimated = FALSE;
+    for (auto shp : Shapes)
+      for (auto mod : shp->Mods)
+        IsAnimated = IsAnimated || mod->IsAnimated();
+
+    if (Lights.size() != Src.Lights.size())
+    {
+      Count += (INT)Src.Lights.size();
+      Lights.swap(Src.Lights);
+      Invalidate(CHANGED_LIGHTS);
+    }
+    else
+    {
+      INT LightsCount = 0;
+      stock<DBL> Pa, Pb;
+
+      for (size_t i = 0; i < Lights.size(); i++)
+        if (!IsSameLight(Lights[i], Src.Lights[i], Pa, Pb))
+        {
+          std::swap(Lights[i], Src.Lights[i]);
+          LightsCount++;
+        }
+      if (LightsCount > 0)
+        Invalidate(CHANGED_LIGHTS);
+      Count += LightsCount;
+    }
+
+    environment Env;
+
+    Src.GetEnvironment(Env);
+    SetEnvironment(Env);
+    Policy = Src.Policy;
+    MaxAccumCount = Src.MaxAccumCount;
+    IsWavefront = Src.IsWavefront, IsJitter = Src.IsJitter;
+    IsManyLights = Src.IsManyLights, LightsBudget = Src.LightsBudget;
+    CamDist = Src.CamDist;
+    return Count;
+  } /* End of 'Merge' function */
+} /* end of 'dart' namespace */
+
+/* END OF 'scene_reload.cpp' FILE */
@@ -0,0 +1,617 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+/* FILE NAME   : scene_snapshot.cpp
+ * PURPOSE     : Raytracing project.
+ *               Compiled scene snapshots implementation module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "rt/scene.h"
+#include "rt/mapped_file.h"
+#include "rt/shapes/shape.h"
+
+namespace dart
+{
+  /* Snapshot file format namespace.
+   * File is header and sections of fixed size records (aligned by 8
+   * bytes), all references are records indices, so mapped file is read
+   * in place. Nested shapes (CSG operands, model triangles) are stored
+   * after their parent as continuous records range.
+   */
+  namespace snap
+  {
+    static const CHAR Magic[8] = "DB6SNAP"; // File signature
+    static const INT Version = 2;           // File format version
+
+    /* Sections */
+    enum
+    {
+      SEC_MTLS,      // Materials (mtl_rec)
+      SEC_PARAMS,    // Shapes and lights parameters (DBL)
+      SEC_SHAPES,    // Shapes with nested ones (shape_rec)
+      SEC_MODS,      // Shapes modifiers (mod_rec)
+      SEC_LIGHTS,    // Light sources (light_rec)
+      SEC_ROOTS,     // Scene shapes records in scene order (INT)
+      SEC_ITEMS,     // Bounded scene shapes records in hierarchy order (INT)
+      SEC_UNBOUNDED, // Unbounded scene shapes records (INT)
+      SEC_NODES,     // Shapes hierarchy nodes (bvh::node)
+      SEC_COUNT
+    };
+
+    /* Section description structure */
+    struct section
+    {
+      UINT64 Offset; // Offset from file start
+      INT Count;     // Records count
+      INT Size;      // Record size
+    };
+
+    /* Scene settings structure */
+    struct settings
+    {
+      DBL Ambient[3], Background[3], Fog[3]; // Scene colors
+      DBL FogStart, FogEnd;                   // Fog distances
+      DBL AirRefCoef, AirDecay;               // Default environment
+      DBL CamLoc[3], CamAt[3], CamUp[3];      // Camera
+      DBL CamDist;                            // Orbiting camera distance
+      DBL MinWeight, RouletteWeight;          // Path policy weights
+      INT MaxRecLevel, MaxAccumCount;         // Recursion and accumulation limits
+      INT IsWavefront, IsManyLights;          // Rendering modes
+      INT LightsBudget, IsRoulette;           // Lights and path sampling
+      INT RouletteLevel, MaxReflLevel;        // Path policy levels
+      INT MaxRefrLevel, IsPause;              // Path policy level and timer state
+      INT IsJitter;                           // Primary rays antialiasing mode
+    };
+
+    /* File header structure */
+    struct head
+    {
+      CHAR Magic[8];                // File signature
+      INT Version;                  // File format version
+      INT RealSize;                 // Size of real numbers
+      UINT64 FileSize;              // Whole file size
+      section Sections[SEC_COUNT];  // Sections
+      settings Set;                 // Scene settings
+    };
+
+    /* Material record structure */
+    struct mtl_rec
+    {
+      DBL Ka[3], Kd[3], Ks[3]; // Colors coefficients
+      DBL Kr, Kt, Ph;          // Reflection, transmission and Phong coefficients
+      INT MaxLevel, Pad;       // Recursion level cap
+    };
+
+    /* Shape record structure */
+    struct shape_rec
+    {
+      INT Type, Mtl;                 // Shape type (SHAPE_*** value) and material
+      INT Mods, ModsCount;           // Modifiers range
+      INT Params, ParamsCount;       // Parameters range
+      INT Children, ChildrenCount;   // Nested shapes records range
+    };
+
+    /* Modifier record structure */
+    struct mod_rec
+    {
+      INT Type, Pad; // Modifier type (MOD_*** value)
+      DBL Param;     // Modifier parameter
+    };
+
+    /* Light source record structure */
+    struct light_rec
+    {
+      INT Type;                // Light type (LIGHT_*** value)
+      INT Params, ParamsCount; // Parameters range
+      INT Pad;
+    };
+
+    /* Snapshot writer structure */
+    struct writer
+    {
+      stock<mtl_rec> Mtls;
+      std::map<std::string, INT> MtlIndex; // Materials by record bytes
+      stock<DBL> Params;
+      stock<shape_rec> Shapes;
+      stock<mod_rec> Mods;
+      stock<light_rec> Lights;
+      stock<INT> Roots, Items, Unbounded;
+
+      /* Add material function.
+       * ARGUMENTS:
+       *   - reference at material:
+       *       const surface &Surf;
+       * RETURNS:
+       *   (INT) material record index (equal materials share record).
+       */
+      INT Material( const surface &Surf )
+      {
+        mtl_rec R;
+
+        memset(&R, 0, sizeof(R));
+        for (INT i = 0; i < 3; i++)
+          R.Ka[i] = Surf.Ka[i], R.Kd[i] = Surf.Kd[i], R.Ks[i] = Surf.Ks[i];
+        R.Kr = Surf.Kr, R.Kt = Surf.Kt, R.Ph = Surf.Ph;
+        R.MaxLevel = Surf.MaxLevel;
+
+        auto res = MtlIndex.insert({std::string((const CHAR *)&R, sizeof(R)), (INT)Mtls.size()});
+
+        if (res.second)
+          Mtls << R;
+        return res.first->second;
+      } /* End of 'Material' function */
+
+      /* Fill shape record with nested ones function.
+       * ARGUMENTS:
+       *   - shape record index:
+       *       INT Index;
+       *   - pointer at shape:
+       *       const shape *Shp;
+       * RETURNS:
+       *   (BOOL) TRUE if shape has flat description, FALSE overwise.
+       */
+      BOOL Shape( INT Index, const shape *Shp )
+      {
+        stock<shape *> Children;
+        shape_rec R;
+
+        R.Params = (INT)Params.size();
+        if ((R.Type = Shp->Flatten(Params, Children)) == 0)
+          return FALSE;
+        R.ParamsCount = (INT)Params.size() - R.Params;
+        R.Mtl = Material(Shp->Surf);
+        R.Mods = (INT)Mods.size();
+        for (auto mod : Shp->Mods)
+        {
+          mod_rec M {0, 0, 0};
+
+          if ((M.Type = mod->Flatten(&M.Param)) == 0)
+            return FALSE;
+          Mods << M;
+        }
+        R.ModsCount = (INT)Mods.size() - R.Mods;
+
+        // nested shapes records are reserved together, so they are continuous
+        R.Children = (INT)Shapes.size();
+        R.ChildrenCount = (INT)Children.size();
+        Shapes[Index] = R;
+        Shapes.resize(Shapes.size() + Children.size());
+        for (INT i = 0; i < R.ChildrenCount; i++)
+          if (!Shape(R.Children + i, Children[i]))
+            return FALSE;
+        return TRUE;
+      } /* End of 'Shape' function */
+    }; /* End of 'writer' struct */
+
+    /* Create shape of type to restore function.
+     * ARGUMENTS:
+     *   - shape type (SHAPE_*** value):
+     *       INT Type;
+     * RETURNS:
+     *   (shape *) created shape, nullptr for unknown type.
+     */
+    static shape * NewShape( INT Type )
+    {
+      surface S;
+
+      switch (Type)
+      {
+      case SHAPE_SPHERE:
+        return new sphere(vec3(0), 1, S);
+      case SHAPE_CUBE:
+        return new cube(vec3(0), vec3(1), S);
+      case SHAPE_PLANE:
+        return new plane(vec3(0), vec3(1, 0, 0), vec3(0, 0, 1), S);
+      case SHAPE_CYLINDER:
+        return new cylinder(vec3(0), vec3(0, 1, 0), 1, S);
+      case SHAPE_TRIANGLE:
+        return new triangle(vec3(0), vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, 1), vec3(0, 0, 1), S);
+      case SHAPE_MODEL:
+        return new model("", S);
+      case SHAPE_CSG_INTERSECTION:
+        return new csg::intersection(nullptr, nullptr, S);
+      case SHAPE_CSG_SUBSTRACT:
+        return new csg::substract(nullptr, nullptr, S);
+      }
+      return nullptr;
+    } /* End of 'NewShape' function */
+
+    /* Create modifier function.
+     * ARGUMENTS:
+     *   - modifier record:
+     *       const mod_rec &R;
+     * RETURNS:
+     *   (modifier *) created modifier, nullptr for unknown type.
+     */
+    static modifier * NewModifier( const mod_rec &R )
+    {
+      switch (R.Type)
+      {
+      case MOD_CHEKER:
+        return new cheker(R.Param);
+      case MOD_ROTATOR:
+        return new rotator(R.Param);
+      }
+      return nullptr;
+    } /* End of 'NewModifier' function */
+
+    /* Create light source of type to restore function.
+     * ARGUMENTS:
+     *   - light source type (LIGHT_*** value):
+     *       INT Type;
+     * RETURNS:
+     *   (lgh::light *) created light source, nullptr for unknown type.
+     */
+    static lgh::light * NewLight( INT Type )
+    {
+      switch (Type)
+      {
+      case lgh::LIGHT_DIRECT:
+        return new lgh::direct(vec3(0, 0, 1), vec3(0));
+      case lgh::LIGHT_SPOT:
+        return new lgh::spot(vec3(0), vec3(0, 0, 1), 10, 20, vec3(0));
+      case lgh::LIGHT_POINT:
+        return new lgh::point(vec3(0), vec3(0));
+      }
+      return nullptr;
+    } /* End of 'NewLight' function */
+
+    /* Check range in array function.
+     * ARGUMENTS:
+     *   - range start and length:
+     *       INT Start, Count;
+     *   - array size:
+     *       INT Size;
+     * RETURNS:
+     *   (BOOL) TRUE if range is inside array, FALSE overwise.
+     */
+    static BOOL IsRange( INT Start, INT Count, INT Size )
+    {
+      return Start >= 0 && Count >= 0 && Start <= Size && Count <= Size - Start;
+    } /* End of 'IsRange' function */
+  } /* end of 'snap' namespace */
+
+  /* Save compiled scene snapshot function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const CHAR *FileName;
+   *   - reference at camera:
+   *       const camera &Cam;
+   * RETURNS:
+   *   (BOOL) TRUE if snapshot is written, FALSE overwise (e.g. shape has no flat description).
+   */
+  BOOL scene::SaveSnapshot( const CHAR *FileName, const camera &Cam )
+  {
+    camera Tmp = Cam;
+    snap::writer W;
+    std::unordered_map<const shape *, INT> RootOf;
+    stock<shape *> ItemShapes;
+
+    Prepare(Tmp);
+    for (auto shp : Shapes)
+    {
+      INT Index = (INT)W.Shapes.size();
+
+      W.Shapes.resize(Index + 1);
+      if (!W.Shape(Index, shp))
+        return FALSE;
+      W.Roots << Index;
+      RootOf[shp] = Index;
+    }
+    Bvh.GetItems(ItemShapes);
+    for (auto shp : ItemShapes)
+      W.Items << RootOf[shp];
+    for (auto shp : Bvh.Unbounded)
+      W.Unbounded << RootOf[shp];
+    for (auto lgh : Lights)
+    {
+      snap::light_rec R {0, (INT)W.Params.size(), 0, 0};
+
+      if ((R.Type = lgh->Flatten(W.Params)) == 0)
+        return FALSE;
+      R.ParamsCount = (INT)W.Params.size() - R.Params;
+      W.Lights << R;
+    }
+
+    // header is filled by sections placement
+    snap::head H;
+    const stock<bvh::node> &Nodes = Bvh.GetNodes();
+    const VOID *Data[snap::SEC_COUNT] =
+    {
+      W.Mtls.data(), W.Params.data(), W.Shapes.data(), W.Mods.data(), W.Lights.data(),
+      W.Roots.data(), W.Items.data(), W.Unbounded.data(), Nodes.data()
+    };
+    INT
+      Counts[snap::SEC_COUNT] =
+      {
+        (INT)W.Mtls.size(), (INT)W.Params.size(), (INT)W.Shapes.size(), (INT)W.Mods.size(), (INT)W.Lights.size(),
+        (INT)W.Roots.size(), (INT)W.Items.size(), (INT)W.Unbounded.size(), (INT)Nodes.size()
+      },
+      Sizes[snap::SEC_COUNT] =
+      {
+        sizeof(snap::mtl_rec), sizeof(DBL), sizeof(snap::shape_rec), sizeof(snap::mod_rec), sizeof(snap::light_rec),
+        sizeof(INT), sizeof(INT), sizeof(INT), sizeof(bvh::node)
+      };
+    UINT64 Offset = (sizeof(H) + 7) & ~7ULL;
+
+    memset(&H, 0, sizeof(H));
+    memcpy(H.Magic, snap::Magic, sizeof(H.Magic));
+    H.Version = snap::Version;
+    H.RealSize = sizeof(DBL);
+    for (INT i = 0; i < snap::SEC_COUNT; i++)
+    {
+      H.Sections[i].Offset = Offset;
+      H.Sections[i].Count = Counts[i];
+      H.Sections[i].Size = Sizes[i];
+      Offset = (Offset + (UINT64)Counts[i] * Sizes[i] + 7) & ~7ULL;
+    }
+    H.FileSize = Offset;
+
+    snap::settings &S = H.Set;
+    // 'camera::Set' keeps orthogonal up-vector with opposite sign
+    for (INT i = 0; i < 3; i++)
+    {
+      S.Ambient[i] = AmbientColor[i], S.Background[i] = BackgroundColor[i], S.Fog[i] = FogColor[i];
+      S.CamLoc[i] = Cam.Loc[i], S.CamAt[i] = Cam.At[i], S.CamUp[i] = -Cam.Up[i];
+    }
+    S.FogStart = FogStart, S.FogEnd = FogEnd;
+    S.AirRefCoef = Air.RefCoef, S.AirDecay = Air.Decay;
+    S.CamDist = CamDist;
+    S.MinWeight = Policy.MinWeight, S.RouletteWeight = Policy.RouletteWeight;
+    S.MaxRecLevel = MaxRecLevel, S.MaxAccumCount = MaxAccumCount;
+    S.IsWavefront = IsWavefront, S.IsManyLights = IsManyLights;
+    S.LightsBudget = LightsBudget, S.IsRoulette = Policy.IsRoulette;
+    S.RouletteLevel = Policy.RouletteLevel, S.MaxReflLevel = Policy.MaxReflLevel;
+    S.MaxRefrLevel = Policy.MaxRefrLevel, S.IsPause = Timer.IsPause;
+    S.IsJitter = IsJitter;
+
+    // file is written under temporary name, so old snapshot is kept on failure
+    std::string TmpName = std::string(FileName) + ".tmp";
+    FILE *F = fopen(TmpName.c_str(), "wb");
+    static const BYTE Zero[8] = {0};
+
+    if (F == nullptr)
+      return FALSE;
+
+    BOOL IsOk = fwrite(&H, sizeof(H), 1, F) == 1;
+    UINT64 Pos = sizeof(H);
+
+    for (INT i = 0; i < snap::SEC_COUNT && IsOk; i++)
+    {
+      size_t Size = (size_t)Counts[i] * Sizes[i];
+
+      IsOk = fwrite(Zero, 1, (size_t)(H.Sections[i].Offset - Pos), F) == H.Sections[i].Offset - Pos &&
+             (Size == 0 || fwrite(Data[i], 1, Size, F) == Size);
+      Pos = H.Sections[i].Offset + Size;
+    }
+    IsOk = IsOk && fwrite(Zero, 1, (size_t)(H.FileSize - Pos), F) == H.FileSize - Pos;
+    IsOk = fclose(F) == 0 && IsOk;
+    if (IsOk)
+    {
+      remove(FileName);
+      IsOk = rename(TmpName.c_str(), FileName) == 0;
+    }
+    if (!IsOk)
+      remove(TmpName.c_str());
+    return IsOk;
+  } /* End of 'SaveSnapshot' function */
+
+  /* Load compiled scene snapshot function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const CHAR *FileName;
+   *   - reference at camera to set:
+   *       camera &Cam;
+   * RETURNS:
+   *   (BOOL) TRUE if snapshot is loaded, FALSE overwise (scene is not changed).
+   */
+  BOOL scene::LoadSnapshot( const CHAR *FileName, camera &Cam )
+  {
+    mapped_file File;
+
+    if (!File.Open(FileName) || File.GetSize() < sizeof(snap::head))
+      return FALSE;
+
+    const BYTE *Base = File.GetData();
+    const snap::head &H = *(const snap::head *)Base;
+    static const INT Sizes[snap::SEC_COUNT] =
+    {
+      sizeof(snap::mtl_rec), sizeof(DBL), sizeof(snap::shape_rec), sizeof(snap::mod_rec), sizeof(snap::light_rec),
+      sizeof(INT), sizeof(INT), sizeof(INT), sizeof(bvh::node)
+    };
+
+    if (memcmp(H.Magic, snap::Magic, sizeof(H.Magic)) != 0 || H.Version != snap::Version ||
+        H.RealSize != (INT)sizeof(DBL) || H.FileSize != File.GetSize())
+      return FALSE;
+    for (INT i = 0; i < snap::SEC_COUNT; i++)
+    {
+      const snap::section &Sec = H.Sections[i];
+
+      if (Sec.Size != Sizes[i] || Sec.Count < 0 || Sec.Offset % 8 != 0 || Sec.Offset < sizeof(snap::head) ||
+          Sec.Offset > H.FileSize || (UINT64)Sec.Count * Sec.Size > H.FileSize - Sec.Offset)
+        return FALSE;
+    }
+
+    // sections are used in place
+    const snap::mtl_rec *Mtls = (const snap::mtl_rec *)(Base + H.Sections[snap::SEC_MTLS].Offset);
+    const DBL *Params = (const DBL *)(Base + H.Sections[snap::SEC_PARAMS].Offset);
+    const snap::shape_rec *Recs = (const snap::shape_rec *)(Base + H.Sections[snap::SEC_SHAPES].Offset);
+    const snap::mod_rec *Mods = (const snap::mod_rec *)(Base + H.Sections[snap::SEC_MODS].Offset);
+    const snap::light_rec *LightRecs = (const snap::light_rec *)(Base + H.Sections[snap::SEC_LIGHTS].Offset);
+    const INT
+      *Roots = (const INT *)(Base + H.Sections[snap::SEC_ROOTS].Offset),
+      *ItemRecs = (const INT *)(Base + H.Sections[snap::SEC_ITEMS].Offset),
+      *UnboundedRecs = (const INT *)(Base + H.Sections[snap::SEC_UNBOUNDED].Offset);
+    const bvh::node *Nodes = (const bvh::node *)(Base + H.Sections[snap::SEC_NODES].Offset);
+    INT
+      NumMtls = H.Sections[snap::SEC_MTLS].Count,
+      NumParams = H.Sections[snap::SEC_PARAMS].Count,
+      NumShapes = H.Sections[snap::SEC_SHAPES].Count,
+      NumMods = H.Sections[snap::SEC_MODS].Count,
+      NumLights = H.Sections[snap::SEC_LIGHTS].Count,
+      NumRoots = H.Sections[snap::SEC_ROOTS].Count,
+      NumItems = H.Sections[snap::SEC_ITEMS].Count,
+      NumUnbounded = H.Sections[snap::SEC_UNBOUNDED].Count;
+
+    // every record should have one owner (parent or scene), parents are before children
+    stock<BYTE> Owners, Places;
+
+    Owners.resize(NumShapes, 0);
+    Places.resize(NumShapes, 0);
+
+    for (INT i = 0; i < NumShapes; i++)
+    {
+      const snap::shape_rec &R = Recs[i];
+
+      if (R.Mtl < 0 || R.Mtl >= NumMtls || !snap::IsRange(R.Mods, R.ModsCount, NumMods) ||
+          !snap::IsRange(R.Params, R.ParamsCount, NumParams) || !snap::IsRange(R.Children, R.ChildrenCount, NumShapes) ||
+          (R.ChildrenCount > 0 && R.Children <= i))
+        return FALSE;
+      for (INT c = R.Children; c < R.Children + R.ChildrenCount; c++)
+        if (Owners[c]++ != 0)
+          return FALSE;
+    }
+    for (INT i = 0; i < NumRoots; i++)
+      if (Roots[i] < 0 || Roots[i] >= NumShapes || Owners[Roots[i]]++ != 0)
+        return FALSE;
+      else
+        Places[Roots[i]] = 1;
+    for (INT i = 0; i < NumShapes; i++)
+      if (Owners[i] != 1)
+        return FALSE;
+    for (INT i = 0; i < NumItems + NumUnbounded; i++)
+    {
+      INT Rec = i < NumItems ? ItemRecs[i] : UnboundedRecs[i - NumItems];
+
+      if (Rec < 0 || Rec >= NumShapes || Places[Rec]++ != 1)
+        return FALSE;
+    }
+    if (NumItems + NumUnbounded != NumRoots)
+      return FALSE;
+    for (INT i = 0; i < NumLights; i++)
+      if (!snap::IsRange(LightRecs[i].Params, LightRecs[i].ParamsCount, NumParams))
+        return FALSE;
+
+    // children are created before parents
+    stock<shape *> Made;
+    stock<lgh::light *> NewLights;
+    BOOL IsOk = TRUE;
+
+    Made.resize(NumShapes, nullptr);
+
+    for (INT i = NumShapes - 1; i >= 0 && IsOk; i--)
+    {
+      const snap::shape_rec &R = Recs[i];
+      const snap::mtl_rec &M = Mtls[R.Mtl];
+      stock<shape *> Children;
+      shape *Shp = snap::NewShape(R.Type);
+
+      Children.assign(Made.begin() + R.Children, Made.begin() + R.Children + R.ChildrenCount);
+      if (Shp == nullptr || !Shp->Restore(Params + R.Params, R.ParamsCount, Children))
+      {
+        delete Shp;
+        IsOk = FALSE;
+        break;
+      }
+      for (INT c = R.Children; c < R.Children + R.ChildrenCount; c++)
+        Made[c] = nullptr;
+      Made[i] = Shp;
+      Shp->Surf = surface(vec3(M.Ka[0], M.Ka[1], M.Ka[2]), vec3(M.Kd[0], M.Kd[1], M.Kd[2]),
+                          vec3(M.Ks[0], M.Ks[1], M.Ks[2]), M.Kr, M.Kt, M.Ph, M.MaxLevel);
+      for (INT m = R.Mods; m < R.Mods + R.ModsCount && IsOk; m++)
+      {
+        modifier *Mod = snap::NewModifier(Mods[m]);
+
+        if (Mod == nullptr)
+          IsOk = FALSE;
+        else
+          (*Shp)[Mod];
+      }
+    }
+    for (INT i = 0; i < NumLights && IsOk; i++)
+    {
+      lgh::light *Lgh = snap::NewLight(LightRecs[i].Type);
+
+      if (Lgh == nullptr || !Lgh->Restore(Params + LightRecs[i].Params, LightRecs[i].ParamsCount))
+      {
+        delete Lgh;
+        IsOk = FALSE;
+      }
+      else
+        NewLights << Lgh;
+    }
+
+    stock<shape *> NewShapes, ItemShapes, UnboundedShapes;
+    bvh Tree;
+
+    if (IsOk)
+    {
+      for (INT i = 0; i < NumRoots; i++)
+        NewShapes << Made[Roots[i]];
+      for (INT i = 0; i < NumItems; i++)
+        ItemShapes << Made[ItemRecs[i]];
+      for (INT i = 0; i < NumUnbounded; i++)
+        UnboundedShapes << Made[UnboundedRecs[i]];
+      IsOk = Tree.Assign(Nodes, H.Sections[snap::SEC_NODES].Count, ItemShapes, UnboundedShapes);
+    }
+    if (!IsOk)
+    {
+      // records not owned by created parents are deleted
+      for (auto shp : Made)
+        delete shp;
+      for (auto lgh : NewLights)
+        delete lgh;
+      return FALSE;
+    }
+
+    // replace scene content
+    for (auto shp : Shapes)
+      delete shp;
+    for (auto lgh : Lights)
+      delete lgh;
+    Shapes = NewShapes;
+    Lights = NewLights;
+    Bvh = Tree;
+    IsBvhValid = TRUE;
+    IsAnimated = FALSE;
+    for (auto shp : Shapes)
+      for (auto mod : shp->Mods)
+        IsAnimated = IsAnimated || mod->IsAnimated();
+    IsLightTreeValid = FALSE;
+    Changes |= CHANGED_SHAPES | CHANGED_LIGHTS | CHANGED_CAMERA | CHANGED_SHADING;
+
+    const snap::settings &S = H.Set;
+    AmbientColor = vec3(S.Ambient[0], S.Ambient[1], S.Ambient[2]);
+    BackgroundColor = vec3(S.Background[0], S.Background[1], S.Background[2]);
+    FogColor = vec3(S.Fog[0], S.Fog[1], S.Fog[2]);
+    FogStart = S.FogStart, FogEnd = S.FogEnd;
+    Air = envi(S.AirRefCoef, S.AirDecay);
+    CamDist = S.CamDist;
+    Policy.MinWeight = S.MinWeight, Policy.RouletteWeight = S.RouletteWeight;
+    MaxRecLevel = S.MaxRecLevel, MaxAccumCount = COM_MAX(1, S.MaxAccumCount);
+    IsWavefront = S.IsWavefront != 0, IsManyLights = S.IsManyLights != 0;
+    LightsBudget = COM_MAX(1, S.LightsBudget), Policy.IsRoulette = S.IsRoulette != 0;
+    Policy.RouletteLevel = S.RouletteLevel, Policy.MaxReflLevel = S.MaxReflLevel;
+    Policy.MaxRefrLevel = S.MaxRefrLevel, Timer.IsPause = S.IsPause != 0;
+    IsJitter = S.IsJitter != 0;
+    Cam.Set(vec3(S.CamLoc[0], S.CamLoc[1], S.CamLoc[2]), vec3(S.CamAt[0], S.CamAt[1], S.CamAt[2]),
+            vec3(S.CamUp[0], S.CamUp[1], S.CamUp[2]));
+    return TRUE;
+  } /* End of 'LoadSnapshot' function */
+} /* end of 'dart' namespace */
+
+/* END OF 'scene_snapshot.cpp' FILE */
@@ -8,7 +8,7 @@
  *               CSG intersection class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -117,6 +117,63 @@ namespace dart
         }
         return ins_count;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        vec3 amin, amax, bmin, bmax;
+        BOOL
+          is_a = ShpA->Bound(&amin, &amax),
+          is_b = ShpB->Bound(&bmin, &bmax);
+
+        if (!is_a && !is_b)
+          return FALSE;
+        if (!is_a)
+          amin = bmin, amax = bmax;
+        else if (!is_b)
+          bmin = amin, bmax = amax;
+        *Min = vec3(COM_MAX(amin.X, bmin.X), COM_MAX(amin.Y, bmin.Y), COM_MAX(amin.Z, bmin.Z));
+        *Max = vec3(COM_MIN(amax.X, bmax.X), COM_MIN(amax.Y, bmax.Y), COM_MIN(amax.Z, bmax.Z));
+        return TRUE;
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> & /* Params */, stock<shape *> &Children ) const override
+      {
+        Children << ShpA << ShpB;
+        return SHAPE_CSG_INTERSECTION;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL * /* Params */, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 0 || Children.size() != 2 || ShpA != nullptr || ShpB != nullptr)
+          return FALSE;
+        ShpA = Children[0], ShpB = Children[1];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'intersection' class */
   } /* end of 'csg' namespace */
 } /* end of 'dart' namespace */
@@ -8,7 +8,7 @@
  *               CSG subatract class implamentation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -101,6 +101,51 @@ namespace dart
         }
         return ins_count;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        // result is always inside first shape
+        return ShpA->Bound(Min, Max);
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> & /* Params */, stock<shape *> &Children ) const override
+      {
+        Children << ShpA << ShpB;
+        return SHAPE_CSG_SUBSTRACT;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL * /* Params */, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 0 || Children.size() != 2 || ShpA != nullptr || ShpB != nullptr)
+          return FALSE;
+        ShpA = Children[0], ShpB = Children[1];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'substract' class */
   } /* end of 'csg' namespace */
 } /* end of 'dart' namespace */
@@ -8,7 +8,7 @@
  *               cube implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -190,6 +190,52 @@ namespace dart
 
         return 2;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        *Min = vec3(COM_MIN(B1.X, B2.X), COM_MIN(B1.Y, B2.Y), COM_MIN(B1.Z, B2.Z));
+        *Max = vec3(COM_MAX(B1.X, B2.X), COM_MAX(B1.Y, B2.Y), COM_MAX(B1.Z, B2.Z));
+        return TRUE;
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params, stock<shape *> & /* Children */ ) const override
+      {
+        Params << B1.X << B1.Y << B1.Z << B2.X << B2.Y << B2.Z;
+        return SHAPE_CUBE;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 6 || !Children.empty())
+          return FALSE;
+        B1 = vec3(Params[0], Params[1], Params[2]), B2 = vec3(Params[3], Params[4], Params[5]);
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'cube' class */
 }/* end of 'dart' namespace */
 
@@ -57,6 +57,38 @@ namespace dart
       {
         
       } /* End of 'Intersect' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params, stock<shape *> & /* Children */ ) const override
+      {
+        Params << C.X << C.Y << C.Z << A.X << A.Y << A.Z << H;
+        return SHAPE_CYLINDER;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 7 || !Children.empty())
+          return FALSE;
+        C = vec3(Params[0], Params[1], Params[2]), A = vec3(Params[3], Params[4], Params[5]), H = Params[6];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'cylinder' class */
 }/* end of 'dart' namespace */
 
@@ -8,7 +8,7 @@
  *               model class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -248,6 +248,69 @@ namespace dart
             });
         return intrs_count;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        vec3 tmin, tmax;
+
+        *Min = vec3(DBL_MAX), *Max = vec3(-DBL_MAX);
+        for (auto t : Triangles)
+          if (t->Bound(&tmin, &tmax))
+          {
+            *Min = vec3(COM_MIN(Min->X, tmin.X), COM_MIN(Min->Y, tmin.Y), COM_MIN(Min->Z, tmin.Z));
+            *Max = vec3(COM_MAX(Max->X, tmax.X), COM_MAX(Max->Y, tmax.Y), COM_MAX(Max->Z, tmax.Z));
+          }
+        return !Triangles.empty();
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> & /* Params */, stock<shape *> &Children ) const override
+      {
+        // bound box is the first nested shape
+        if (BoundBox == nullptr)
+          return 0;
+        Children << BoundBox;
+        for (auto t : Triangles)
+          Children << t;
+        return SHAPE_MODEL;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL * /* Params */, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 0 || Children.empty() || BoundBox != nullptr || dynamic_cast<cube *>(Children[0]) == nullptr)
+          return FALSE;
+        for (INT i = 1; i < (INT)Children.size(); i++)
+          if (dynamic_cast<triangle *>(Children[i]) == nullptr)
+            return FALSE;
+        BoundBox = static_cast<cube *>(Children[0]);
+        for (INT i = 1; i < (INT)Children.size(); i++)
+          Triangles << static_cast<triangle *>(Children[i]);
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'model' class */
 }/* end of 'dart' namespace */
 
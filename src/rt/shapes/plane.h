@@ -107,6 +107,38 @@ namespace dart
         Intrs.push_back(in);
         return 1;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params, stock<shape *> & /* Children */ ) const override
+      {
+        Params << N.X << N.Y << N.Z << D;
+        return SHAPE_PLANE;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 4 || !Children.empty())
+          return FALSE;
+        N = vec3(Params[0], Params[1], Params[2]), D = Params[3];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'plane' class */
 }/* end of 'dart' namespace */
 
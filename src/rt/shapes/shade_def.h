@@ -8,7 +8,7 @@
  *               Shapes modifiers classes implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -37,7 +37,7 @@ namespace dart
      *   - decaay coefficent:
      *       DBL DecayCoef;
      */
-    envi( DBL RefractionCoef, DBL DecayCoef ) : RefCoef(RefractionCoef), Decay(DecayCoef)
+    envi( DBL RefractionCoef = 1, DBL DecayCoef = 0 ) : RefCoef(RefractionCoef), Decay(DecayCoef)
     {
     } /* End of 'envi' function */
   }; /* End of 'envi' class*/
@@ -57,15 +57,16 @@ namespace dart
       Kr, // Reflection coefficent
       Kt, // Transmession coefficent
       Ph; // Phong coefficent
+    INT MaxLevel; // Maximum recursion level of rays spawned by surface (0 for no cap)
 
     /* Class constructor */
-    surface( VOID ) :  Ka(), Kd(), Ks(), Kr(), Kt(), Ph()
+    surface( VOID ) :  Ka(), Kd(), Ks(), Kr(), Kt(), Ph(), MaxLevel(0)
     {
     }
 
     /* Class constructor */
-    surface( const vec3 &KaCoef, const vec3 &KdCoef, const vec3 &KsCoef, DBL KrCoef, DBL KtCoef, DBL PhCoef ) : 
-      Ka(KaCoef), Kd(KdCoef), Ks(KsCoef), Kr(KrCoef), Kt(KtCoef), Ph(PhCoef)
+    surface( const vec3 &KaCoef, const vec3 &KdCoef, const vec3 &KsCoef, DBL KrCoef, DBL KtCoef, DBL PhCoef, INT MaxLevelCap = 0 ) : 
+      Ka(KaCoef), Kd(KdCoef), Ks(KsCoef), Kr(KrCoef), Kt(KtCoef), Ph(PhCoef), MaxLevel(MaxLevelCap)
     {
     } /* End of 'surface' function */
   }; /* End of 'surface' class*/
@@ -79,8 +80,17 @@ namespace dart
     surface Surf; // Surface
     envi Media;   // Envirnment
     vec3 Du, Dv;  // Tangentspace vectors
+    vec3 dPdx, dPdy; // Point changes by frame pixel steps (ray differentials, zero if unknown)
+    DBL Width;    // Pixel footprint width at point (0 if it is unknown)
   }; /* End of 'shade_info' struct */
 
+  /* Modifier types of flat descriptions (scene snapshots) */
+  enum
+  {
+    MOD_CHEKER = 1,
+    MOD_ROTATOR
+  };
+
    /* Shape modifier class */
   class modifier
   {
@@ -98,16 +108,127 @@ namespace dart
      *       const timer &Timer;
      * RETURNS: None.
      */
-    virtual VOID Apply( shade_info *Sh, const timer &Timer )
+    virtual VOID Apply( shade_info * /* Sh */, const timer & /* Timer */ )
     {
     } /* End of 'Apply' function */
+
+    /* Apply modifier to shading points of shape function.
+     * ARGUMENTS:
+     *   - shade parameters array:
+     *       shade_info *Sh;
+     *   - indices of shading points in array:
+     *       const INT *Index;
+     *   - shading points count:
+     *       INT Count;
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    virtual VOID ApplyBatch( shade_info *Sh, const INT *Index, INT Count, const timer &Timer )
+    {
+      for (INT i = 0; i < Count; i++)
+        Apply(&Sh[Index[i]], Timer);
+    } /* End of 'ApplyBatch' function */
+
+    /* Update modifier for frame function.
+     * Time dependent values are evaluated here once per frame.
+     * ARGUMENTS:
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    virtual VOID Update( const timer & /* Timer */ )
+    {
+    } /* End of 'Update' function */
+
+    /* Get shape transformation at time function.
+     * Transformations are evaluated once per frame (see 'shape::Animate'),
+     * shapes are intersected by rays in their object space.
+     * ARGUMENTS:
+     *   - time from program start:
+     *       const timer &Timer;
+     *   - pointer at transformation (object to world space) to fill:
+     *       transform *T;
+     * RETURNS:
+     *   (BOOL) TRUE if modifier moves shape, FALSE overwise.
+     */
+    virtual BOOL Transform( const timer & /* Timer */, transform * /* T */ ) const
+    {
+      return FALSE;
+    } /* End of 'Transform' function */
+
+    /* Check if modifier changes shading in time function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if modifier depends on time, FALSE overwise.
+     */
+    virtual BOOL IsAnimated( VOID ) const
+    {
+      return FALSE;
+    } /* End of 'IsAnimated' function */
+
+    /* Get modifier flat description function.
+     * Modifier is created again by its type constructor with parameter.
+     * ARGUMENTS:
+     *   - pointer at modifier parameter:
+     *       DBL *Param;
+     * RETURNS:
+     *   (INT) modifier type (MOD_*** value), 0 if modifier has no flat description.
+     */
+    virtual INT Flatten( DBL * /* Param */ ) const
+    {
+      return 0;
+    } /* End of 'Flatten' function */
+
+    /* Compare modifiers of reloaded scene function.
+     * Modifiers are compared by flat description, modifiers without
+     * it compare their own parameters (see textures).
+     * ARGUMENTS:
+     *   - pointer at other modifier:
+     *       const modifier *M;
+     * RETURNS:
+     *   (BOOL) TRUE if modifiers change shapes the same way, FALSE overwise.
+     */
+    virtual BOOL IsSame( const modifier *M ) const
+    {
+      DBL Pa = 0, Pb = 0;
+      INT Ta = Flatten(&Pa), Tb = M->Flatten(&Pb);
+
+      return Ta != 0 && Ta == Tb && Pa == Pb;
+    } /* End of 'IsSame' function */
   }; /* End of 'modifier' class*/
 
-  /* Cheker shape modifier class */
+  /* Cheker shape modifier class.
+   * Cells pattern is box filtered over pixel footprint in closed form,
+   * so distant cells converge to mean color without supersampling.
+   */
   class cheker : public modifier
   {
     DBL Size; // Cell size
 
+    /* Get box filtered cells parity signal along axis function.
+     * Signal is 1 in even cells and -1 in odd cells, its mean over
+     * [X - W/2, X + W/2] is taken by integral (triangle wave).
+     * ARGUMENTS:
+     *   - coordinate (in cells):
+     *       DBL X;
+     *   - filter width (in cells):
+     *       DBL W;
+     * RETURNS:
+     *   (DBL) filtered signal from -1 to 1.
+     */
+    static DBL Parity( DBL X, DBL W )
+    {
+      if (W < 1e-6)
+        return (INT64)floor(X) & 1 ? -1 : 1;
+
+      DBL
+        X0 = (X - W / 2) / 2,
+        X1 = (X + W / 2) / 2;
+
+      return 2 * (fabs(X0 - floor(X0) - 0.5) - fabs(X1 - floor(X1) - 0.5)) / W;
+    } /* End of 'Parity' function */
+
   public:
     /* Class constructor */
     cheker( DBL CellSize = 1 ) : Size(CellSize)
@@ -120,6 +241,8 @@ namespace dart
     } /* End of '~cheker' function */
 
     /* Apply modifier to shape function.
+     * Cells are fixed in object space of moving shapes
+     * (defined after 'shape' class in 'shape_def.h').
      * ARGUMENTS:
      *   - pointer at shade parameters:
      *       shade_info *Sh;
@@ -127,26 +250,27 @@ namespace dart
      *       const timer &Timer;
      * RETURNS: None.
      */
-    VOID Apply( shade_info *Sh, const timer &Timer ) override
-    {
-      if ((INT(Sh->P.X / Size + (Sh->P.X > 0)) ^ INT(Sh->P.Z / Size + (Sh->P.Z > 0))) & 1)
-      {
-        Sh->Surf.Kd = vec3(1);
-        Sh->Surf.Ks = vec3(0.1);
-      }
-      else
-      {
-        Sh->Surf.Kd = vec3(0);
-        Sh->Surf.Ks = vec3(1);
-      }
-    } /* End of 'Apply' function */
+    VOID Apply( shade_info *Sh, const timer &Timer ) override;
+
+    /* Get modifier flat description function.
+     * ARGUMENTS:
+     *   - pointer at modifier parameter:
+     *       DBL *Param;
+     * RETURNS:
+     *   (INT) modifier type (MOD_*** value), 0 if modifier has no flat description.
+     */
+    INT Flatten( DBL *Param ) const override
+    {
+      *Param = Size;
+      return MOD_CHEKER;
+    } /* End of 'Flatten' function */
   }; /* End of 'cheker' class */
 
 
   /* Rotator shape modifier class */
   class rotator : public modifier
   {
-    DBL Vel; // Rotation velocity
+    DBL Vel; // Rotation velocity (degrees per second)
 
   public:
     /* Class constructor */
@@ -159,23 +283,44 @@ namespace dart
     {
     } /* End of '~rotator' function */
 
-    /* Apply modifier to shape function.
+    /* Get shape transformation at time function.
+     * Shape is rotated around Y axis by 'Vel' degrees per second.
      * ARGUMENTS:
-     *   - pointer at shade parameters:
-     *       shade_info *Sh;
      *   - time from program start:
      *       const timer &Timer;
-     * RETURNS: None.
+     *   - pointer at transformation to fill:
+     *       transform *T;
+     * RETURNS:
+     *   (BOOL) TRUE if modifier moves shape, FALSE overwise.
      */
-    VOID Apply( shade_info *Sh, const timer &Timer ) override
-    {
-      if (!Timer.IsPause)
-      {
-        matr M = matr::RotateY(static_cast<FLT>(Timer.DeltaTime * Vel));
-        Sh->P = M * Sh->P;
-        Sh->N = M.NormalTransform(Sh->N);
-      }
-    } /* End of 'Apply' function */
+    BOOL Transform( const timer &Timer, transform *T ) const override
+    {
+      *T = transform::RotateY(static_cast<FLT>(Timer.Time * Vel));
+      return TRUE;
+    } /* End of 'Transform' function */
+
+    /* Check if modifier changes shading in time function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if modifier depends on time, FALSE overwise.
+     */
+    BOOL IsAnimated( VOID ) const override
+    {
+      return TRUE;
+    } /* End of 'IsAnimated' function */
+
+    /* Get modifier flat description function.
+     * ARGUMENTS:
+     *   - pointer at modifier parameter:
+     *       DBL *Param;
+     * RETURNS:
+     *   (INT) modifier type (MOD_*** value), 0 if modifier has no flat description.
+     */
+    INT Flatten( DBL *Param ) const override
+    {
+      *Param = Vel;
+      return MOD_ROTATOR;
+    } /* End of 'Flatten' function */
   }; /* End of 'rotator' class*/
 } /* end of 'dart' namespace */
 
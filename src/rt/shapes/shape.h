@@ -25,6 +25,7 @@
 #include "rt/shapes/csg_substract.h"
 #include "rt/shapes/triangle.h"
 #include "rt/shapes/model.h"
+#include "rt/shapes/texture.h"
 
 #endif // __shape_def_h_
 
@@ -8,7 +8,7 @@
  *               Base implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -31,6 +31,19 @@ namespace dart
   /* Basic shape class */
   class shape;
 
+  /* Shape types of flat descriptions (scene snapshots) */
+  enum
+  {
+    SHAPE_SPHERE = 1,
+    SHAPE_CUBE,
+    SHAPE_PLANE,
+    SHAPE_CYLINDER,
+    SHAPE_TRIANGLE,
+    SHAPE_MODEL,
+    SHAPE_CSG_INTERSECTION,
+    SHAPE_CSG_SUBSTRACT
+  };
+
   /* Intersection class */
   class intr
   {
@@ -56,8 +69,10 @@ namespace dart
   class shape
   {
   public:
-    surface Surf;   // Shape surface
-    mods_list Mods; // Shape modifiers
+    surface Surf;     // Shape surface
+    mods_list Mods;   // Shape modifiers
+    transform Xform;  // Object to world transformation by modifiers (used if 'IsMoving')
+    BOOL IsMoving;    // Shape is moved by modifiers flag
 
     /* Class constructor.
      * ARGUMENTS:
@@ -66,14 +81,14 @@ namespace dart
      *   - pointer at shape modifiers:
      *       const stock<modifier *> *Modifiers
      */
-    shape( const surface &Surface, mods_list *Modifiers ) : Surf(Surface), Mods()
+    shape( const surface &Surface, mods_list *Modifiers ) : Surf(Surface), Mods(), Xform(), IsMoving(FALSE)
     {
       if (Modifiers != nullptr)
         Mods = *Modifiers;
     } /* End of 'shape' constructor */
 
     /* Class destructor */
-    ~shape()
+    virtual ~shape( VOID )
     {
       Mods.Walk(
         []( modifier *Mod )
@@ -95,6 +110,135 @@ namespace dart
       return this;
     }; /* End of 'operator[]' fucntion */
 
+    /* Update modifiers and evaluate their transformation for frame function.
+     * Transformations of modifiers are applied in list order.
+     * ARGUMENTS:
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is moved by modifiers, FALSE overwise.
+     */
+    BOOL Animate( const timer &Timer )
+    {
+      transform T, M;
+
+      IsMoving = FALSE;
+      for (auto mod : Mods)
+      {
+        mod->Update(Timer);
+        if (mod->Transform(Timer, &M))
+          T = T * M, IsMoving = TRUE;
+      }
+      Xform = T;
+      return IsMoving;
+    } /* End of 'Animate' function */
+
+    /* Find intersection with world space ray function.
+     * Ray is moved to object space of moved shape, intersection
+     * distance, point and normal are returned in world space.
+     * ARGUMENTS:
+     *   - reference at ray:
+     *       const ray &Ray;
+     *   - pointer at intersection:
+     *       intr *Intr;
+     * RETURNS:
+     *   (BOOL) TRUE if there is intersection, FALSE overwise.
+     */
+    BOOL WorldIntersect( const ray &Ray, intr *Intr )
+    {
+      if (!IsMoving)
+        return Intersect(Ray, Intr);
+
+      ray r;
+      DBL Scale = ToObject(Ray, &r);
+
+      if (!Intersect(r, Intr))
+        return FALSE;
+      Intr->T /= Scale;
+      Intr->P = Ray(Intr->T);
+      Intr->N = Xform.Normal(Intr->N).Normalizing();
+      return TRUE;
+    } /* End of 'WorldIntersect' function */
+
+    /* Get all intersections with world space ray function.
+     * ARGUMENTS:
+     *   - reference at ray:
+     *       const ray &Ray;
+     *   - reference at intersection list:
+     *       intr_list &Intrs;
+     * RETURNS:
+     *   (INT) intersections count.
+     */
+    INT WorldAllIntersect( const ray &Ray, intr_list &Intrs )
+    {
+      if (!IsMoving)
+        return AllIntersect(Ray, Intrs);
+
+      ray r;
+      DBL Scale = ToObject(Ray, &r);
+      INT Start = (INT)Intrs.size(), Count = AllIntersect(r, Intrs);
+
+      for (INT i = Start; i < (INT)Intrs.size(); i++)
+      {
+        intr &in = Intrs[i];
+
+        in.T /= Scale;
+        in.P = Ray(in.T);
+        in.N = Xform.Normal(in.N).Normalizing();
+      }
+      return Count;
+    } /* End of 'WorldAllIntersect' function */
+
+    /* Get shape world space bound box function.
+     * ARGUMENTS:
+     *   - pointers at bound box minimum and maximum corners:
+     *       vec3 *Min, *Max;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is bounded, FALSE overwise (e.g. plane).
+     */
+    BOOL WorldBound( vec3 *Min, vec3 *Max )
+    {
+      vec3 BMin, BMax;
+
+      if (!Bound(&BMin, &BMax))
+        return FALSE;
+      if (!IsMoving)
+      {
+        *Min = BMin, *Max = BMax;
+        return TRUE;
+      }
+
+      // box of transformed object box corners
+      *Min = vec3(DBL_MAX), *Max = vec3(-DBL_MAX);
+      for (INT i = 0; i < 8; i++)
+      {
+        vec3 P = Xform.Point(vec3(i & 1 ? BMax.X : BMin.X, i & 2 ? BMax.Y : BMin.Y, i & 4 ? BMax.Z : BMin.Z));
+
+        *Min = vec3(COM_MIN(Min->X, P.X), COM_MIN(Min->Y, P.Y), COM_MIN(Min->Z, P.Z));
+        *Max = vec3(COM_MAX(Max->X, P.X), COM_MAX(Max->Y, P.Y), COM_MAX(Max->Z, P.Z));
+      }
+      return TRUE;
+    } /* End of 'WorldBound' function */
+
+    /* Transform world space ray to object space of moved shape function.
+     * ARGUMENTS:
+     *   - reference at world space ray:
+     *       const ray &Ray;
+     *   - pointer at object space ray (normalized direction):
+     *       ray *Obj;
+     * RETURNS:
+     *   (DBL) object space distance of world space unit distance.
+     */
+    DBL ToObject( const ray &Ray, ray *Obj ) const
+    {
+      vec3 D = Xform.InvVector(Ray.Dir);
+      DBL Scale = !D;
+
+      Obj->Org = Xform.InvPoint(Ray.Org);
+      Obj->Dir = D / Scale;
+      return Scale;
+    } /* End of 'ToObject' function */
+
     /* Determine if point is inside shape function.
      * ARGUMENTS:
      *   - reference at point:
@@ -102,7 +246,7 @@ namespace dart
      * RETURNS:
      *   (BOOL) TRUE if point inside shape, FALSE overwise.
      */
-    virtual BOOL IsInside( const vec3 &P )
+    virtual BOOL IsInside( const vec3 & /* P */ )
     {
       return FALSE;
     } /* End of 'IsInside' function */
@@ -115,7 +259,7 @@ namespace dart
      * RETURNS:
      *   (BOOL) TRUE if there is intersection, FALSE overwise.
      */
-    virtual BOOL IsIntersect( const ray &Ray )
+    virtual BOOL IsIntersect( const ray & /* Ray */ )
     {
       return FALSE;
     } /* End of 'IsIntersect' function */
@@ -129,7 +273,7 @@ namespace dart
      * RETURNS:
      *   (BOOL) TRUE if there is intersection, FALSE overwise.
      */
-    virtual BOOL Intersect( const ray &Ray, intr *Intr )
+    virtual BOOL Intersect( const ray & /* Ray */, intr * /* Intr */ )
     {
       return FALSE;
     } /* End of 'Intersect' function */
@@ -143,11 +287,76 @@ namespace dart
      * RETURNS:
      *   (INT) intersections count.
      */
-    virtual INT AllIntersect( const ray &Ray, intr_list &Intrs )
+    virtual INT AllIntersect( const ray & /* Ray */, intr_list & /* Intrs */ )
     {
       return 0;
     } /* End of 'AllIntersect' function */
+
+    /* Get shape bound box function.
+     * ARGUMENTS:
+     *   - pointers at bound box minimum and maximum corners:
+     *       vec3 *Min, *Max;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is bounded, FALSE overwise (e.g. plane).
+     */
+    virtual BOOL Bound( vec3 * /* Min */, vec3 * /* Max */ )
+    {
+      return FALSE;
+    } /* End of 'Bound' function */
+
+    /* Get shape flat description function.
+     * Surface and modifiers are not included.
+     * ARGUMENTS:
+     *   - reference at parameters list to add shape parameters to:
+     *       stock<DBL> &Params;
+     *   - reference at list to add nested shapes to:
+     *       stock<shape *> &Children;
+     * RETURNS:
+     *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+     */
+    virtual INT Flatten( stock<DBL> & /* Params */, stock<shape *> & /* Children */ ) const
+    {
+      return 0;
+    } /* End of 'Flatten' function */
+
+    /* Set shape by flat description function.
+     * ARGUMENTS:
+     *   - shape parameters:
+     *       const DBL *Params, INT Count;
+     *   - nested shapes (owned by shape if it is set):
+     *       const stock<shape *> &Children;
+     * RETURNS:
+     *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+     */
+    virtual BOOL Restore( const DBL * /* Params */, INT /* Count */, const stock<shape *> & /* Children */ )
+    {
+      return FALSE;
+    } /* End of 'Restore' function */
   }; /* End of 'shape' class */
+
+  /* Apply cheker modifier to shape function.
+   * ARGUMENTS:
+   *   - pointer at shade parameters:
+   *       shade_info *Sh;
+   *   - time from program start:
+   *       const timer &Timer;
+   * RETURNS: None.
+   */
+  inline VOID cheker::Apply( shade_info *Sh, const timer & /* Timer */ )
+  {
+    BOOL IsMoving = Sh->Shp->IsMoving;
+    vec3
+      P = IsMoving ? Sh->Shp->Xform.InvPoint(Sh->P) : Sh->P,
+      Dx = IsMoving ? Sh->Shp->Xform.InvVector(Sh->dPdx) : Sh->dPdx,
+      Dy = IsMoving ? Sh->Shp->Xform.InvVector(Sh->dPdy) : Sh->dPdy;
+    DBL
+      WX = COM_MAX(fabs(Dx.X), fabs(Dy.X)) / Size,
+      WZ = COM_MAX(fabs(Dx.Z), fabs(Dy.Z)) / Size,
+      Odd = 0.5 - 0.5 * Parity(P.X / Size, WX) * Parity(P.Z / Size, WZ); // Part of odd cells in footprint
+
+    Sh->Surf.Kd = vec3(Odd);
+    Sh->Surf.Ks = vec3(0.1 * Odd + (1 - Odd));
+  } /* End of 'cheker::Apply' function */
 }/* end of 'dart' namespace */
 
 #endif //__shape_def_h_
@@ -8,7 +8,7 @@
  *               Sphere implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -106,7 +106,7 @@ namespace dart
         if (oc2 < R2)
         {
           Intr->T = ok + sqrt(h2);
-          //Intr->P = Ray(Intr->T);
+          Intr->P = Ray(Intr->T);
           Intr->N = (Intr->P - C) / R;
           Intr->Shp = this;
           return TRUE;
@@ -150,7 +150,7 @@ namespace dart
           if (oc2 < R2)
           {
             in.T = ok + sqrt(h2);
-            //in.P = Ray(in.T);
+            in.P = Ray(in.T);
             in.N = (in.P - C) / R;
             in.Shp = this;
             Intrs.push_back(in);
@@ -178,6 +178,51 @@ namespace dart
           Intrs.push_back(in);
           return 2;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        *Min = C - vec3(R), *Max = C + vec3(R);
+        return TRUE;
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params, stock<shape *> & /* Children */ ) const override
+      {
+        Params << C.X << C.Y << C.Z << R << R2;
+        return SHAPE_SPHERE;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 5 || !Children.empty())
+          return FALSE;
+        C = vec3(Params[0], Params[1], Params[2]), R = Params[3], R2 = Params[4];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'sphere' class */
 }/* end of 'dart' namespace */
 
@@ -0,0 +1,953 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : texture.h
+ * PURPOSE     : Raytracing project.
+ *               Procedural and image textures module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __texture_h_
+#define __texture_h_
+
+#include <algorithm>
+
+#include <emmintrin.h>
+#ifdef __AVX__
+#  include <immintrin.h>
+#endif
+
+#include "rt/shapes/shape_def.h"
+#include "rt/tiled_image.h"
+
+namespace dart
+{
+  namespace tex
+  {
+    /* Pack of shading points values and its operations.
+     * Textures are evaluated in single precision: 8 points per
+     * pack with AVX (if it is enabled by compiler options), 4 with SSE.
+     */
+#ifdef __AVX__
+    typedef __m256 pack;  // Values of shading points
+    const INT Lanes = 8;  // Shading points in pack
+
+    inline pack Set( FLT X ) { return _mm256_set1_ps(X); }
+    inline pack Load( const FLT *P ) { return _mm256_loadu_ps(P); }
+    inline VOID Store( FLT *P, pack X ) { _mm256_storeu_ps(P, X); }
+    inline pack Add( pack A, pack B ) { return _mm256_add_ps(A, B); }
+    inline pack Sub( pack A, pack B ) { return _mm256_sub_ps(A, B); }
+    inline pack Mul( pack A, pack B ) { return _mm256_mul_ps(A, B); }
+    inline pack Min( pack A, pack B ) { return _mm256_min_ps(A, B); }
+    inline pack Max( pack A, pack B ) { return _mm256_max_ps(A, B); }
+    inline pack Abs( pack A ) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), A); }
+    inline pack Sqrt( pack A ) { return _mm256_sqrt_ps(_mm256_max_ps(A, _mm256_setzero_ps())); }
+    inline pack Floor( pack A ) { return _mm256_floor_ps(A); }
+    inline pack Div( pack A, pack B ) { return _mm256_div_ps(A, B); }
+    inline pack Less( pack A, pack B ) { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+    inline pack Select( pack M, pack A, pack B ) { return _mm256_blendv_ps(B, A, M); }
+#else
+    typedef __m128 pack;  // Values of shading points
+    const INT Lanes = 4;  // Shading points in pack
+
+    inline pack Set( FLT X ) { return _mm_set1_ps(X); }
+    inline pack Load( const FLT *P ) { return _mm_loadu_ps(P); }
+    inline VOID Store( FLT *P, pack X ) { _mm_storeu_ps(P, X); }
+    inline pack Add( pack A, pack B ) { return _mm_add_ps(A, B); }
+    inline pack Sub( pack A, pack B ) { return _mm_sub_ps(A, B); }
+    inline pack Mul( pack A, pack B ) { return _mm_mul_ps(A, B); }
+    inline pack Min( pack A, pack B ) { return _mm_min_ps(A, B); }
+    inline pack Max( pack A, pack B ) { return _mm_max_ps(A, B); }
+    inline pack Abs( pack A ) { return _mm_andnot_ps(_mm_set1_ps(-0.f), A); }
+    inline pack Sqrt( pack A ) { return _mm_sqrt_ps(_mm_max_ps(A, _mm_setzero_ps())); }
+    inline pack Div( pack A, pack B ) { return _mm_div_ps(A, B); }
+    inline pack Less( pack A, pack B ) { return _mm_cmplt_ps(A, B); }
+    inline pack Select( pack M, pack A, pack B ) { return _mm_or_ps(_mm_and_ps(M, A), _mm_andnot_ps(M, B)); }
+
+    /* Round values down function.
+     * Truncated values are corrected for negative arguments
+     * (values should be less than 2^31 by absolute value).
+     * ARGUMENTS:
+     *   - values:
+     *       pack A;
+     * RETURNS:
+     *   (pack) rounded values.
+     */
+    inline pack Floor( pack A )
+    {
+      pack T = _mm_cvtepi32_ps(_mm_cvttps_epi32(A));
+
+      return _mm_sub_ps(T, _mm_and_ps(_mm_cmpgt_ps(T, A), _mm_set1_ps(1)));
+    } /* End of 'Floor' function */
+#endif
+
+    inline pack Fract( pack A ) { return Sub(A, Floor(A)); }
+    inline pack Mix( pack A, pack B, pack T ) { return Add(A, Mul(Sub(B, A), T)); }
+    inline pack Saturate( pack A ) { return Min(Max(A, Set(0)), Set(1)); }
+
+    /* Get sine of values function.
+     * Argument is reduced to [-pi/2, pi/2] and sine is taken
+     * by Taylor polynomial (error is less than 4e-6).
+     * ARGUMENTS:
+     *   - values (in radians):
+     *       pack A;
+     * RETURNS:
+     *   (pack) sine values.
+     */
+    inline pack Sin( pack A )
+    {
+      const FLT Pi = 3.14159265f;
+      pack
+        x = Sub(A, Mul(Floor(Add(Mul(A, Set(.5f / Pi)), Set(.5f))), Set(2 * Pi))),
+        y = Min(x, Sub(Set(Pi), x));
+
+      y = Max(y, Sub(Set(-Pi), y));
+
+      pack y2 = Mul(y, y);
+
+      return Mul(y, Add(Set(1), Mul(y2, Add(Set(-1.f / 6), Mul(y2, Add(Set(1.f / 120),
+        Mul(y2, Add(Set(-1.f / 5040), Mul(y2, Set(1.f / 362880))))))))));
+    } /* End of 'Sin' function */
+
+    /* Get random values of lattice points function.
+     * ARGUMENTS:
+     *   - points coordinates:
+     *       pack X, Y, Z;
+     * RETURNS:
+     *   (pack) values from 0 to 1.
+     */
+    inline pack Hash( pack X, pack Y, pack Z )
+    {
+      X = Fract(Mul(X, Set(.1031f))), Y = Fract(Mul(Y, Set(.1031f))), Z = Fract(Mul(Z, Set(.1031f)));
+
+      pack d = Add(Add(Mul(X, Add(Z, Set(31.32f))), Mul(Y, Add(Y, Set(31.32f)))), Mul(Z, Add(X, Set(31.32f))));
+
+      return Fract(Mul(Add(Add(X, d), Add(Y, d)), Add(Z, d)));
+    } /* End of 'Hash' function */
+
+    /* Get value noise function.
+     * Random lattice values are interpolated with smooth weights.
+     * ARGUMENTS:
+     *   - points coordinates:
+     *       pack X, Y, Z;
+     * RETURNS:
+     *   (pack) values from 0 to 1.
+     */
+    inline pack Noise( pack X, pack Y, pack Z )
+    {
+      pack
+        one = Set(1), three = Set(3),
+        x0 = Floor(X), y0 = Floor(Y), z0 = Floor(Z),
+        x1 = Add(x0, one), y1 = Add(y0, one), z1 = Add(z0, one),
+        fx = Sub(X, x0), fy = Sub(Y, y0), fz = Sub(Z, z0),
+        ux = Mul(Mul(fx, fx), Sub(three, Add(fx, fx))),
+        uy = Mul(Mul(fy, fy), Sub(three, Add(fy, fy))),
+        uz = Mul(Mul(fz, fz), Sub(three, Add(fz, fz)));
+
+      return
+        Mix(Mix(Mix(Hash(x0, y0, z0), Hash(x1, y0, z0), ux), Mix(Hash(x0, y1, z0), Hash(x1, y1, z0), ux), uy),
+            Mix(Mix(Hash(x0, y0, z1), Hash(x1, y0, z1), ux), Mix(Hash(x0, y1, z1), Hash(x1, y1, z1), ux), uy), uz);
+    } /* End of 'Noise' function */
+
+    /* Get box filtered fractional parts function.
+     * Mean of fract over [A - W/2, A + W/2] is taken by its integral
+     * floor(x) / 2 + fract(x)^2 / 2 (relative to floor(A) for precision).
+     * ARGUMENTS:
+     *   - values:
+     *       pack A;
+     *   - filter widths:
+     *       pack W;
+     * RETURNS:
+     *   (pack) filtered values (exact fract for zero widths).
+     */
+    inline pack FilterFract( pack A, pack W )
+    {
+      pack
+        half = Set(.5f),
+        f = Fract(A),
+        x0 = Sub(f, Mul(W, half)),
+        x1 = Add(f, Mul(W, half)),
+        f0 = Fract(x0), f1 = Fract(x1),
+        i0 = Mul(Add(Floor(x0), Mul(f0, f0)), half),
+        i1 = Mul(Add(Floor(x1), Mul(f1, f1)), half);
+
+      return Select(Less(W, Set(1e-4f)), f, Div(Sub(i1, i0), Max(W, Set(1e-4f))));
+    } /* End of 'FilterFract' function */
+
+    /* Get box filtered sine of values function.
+     * Mean of sine over [A - W/2, A + W/2] is sin(A) sin(W/2) / (W/2).
+     * ARGUMENTS:
+     *   - values (in radians):
+     *       pack A;
+     *   - filter widths:
+     *       pack W;
+     * RETURNS:
+     *   (pack) filtered values (exact sine for zero widths).
+     */
+    inline pack FilterSin( pack A, pack W )
+    {
+      pack
+        h = Mul(W, Set(.5f)),
+        k = Select(Less(h, Set(1e-3f)), Set(1), Div(Sin(h), Max(h, Set(1e-3f))));
+
+      return Mul(Sin(A), k);
+    } /* End of 'FilterSin' function */
+
+    /* Texture graph operations */
+    enum
+    {
+      OP_CONST,    // Constant value
+      OP_TIME,     // Animation time (in seconds)
+      OP_X,        // Shading point X coordinate
+      OP_Y,        // Shading point Y coordinate
+      OP_Z,        // Shading point Z coordinate
+      OP_ADD,      // A + B
+      OP_SUB,      // A - B
+      OP_MUL,      // A * B
+      OP_MIN,      // min(A, B)
+      OP_MAX,      // max(A, B)
+      OP_ABS,      // |A|
+      OP_FRACT,    // A - floor(A)
+      OP_SQRT,     // sqrt(A)
+      OP_SIN,      // sin(A)
+      OP_SATURATE, // A clamped to [0, 1]
+      OP_MIX,      // A + (B - A) * C
+      OP_NOISE     // Value noise at (A, B, C)
+    };
+
+    /* Texture graph class.
+     * Nodes are scalar values of shading point, node functions return
+     * node index. Texture color is set by three output nodes.
+     */
+    class graph
+    {
+      friend class program;
+
+      /* Graph node struct */
+      struct node
+      {
+        INT Op;      // Operation (OP_*** value)
+        INT A, B, C; // Arguments nodes (-1 for none)
+        FLT Value;   // Constant value
+      }; /* End of 'node' struct */
+
+      stock<node> Nodes; // Nodes (arguments are before node)
+      INT Out[3];        // Color components nodes
+
+      /* Add node function.
+       * ARGUMENTS:
+       *   - operation (OP_*** value):
+       *       INT Op;
+       *   - arguments nodes:
+       *       INT A, B, C;
+       *   - constant value:
+       *       FLT Value;
+       * RETURNS:
+       *   (INT) node index.
+       */
+      INT Node( INT Op, INT A = -1, INT B = -1, INT C = -1, FLT Value = 0 )
+      {
+        Nodes.push_back({Op, A, B, C, Value});
+        return (INT)Nodes.size() - 1;
+      } /* End of 'Node' function */
+
+    public:
+      /* Class constructor */
+      graph( VOID ) : Nodes(), Out{-1, -1, -1}
+      {
+      } /* End of 'graph' function */
+
+      INT Const( FLT V ) { return Node(OP_CONST, -1, -1, -1, V); }
+      INT Time( VOID ) { return Node(OP_TIME); }
+      INT X( VOID ) { return Node(OP_X); }
+      INT Y( VOID ) { return Node(OP_Y); }
+      INT Z( VOID ) { return Node(OP_Z); }
+      INT Add( INT A, INT B ) { return Node(OP_ADD, A, B); }
+      INT Sub( INT A, INT B ) { return Node(OP_SUB, A, B); }
+      INT Mul( INT A, INT B ) { return Node(OP_MUL, A, B); }
+      INT Min( INT A, INT B ) { return Node(OP_MIN, A, B); }
+      INT Max( INT A, INT B ) { return Node(OP_MAX, A, B); }
+      INT Abs( INT A ) { return Node(OP_ABS, A); }
+      INT Fract( INT A ) { return Node(OP_FRACT, A); }
+      INT Sqrt( INT A ) { return Node(OP_SQRT, A); }
+      INT Sin( INT A ) { return Node(OP_SIN, A); }
+      INT Saturate( INT A ) { return Node(OP_SATURATE, A); }
+      INT Mix( INT A, INT B, INT T ) { return Node(OP_MIX, A, B, T); }
+      INT Noise( INT X, INT Y, INT Z ) { return Node(OP_NOISE, X, Y, Z); }
+
+      /* Add fractal noise function.
+       * ARGUMENTS:
+       *   - point coordinates nodes:
+       *       INT X, INT Y, INT Z;
+       *   - octaves count:
+       *       INT Octaves;
+       * RETURNS:
+       *   (INT) node index (values from 0 to 1).
+       */
+      INT Fractal( INT X, INT Y, INT Z, INT Octaves )
+      {
+        INT Sum = Noise(X, Y, Z), Two = Const(2);
+        FLT Amp = 1, Norm = 1;
+
+        for (INT i = 1; i < Octaves; i++)
+        {
+          X = Mul(X, Two), Y = Mul(Y, Two), Z = Mul(Z, Two);
+          Amp /= 2, Norm += Amp;
+          Sum = Add(Sum, Mul(Noise(X, Y, Z), Const(Amp)));
+        }
+        return Mul(Sum, Const(1 / Norm));
+      } /* End of 'Fractal' function */
+
+      /* Set texture color function.
+       * ARGUMENTS:
+       *   - color components nodes:
+       *       INT R, G, B;
+       * RETURNS: None.
+       */
+      VOID Color( INT R, INT G, INT B )
+      {
+        Out[0] = R, Out[1] = G, Out[2] = B;
+      } /* End of 'Color' function */
+
+      /* Compare graphs function.
+       * ARGUMENTS:
+       *   - reference at other graph:
+       *       const graph &G;
+       * RETURNS:
+       *   (BOOL) TRUE if graphs have the same nodes and colors, FALSE overwise.
+       */
+      BOOL operator==( const graph &G ) const
+      {
+        if (Nodes.size() != G.Nodes.size() || Out[0] != G.Out[0] || Out[1] != G.Out[1] || Out[2] != G.Out[2])
+          return FALSE;
+        for (size_t i = 0; i < Nodes.size(); i++)
+        {
+          const node &A = Nodes[i], &B = G.Nodes[i];
+
+          if (A.Op != B.Op || A.A != B.A || A.B != B.B || A.C != B.C || A.Value != B.Value)
+            return FALSE;
+        }
+        return TRUE;
+      } /* End of 'operator==' function */
+
+      /* Set texture color by interpolation of two colors function.
+       * ARGUMENTS:
+       *   - interpolation parameter node:
+       *       INT T;
+       *   - references at colors for 0 and 1 parameter values:
+       *       const vec3 &C0, &C1;
+       * RETURNS: None.
+       */
+      VOID Ramp( INT T, const vec3 &C0, const vec3 &C1 )
+      {
+        Color(Mix(Const((FLT)C0.X), Const((FLT)C1.X), T),
+              Mix(Const((FLT)C0.Y), Const((FLT)C1.Y), T),
+              Mix(Const((FLT)C0.Z), Const((FLT)C1.Z), T));
+      } /* End of 'Ramp' function */
+    }; /* End of 'graph' class */
+
+    /* Compiled texture graph class.
+     * Graph nodes which do not depend on shading point are evaluated
+     * once per frame ('Update'), the rest of nodes is a linear code
+     * executed by packs of shading points.
+     */
+    class program
+    {
+    public:
+      static const INT MaxRegs = 256; // Maximum registers (nodes used by texture)
+
+    private:
+      /* Program instruction struct */
+      struct instr
+      {
+        INT Op;          // Operation (OP_*** value)
+        INT Dst, A, B, C; // Result and arguments registers
+        FLT Value;       // Constant value
+      }; /* End of 'instr' struct */
+
+      stock<instr> Uniform, Varying; // Per frame and per shading point code
+      stock<INT> Consts;             // Registers of per frame values used by per point code
+      stock<FLT> Values;             // Per frame values by registers
+      INT Out[3];                    // Color components registers
+      BOOL IsTime;                   // Program depends on time flag
+
+      /* Execute code function.
+       * Filter widths of values are propagated with values (by first order
+       * derivative bounds), periodic and noise operations are box filtered.
+       * ARGUMENTS:
+       *   - code:
+       *       const stock<instr> &Code;
+       *   - registers:
+       *       pack *R;
+       *   - registers values filter widths:
+       *       pack *W;
+       *   - animation time:
+       *       FLT Time;
+       * RETURNS: None.
+       */
+      static VOID Run( const stock<instr> &Code, pack *R, pack *W, FLT Time )
+      {
+        for (auto &I : Code)
+          switch (I.Op)
+          {
+          case OP_CONST:
+            R[I.Dst] = Set(I.Value);
+            W[I.Dst] = Set(0);
+            break;
+          case OP_TIME:
+            R[I.Dst] = Set(Time);
+            W[I.Dst] = Set(0);
+            break;
+          case OP_ADD:
+            R[I.Dst] = tex::Add(R[I.A], R[I.B]);
+            W[I.Dst] = tex::Add(W[I.A], W[I.B]);
+            break;
+          case OP_SUB:
+            R[I.Dst] = tex::Sub(R[I.A], R[I.B]);
+            W[I.Dst] = tex::Add(W[I.A], W[I.B]);
+            break;
+          case OP_MUL:
+            W[I.Dst] = tex::Add(tex::Mul(tex::Abs(R[I.A]), W[I.B]), tex::Mul(tex::Abs(R[I.B]), W[I.A]));
+            R[I.Dst] = tex::Mul(R[I.A], R[I.B]);
+            break;
+          case OP_MIN:
+            R[I.Dst] = tex::Min(R[I.A], R[I.B]);
+            W[I.Dst] = tex::Max(W[I.A], W[I.B]);
+            break;
+          case OP_MAX:
+            R[I.Dst] = tex::Max(R[I.A], R[I.B]);
+            W[I.Dst] = tex::Max(W[I.A], W[I.B]);
+            break;
+          case OP_ABS:
+            R[I.Dst] = tex::Abs(R[I.A]);
+            W[I.Dst] = W[I.A];
+            break;
+          case OP_FRACT:
+            R[I.Dst] = tex::FilterFract(R[I.A], W[I.A]);
+            W[I.Dst] = tex::Min(W[I.A], Set(1));
+            break;
+          case OP_SQRT:
+            {
+              pack h = tex::Mul(W[I.A], Set(.5f));
+
+              W[I.Dst] = tex::Sub(tex::Sqrt(tex::Add(R[I.A], h)), tex::Sqrt(tex::Sub(R[I.A], h)));
+              R[I.Dst] = tex::Sqrt(R[I.A]);
+            }
+            break;
+          case OP_SIN:
+            R[I.Dst] = tex::FilterSin(R[I.A], W[I.A]);
+            W[I.Dst] = tex::Min(W[I.A], Set(2));
+            break;
+          case OP_SATURATE:
+            R[I.Dst] = tex::Saturate(R[I.A]);
+            W[I.Dst] = tex::Min(W[I.A], Set(1));
+            break;
+          case OP_MIX:
+            W[I.Dst] = tex::Add(tex::Add(W[I.A], W[I.B]), tex::Mul(tex::Abs(tex::Sub(R[I.B], R[I.A])), W[I.C]));
+            R[I.Dst] = tex::Mix(R[I.A], R[I.B], R[I.C]);
+            break;
+          case OP_NOISE:
+            {
+              // details smaller than footprint fade to mean value
+              pack
+                w = tex::Max(tex::Max(W[I.A], W[I.B]), W[I.C]),
+                k = tex::Saturate(w);
+
+              R[I.Dst] = tex::Mix(tex::Noise(R[I.A], R[I.B], R[I.C]), Set(.5f), k);
+              W[I.Dst] = tex::Mul(w, tex::Sub(Set(1), k));
+            }
+            break;
+          }
+      } /* End of 'Run' function */
+
+    public:
+      /* Class constructor */
+      program( VOID ) : Out{-1, -1, -1}, IsTime(FALSE)
+      {
+      } /* End of 'program' function */
+
+      /* Compile graph function.
+       * Registers 0, 1, 2 hold shading point coordinates, nodes not
+       * used by color are dropped.
+       * ARGUMENTS:
+       *   - reference at graph:
+       *       const graph &G;
+       * RETURNS:
+       *   (BOOL) TRUE if graph is compiled, FALSE if it is not valid (program is empty).
+       */
+      BOOL Compile( const graph &G )
+      {
+        INT n = (INT)G.Nodes.size();
+        stock<INT> Reg;
+        stock<BYTE> IsUsed, IsUniform;
+
+        Reg.assign(n, -1), IsUsed.assign(n, 0), IsUniform.assign(n, 0);
+
+        Uniform.clear(), Varying.clear(), Consts.clear(), Values.clear();
+        Out[0] = Out[1] = Out[2] = -1;
+        IsTime = FALSE;
+        for (INT c = 0; c < 3; c++)
+          if (G.Out[c] < 0 || G.Out[c] >= n)
+            return FALSE;
+          else
+            IsUsed[G.Out[c]] = 1;
+
+        // arguments are before nodes, so used nodes are marked by one backward pass
+        for (INT i = n - 1; i >= 0; i--)
+        {
+          const graph::node &Nd = G.Nodes[i];
+          INT Args = Nd.Op >= OP_MIX ? 3 : Nd.Op >= OP_ABS ? 1 : Nd.Op >= OP_ADD ? 2 : 0;
+
+          if (Nd.Op < OP_CONST || Nd.Op > OP_NOISE ||
+              (Args > 0 && (Nd.A < 0 || Nd.A >= i)) ||
+              (Args > 1 && (Nd.B < 0 || Nd.B >= i)) ||
+              (Args > 2 && (Nd.C < 0 || Nd.C >= i)))
+            return FALSE;
+          if (IsUsed[i])
+          {
+            if (Args > 0)
+              IsUsed[Nd.A] = 1;
+            if (Args > 1)
+              IsUsed[Nd.B] = 1;
+            if (Args > 2)
+              IsUsed[Nd.C] = 1;
+          }
+        }
+
+        INT Regs = 3;
+
+        for (INT i = 0; i < n; i++)
+        {
+          const graph::node &Nd = G.Nodes[i];
+
+          if (!IsUsed[i])
+            continue;
+          if (Nd.Op == OP_X || Nd.Op == OP_Y || Nd.Op == OP_Z)
+          {
+            Reg[i] = Nd.Op - OP_X;
+            continue;
+          }
+          if (Regs == MaxRegs)
+            return FALSE;
+
+          instr I {Nd.Op, Reg[i] = Regs++, Nd.A < 0 ? -1 : Reg[Nd.A], Nd.B < 0 ? -1 : Reg[Nd.B], Nd.C < 0 ? -1 : Reg[Nd.C], Nd.Value};
+
+          IsUniform[i] = Nd.Op == OP_CONST || Nd.Op == OP_TIME ||
+            (Nd.A >= 0 && IsUniform[Nd.A] && (Nd.B < 0 || IsUniform[Nd.B]) && (Nd.C < 0 || IsUniform[Nd.C]));
+          IsTime = IsTime || Nd.Op == OP_TIME;
+          if (IsUniform[i])
+            Uniform << I;
+          else
+          {
+            Varying << I;
+            for (INT a : {Nd.A, Nd.B, Nd.C})
+              if (a >= 0 && IsUniform[a])
+                Consts << Reg[a];
+          }
+        }
+        for (INT c = 0; c < 3; c++)
+        {
+          Out[c] = Reg[G.Out[c]];
+          if (IsUniform[G.Out[c]])
+            Consts << Out[c];
+        }
+        std::sort(Consts.begin(), Consts.end());
+        Consts.erase(std::unique(Consts.begin(), Consts.end()), Consts.end());
+        Values.resize(Regs);
+        Update(0);
+        return TRUE;
+      } /* End of 'Compile' function */
+
+      /* Check if program depends on time function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE if texture is animated, FALSE overwise.
+       */
+      BOOL IsAnimated( VOID ) const
+      {
+        return IsTime;
+      } /* End of 'IsAnimated' function */
+
+      /* Evaluate per frame values function.
+       * Should be called between frames.
+       * ARGUMENTS:
+       *   - animation time:
+       *       DBL Time;
+       * RETURNS: None.
+       */
+      VOID Update( DBL Time )
+      {
+        if (Uniform.empty())
+          return;
+
+        pack R[MaxRegs], W[MaxRegs];
+        FLT v[Lanes];
+
+        Run(Uniform, R, W, (FLT)Time);
+        for (INT r : Consts)
+        {
+          Store(v, R[r]);
+          Values[r] = v[0];
+        }
+      } /* End of 'Update' function */
+
+      /* Evaluate texture colors function.
+       * ARGUMENTS:
+       *   - shading points coordinates:
+       *       const FLT *X, *Y, *Z;
+       *   - shading points footprint widths along coordinates axes (zero for no filtering):
+       *       const FLT *WX, *WY, *WZ;
+       *   - shading points count:
+       *       INT Count;
+       *   - colors components to fill:
+       *       FLT *R, *G, *B;
+       * RETURNS: None.
+       */
+      VOID Eval( const FLT *X, const FLT *Y, const FLT *Z, const FLT *WX, const FLT *WY, const FLT *WZ,
+                 INT Count, FLT *R, FLT *G, FLT *B ) const
+      {
+        if (Out[0] < 0)
+          return;
+
+        pack Regs[MaxRegs], Widths[MaxRegs];
+        FLT *Dst[3] = {R, G, B};
+        const FLT *Src[6] = {X, Y, Z, WX, WY, WZ};
+
+        for (INT r : Consts)
+          Regs[r] = Set(Values[r]), Widths[r] = Set(0);
+        for (INT i = 0; i < Count; i += Lanes)
+        {
+          INT n = COM_MIN(Lanes, Count - i);
+
+          if (n == Lanes)
+            for (INT c = 0; c < 3; c++)
+              Regs[c] = Load(Src[c] + i), Widths[c] = Load(Src[3 + c] + i);
+          else
+          {
+            // tail pack is padded by last point
+            FLT p[6][Lanes];
+
+            for (INT k = 0; k < Lanes; k++)
+            {
+              INT s = i + COM_MIN(k, n - 1);
+
+              for (INT c = 0; c < 6; c++)
+                p[c][k] = Src[c][s];
+            }
+            for (INT c = 0; c < 3; c++)
+              Regs[c] = Load(p[c]), Widths[c] = Load(p[3 + c]);
+          }
+          Run(Varying, Regs, Widths, 0);
+          for (INT c = 0; c < 3; c++)
+            if (n == Lanes)
+              Store(Dst[c] + i, Regs[Out[c]]);
+            else
+            {
+              FLT v[Lanes];
+
+              Store(v, Regs[Out[c]]);
+              for (INT k = 0; k < n; k++)
+                Dst[c][i + k] = v[k];
+            }
+        }
+      } /* End of 'Eval' function */
+    }; /* End of 'program' class */
+  } /* end of 'tex' namespace */
+
+  /* Procedural texture shape modifier class.
+   * Texture sets diffuse color by shading point in object space.
+   * Points of one shape are evaluated together by packs, patterns are
+   * filtered over pixel footprints (by ray differentials).
+   */
+  class texture : public modifier
+  {
+    tex::graph Graph;  // Texture graph (parsed parameters, for scene reload)
+    tex::program Prog; // Compiled texture graph
+
+    /* Get object space point function.
+     * ARGUMENTS:
+     *   - reference at shade parameters:
+     *       const shade_info &Sh;
+     *   - pointer at point footprint widths along axes to fill:
+     *       vec3 *W;
+     * RETURNS:
+     *   (vec3) point.
+     */
+    static vec3 Point( const shade_info &Sh, vec3 *W )
+    {
+      BOOL IsMoving = Sh.Shp->IsMoving;
+      vec3
+        Dx = IsMoving ? Sh.Shp->Xform.InvVector(Sh.dPdx) : Sh.dPdx,
+        Dy = IsMoving ? Sh.Shp->Xform.InvVector(Sh.dPdy) : Sh.dPdy;
+
+      *W = vec3(COM_MAX(fabs(Dx.X), fabs(Dy.X)), COM_MAX(fabs(Dx.Y), fabs(Dy.Y)), COM_MAX(fabs(Dx.Z), fabs(Dy.Z)));
+      return IsMoving ? Sh.Shp->Xform.InvPoint(Sh.P) : Sh.P;
+    } /* End of 'Point' function */
+
+  public:
+    static const INT MaxBatch = 64; // Points evaluated by one program call
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - reference at texture graph:
+     *       const tex::graph &G;
+     */
+    texture( const tex::graph &G ) : Graph(G)
+    {
+      Prog.Compile(G);
+    } /* End of 'texture' function */
+
+    /* Compare modifiers of reloaded scene function.
+     * ARGUMENTS:
+     *   - pointer at other modifier:
+     *       const modifier *M;
+     * RETURNS:
+     *   (BOOL) TRUE if textures have the same graph, FALSE overwise.
+     */
+    BOOL IsSame( const modifier *M ) const override
+    {
+      const texture *T = dynamic_cast<const texture *>(M);
+
+      return T != nullptr && T->Graph == Graph;
+    } /* End of 'IsSame' function */
+
+    /* Apply modifier to shape function.
+     * ARGUMENTS:
+     *   - pointer at shade parameters:
+     *       shade_info *Sh;
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    VOID Apply( shade_info *Sh, const timer &Timer ) override
+    {
+      INT Index = 0;
+
+      ApplyBatch(Sh, &Index, 1, Timer);
+    } /* End of 'Apply' function */
+
+    /* Apply modifier to shading points of shape function.
+     * ARGUMENTS:
+     *   - shade parameters array:
+     *       shade_info *Sh;
+     *   - indices of shading points in array:
+     *       const INT *Index;
+     *   - shading points count:
+     *       INT Count;
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    VOID ApplyBatch( shade_info *Sh, const INT *Index, INT Count, const timer & /* Timer */ ) override
+    {
+      FLT
+        x[MaxBatch], y[MaxBatch], z[MaxBatch],
+        wx[MaxBatch], wy[MaxBatch], wz[MaxBatch],
+        r[MaxBatch], g[MaxBatch], b[MaxBatch];
+
+      for (INT i = 0; i < Count; i += MaxBatch)
+      {
+        INT n = COM_MIN(MaxBatch, Count - i);
+
+        for (INT k = 0; k < n; k++)
+        {
+          vec3 W, P = Point(Sh[Index[i + k]], &W);
+
+          x[k] = (FLT)P.X, y[k] = (FLT)P.Y, z[k] = (FLT)P.Z;
+          wx[k] = (FLT)W.X, wy[k] = (FLT)W.Y, wz[k] = (FLT)W.Z;
+        }
+        Prog.Eval(x, y, z, wx, wy, wz, n, r, g, b);
+        for (INT k = 0; k < n; k++)
+          Sh[Index[i + k]].Surf.Kd = vec3(r[k], g[k], b[k]);
+      }
+    } /* End of 'ApplyBatch' function */
+
+    /* Update modifier for frame function.
+     * ARGUMENTS:
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    VOID Update( const timer &Timer ) override
+    {
+      if (Prog.IsAnimated())
+        Prog.Update(Timer.Time);
+    } /* End of 'Update' function */
+
+    /* Check if modifier changes shading in time function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (BOOL) TRUE if modifier depends on time, FALSE overwise.
+     */
+    BOOL IsAnimated( VOID ) const override
+    {
+      return Prog.IsAnimated();
+    } /* End of 'IsAnimated' function */
+
+    /* Create noise texture function.
+     * ARGUMENTS:
+     *   - noise frequency:
+     *       DBL Scale;
+     *   - references at colors:
+     *       const vec3 &C0, &C1;
+     * RETURNS:
+     *   (texture *) created texture.
+     */
+    static texture * Noise( DBL Scale, const vec3 &C0, const vec3 &C1 )
+    {
+      tex::graph G;
+      INT s = G.Const((FLT)Scale);
+
+      G.Ramp(G.Fractal(G.Mul(G.X(), s), G.Mul(G.Y(), s), G.Mul(G.Z(), s), 4), C0, C1);
+      return new texture(G);
+    } /* End of 'Noise' function */
+
+    /* Create marble texture function.
+     * Stripes along X axis are distorted by fractal noise.
+     * ARGUMENTS:
+     *   - stripes frequency:
+     *       DBL Scale;
+     *   - references at colors:
+     *       const vec3 &C0, &C1;
+     * RETURNS:
+     *   (texture *) created texture.
+     */
+    static texture * Marble( DBL Scale, const vec3 &C0, const vec3 &C1 )
+    {
+      tex::graph G;
+      INT
+        s = G.Const((FLT)Scale),
+        x = G.Mul(G.X(), s), y = G.Mul(G.Y(), s), z = G.Mul(G.Z(), s),
+        t = G.Add(G.Mul(x, G.Const(3.14159265f)), G.Mul(G.Fractal(x, y, z, 5), G.Const(6)));
+
+      G.Ramp(G.Add(G.Const(.5), G.Mul(G.Sin(t), G.Const(.5))), C0, C1);
+      return new texture(G);
+    } /* End of 'Marble' function */
+
+    /* Create wood texture function.
+     * Rings around Y axis are distorted by noise.
+     * ARGUMENTS:
+     *   - rings frequency:
+     *       DBL Scale;
+     *   - references at colors:
+     *       const vec3 &C0, &C1;
+     * RETURNS:
+     *   (texture *) created texture.
+     */
+    static texture * Wood( DBL Scale, const vec3 &C0, const vec3 &C1 )
+    {
+      tex::graph G;
+      INT
+        s = G.Const((FLT)Scale),
+        x = G.Mul(G.X(), s), y = G.Mul(G.Y(), s), z = G.Mul(G.Z(), s),
+        r = G.Add(G.Sqrt(G.Add(G.Mul(x, x), G.Mul(z, z))), G.Mul(G.Noise(x, G.Mul(y, G.Const(.2f)), z), G.Const(.7f))),
+        t = G.Fract(r);
+
+      G.Ramp(G.Mul(t, t), C0, C1);
+      return new texture(G);
+    } /* End of 'Wood' function */
+
+    /* Create linear gradient texture function.
+     * ARGUMENTS:
+     *   - reference at gradient direction (its length is 1 / gradient width):
+     *       const vec3 &Dir;
+     *   - references at colors:
+     *       const vec3 &C0, &C1;
+     * RETURNS:
+     *   (texture *) created texture.
+     */
+    static texture * Gradient( const vec3 &Dir, const vec3 &C0, const vec3 &C1 )
+    {
+      tex::graph G;
+      INT t = G.Add(G.Add(G.Mul(G.X(), G.Const((FLT)Dir.X)), G.Mul(G.Y(), G.Const((FLT)Dir.Y))), G.Mul(G.Z(), G.Const((FLT)Dir.Z)));
+
+      G.Ramp(G.Saturate(t), C0, C1);
+      return new texture(G);
+    } /* End of 'Gradient' function */
+  }; /* End of 'texture' class */
+
+  /* Image texture shape modifier class.
+   * Image is projected along the main axis of object space normal
+   * (box mapping), so it needs no surface coordinates of shapes.
+   * Mip-map level is chosen by ray differentials of shading point.
+   */
+  class image_texture : public modifier
+  {
+    std::shared_ptr<tiled_image> Img; // Tiled image (shared by modifiers of the same file)
+    DBL Size;                         // Image repeat size in object space
+    DBL Res;                          // Image resolution (largest side in texels)
+
+  public:
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - tiled image:
+     *       const std::shared_ptr<tiled_image> &Image;
+     *   - image repeat size in object space:
+     *       DBL RepeatSize;
+     */
+    image_texture( const std::shared_ptr<tiled_image> &Image, DBL RepeatSize ) : Img(Image), Size(RepeatSize), Res(0)
+    {
+      INT W, H;
+
+      Img->Size(&W, &H);
+      Res = COM_MAX(W, H);
+    } /* End of 'image_texture' function */
+
+    /* Compare modifiers of reloaded scene function.
+     * ARGUMENTS:
+     *   - pointer at other modifier:
+     *       const modifier *M;
+     * RETURNS:
+     *   (BOOL) TRUE if textures have the same image and size, FALSE overwise.
+     */
+    BOOL IsSame( const modifier *M ) const override
+    {
+      const image_texture *T = dynamic_cast<const image_texture *>(M);
+
+      return T != nullptr && T->Img == Img && T->Size == Size;
+    } /* End of 'IsSame' function */
+
+    /* Apply modifier to shape function.
+     * ARGUMENTS:
+     *   - pointer at shade parameters:
+     *       shade_info *Sh;
+     *   - time from program start:
+     *       const timer &Timer;
+     * RETURNS: None.
+     */
+    VOID Apply( shade_info *Sh, const timer & /* Timer */ ) override
+    {
+      BOOL IsMoving = Sh->Shp->IsMoving;
+      vec3
+        P = IsMoving ? Sh->Shp->Xform.InvPoint(Sh->P) : Sh->P,
+        N = IsMoving ? Sh->Shp->Xform.InvVector(Sh->N) : Sh->N,
+        Dx = IsMoving ? Sh->Shp->Xform.InvVector(Sh->dPdx) : Sh->dPdx,
+        Dy = IsMoving ? Sh->Shp->Xform.InvVector(Sh->dPdy) : Sh->dPdy;
+      DBL ax = fabs(N.X), ay = fabs(N.Y), az = fabs(N.Z);
+      INT iu = 0, iv = 1;
+
+      if (ay >= ax && ay >= az)
+        iu = 0, iv = 2;
+      else if (ax >= az)
+        iu = 2, iv = 1;
+
+      // footprint is the longest of projected point differentials
+      DBL
+        wx = sqrt(Dx[iu] * Dx[iu] + Dx[iv] * Dx[iv]),
+        wy = sqrt(Dy[iu] * Dy[iu] + Dy[iv] * Dy[iv]);
+
+      Sh->Surf.Kd = Img->Sample(P[iu] / Size, P[iv] / Size, COM_MAX(wx, wy) / Size * Res);
+    } /* End of 'Apply' function */
+  }; /* End of 'image_texture' class */
+} /* end of 'dart' namespace */
+
+#endif // __texture_h_
+
+/* END OF 'texture.h' FILE */
@@ -8,7 +8,7 @@
  *               Triangle class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 28.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -28,7 +28,7 @@ namespace dart
         P0, P1, P2,        // Triangle vertexes
         N0, N1, N2,        // Triangle normals
         U1, V1, N;         // Triangle basis
-      DBL D, u0, v0, u, v; // Triangle basis coordinates
+      DBL D, u0, v0;       // Triangle basis coordinates
 
     public:
       /* Class constructor.
@@ -41,7 +41,7 @@ namespace dart
        *       const surface &Surface;
        */
       triangle( const vec3 &Point0, const vec3 &Point1, const vec3 &Point2, const vec3 &Normal0, const vec3 &Normal1, const vec3 &Normal2, const surface &Surface, mods_list *Modifiers = nullptr ) :
-        shape(Surface, Modifiers), P0(Point0), P1(Point1), P2(Point2), N0(Normal0.Normalizing()), N1(Normal1.Normalizing()), N2(Normal2.Normalizing()), D(), u0(), v0(), u(), v()
+        shape(Surface, Modifiers), P0(Point0), P1(Point1), P2(Point2), N0(Normal0.Normalizing()), N1(Normal1.Normalizing()), N2(Normal2.Normalizing()), D(), u0(), v0()
       {
         vec3 S1 = P1 - P0, S2 = P2 - P0;
         N = (S1 % S2).Normalizing();
@@ -71,11 +71,11 @@ namespace dart
        */
       BOOL IsIntersect( const ray &Ray ) override
       {
-        DBL t = -((N & Ray.Org) + (N & P0)) / (N & Ray.Dir);
+        DBL t = (D - (N & Ray.Org)) / (N & Ray.Dir);
         if (t >= Threshold)
         {
           vec3 p = Ray(t);
-          u = (p & U1) - u0, v = (p & V1) - v0;
+          DBL u = (p & U1) - u0, v = (p & V1) - v0;
           if (u > -Threshold && u < 1 + Threshold && v > -Threshold && v < 1 + Threshold && u + v < 1 + Threshold)
           //if (u >= 0 && u <= 1 && v >= 0 && v <= 1 && u + v <= 1)
             return TRUE;
@@ -94,11 +94,11 @@ namespace dart
        */
       BOOL Intersect( const ray &Ray, intr *Intr ) override
       {
-        Intr->T = -((N & Ray.Org) + (N & P0)) / (N & Ray.Dir);
+        Intr->T = (D - (N & Ray.Org)) / (N & Ray.Dir);
         if (Intr->T >= Threshold)
         {
           Intr->P = Ray(Intr->T);
-          u = (Intr->P & U1) - u0, v = (Intr->P & V1) - v0;
+          DBL u = (Intr->P & U1) - u0, v = (Intr->P & V1) - v0;
           if (u > -Threshold && u < 1 + Threshold && v > -Threshold && v < 1 + Threshold && u + v < 1 + Threshold)
           //if (u >= 0 && u <= 1 && v >= 0 && v <= 1 && u + v <= 1)
           //if (u >= Threshold && u <= Threshold && v >= Threshold && v <= Threshold && u + v <= Threshold)
@@ -123,11 +123,11 @@ namespace dart
       INT AllIntersect( const ray &Ray, intr_list &Intrs ) override
       {
         intr in;
-        in.T = -((N & Ray.Org) + (N & P0)) / (N & Ray.Dir);
+        in.T = (D - (N & Ray.Org)) / (N & Ray.Dir);
         if (in.T >= Threshold)
         {
           in.P = Ray(in.T);
-          u = (in.P & U1) - u0, v = (in.P & V1) - v0;
+          DBL u = (in.P & U1) - u0, v = (in.P & V1) - v0;
           if (u > -Threshold && u < 1 + Threshold && v > -Threshold && v < 1 + Threshold && u + v < 1 + Threshold)
           //if (u >= 0 && u <= 1 && v >= 0 && v <= 1 && u + v <= 1)
           {
@@ -139,6 +139,57 @@ namespace dart
         }
         return 0;
       } /* End of 'AllIntersect' function */
+
+      /* Get shape bound box function.
+       * ARGUMENTS:
+       *   - pointers at bound box minimum and maximum corners:
+       *       vec3 *Min, *Max;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is bounded, FALSE overwise.
+       */
+      BOOL Bound( vec3 *Min, vec3 *Max ) override
+      {
+        *Min = vec3(COM_MIN(P0.X, COM_MIN(P1.X, P2.X)), COM_MIN(P0.Y, COM_MIN(P1.Y, P2.Y)), COM_MIN(P0.Z, COM_MIN(P1.Z, P2.Z)));
+        *Max = vec3(COM_MAX(P0.X, COM_MAX(P1.X, P2.X)), COM_MAX(P0.Y, COM_MAX(P1.Y, P2.Y)), COM_MAX(P0.Z, COM_MAX(P1.Z, P2.Z)));
+        return TRUE;
+      } /* End of 'Bound' function */
+
+      /* Get shape flat description function.
+       * ARGUMENTS:
+       *   - reference at parameters list to add shape parameters to:
+       *       stock<DBL> &Params;
+       *   - reference at list to add nested shapes to:
+       *       stock<shape *> &Children;
+       * RETURNS:
+       *   (INT) shape type (SHAPE_*** value), 0 if shape has no flat description.
+       */
+      INT Flatten( stock<DBL> &Params, stock<shape *> & /* Children */ ) const override
+      {
+        Params << P0.X << P0.Y << P0.Z << P1.X << P1.Y << P1.Z << P2.X << P2.Y << P2.Z;
+        Params << N0.X << N0.Y << N0.Z << N1.X << N1.Y << N1.Z << N2.X << N2.Y << N2.Z;
+        Params << U1.X << U1.Y << U1.Z << V1.X << V1.Y << V1.Z << N.X << N.Y << N.Z << D << u0 << v0;
+        return SHAPE_TRIANGLE;
+      } /* End of 'Flatten' function */
+
+      /* Set shape by flat description function.
+       * ARGUMENTS:
+       *   - shape parameters:
+       *       const DBL *Params, INT Count;
+       *   - nested shapes (owned by shape if it is set):
+       *       const stock<shape *> &Children;
+       * RETURNS:
+       *   (BOOL) TRUE if shape is set, FALSE if description is not valid.
+       */
+      BOOL Restore( const DBL *Params, INT Count, const stock<shape *> &Children ) override
+      {
+        if (Count != 30 || !Children.empty())
+          return FALSE;
+        P0 = vec3(Params[0], Params[1], Params[2]), P1 = vec3(Params[3], Params[4], Params[5]), P2 = vec3(Params[6], Params[7], Params[8]);
+        N0 = vec3(Params[9], Params[10], Params[11]), N1 = vec3(Params[12], Params[13], Params[14]), N2 = vec3(Params[15], Params[16], Params[17]);
+        U1 = vec3(Params[18], Params[19], Params[20]), V1 = vec3(Params[21], Params[22], Params[23]), N = vec3(Params[24], Params[25], Params[26]);
+        D = Params[27], u0 = Params[28], v0 = Params[29];
+        return TRUE;
+      } /* End of 'Restore' function */
     }; /* End of 'triangle' class */
 }/* end of 'dart' namespace */
 
@@ -0,0 +1,160 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : still.h
+ * PURPOSE     : Raytracing project.
+ *               Long still image rendering with checkpoints module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __still_h_
+#define __still_h_
+
+#include <chrono>
+
+#include "rt/checkpoint.h"
+#include "rt/image_saver.h"
+
+namespace dart
+{
+  /* Long still image renderer class.
+   * Image is accumulated by passes up to required samples count, every
+   * 'Period' seconds rendering stops at tiles boundary and accumulation
+   * state is posted to checkpoint file (written by other thread). After
+   * crash rendering is resumed from checkpoint with the same result as
+   * without interruption.
+   */
+  class still
+  {
+  public:
+    INT W, H;    // Image size
+    INT Samples; // Samples per pixel (passes of stochastic scene)
+    DBL Period;  // Time between checkpoints in seconds
+
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - image size:
+     *       INT Width, Height;
+     *   - samples per pixel:
+     *       INT SamplesCount;
+     *   - time between checkpoints in seconds:
+     *       DBL CheckpointPeriod;
+     */
+    still( INT Width, INT Height, INT SamplesCount, DBL CheckpointPeriod = 60 ) :
+      W(Width), H(Height), Samples(SamplesCount), Period(CheckpointPeriod)
+    {
+    } /* End of 'still' function */
+
+    /* Render image to file function.
+     * Checkpoint is written to file with ".ckpt" added to image name
+     * and removed when image is written.
+     * ARGUMENTS:
+     *   - reference at scene:
+     *       scene &Scene;
+     *   - reference at camera (it is resized to image size):
+     *       camera &Cam;
+     *   - image file name (PNG or RLE TGA by extension):
+     *       const CHAR *FileName;
+     *   - continue from checkpoint flag:
+     *       BOOL IsResume;
+     * RETURNS:
+     *   (BOOL) TRUE if image is written, FALSE overwise.
+     */
+    BOOL Render( scene &Scene, camera &Cam, const CHAR *FileName, BOOL IsResume )
+    {
+      std::string CkptName = std::string(FileName) + ".ckpt";
+      scene::accum_state State;
+      stock<DWORD> Image;
+      frame Frm(W, H);
+
+      Image.resize(W * H);
+      Frm.Image = Image.data();
+      Cam.Resize(W, H);
+      Scene.Timer.IsPause = TRUE;
+      Scene.IsReproject = FALSE;
+      Scene.MaxAccumCount = Samples;
+
+      BOOL IsLoaded = IsResume && checkpoint::Load(CkptName.c_str(), State);
+      if (IsLoaded)
+      {
+        // accumulation continues in checkpoint layout
+        Frm.SetTiled(State.IsTiled);
+        Scene.SetAccum(State);
+      }
+
+      // ticker stops recursive rendering at tiles boundary when checkpoint is due
+      std::mutex Mutex;
+      std::condition_variable Stop;
+      BOOL IsStop = FALSE;
+      std::atomic<BOOL> IsDue(FALSE);
+      std::thread Ticker(
+        [&]( VOID )
+        {
+          std::unique_lock<std::mutex> Lock(Mutex);
+
+          while (!Stop.wait_for(Lock, std::chrono::duration<DBL>(Period),
+                   [&]( VOID )
+                   {
+                     return IsStop;
+                   }))
+          {
+            IsDue = TRUE;
+            if (!Scene.IsWavefront)
+              Scene.IsCancel = TRUE;
+          }
+        });
+
+      BOOL IsImage = FALSE;
+      {
+        checkpoint Ckpt(CkptName.c_str());
+
+        for (;;)
+        {
+          BOOL
+            IsNew = Scene.Render(Cam, Frm),
+            IsCancelled = Scene.IsCancel.exchange(FALSE);
+
+          IsImage = IsImage || IsNew;
+          if (IsDue)
+          {
+            IsDue = FALSE;
+            Ckpt.Post(Scene, Frm);
+          }
+          if (!IsNew && !IsCancelled)
+            break;
+        }
+        {
+          std::lock_guard<std::mutex> Lock(Mutex);
+          IsStop = TRUE;
+        }
+        Stop.notify_all();
+        Ticker.join();
+      }
+
+      // checkpoint of completed image is the whole image
+      if (!IsImage)
+      {
+        if (!IsLoaded || State.Count == 0 || (INT)State.Accum.size() != Frm.Size())
+          return FALSE;
+        for (INT i = 0; i < Frm.Size(); i++)
+          Frm.Put(i, State.Accum[i] * (1.0 / State.Count));
+        Frm.Resolve();
+      }
+      if (!image_saver::Write(FileName, Frm.Image, W, H))
+        return FALSE;
+      remove(CkptName.c_str());
+      return TRUE;
+    } /* End of 'Render' function */
+  }; /* End of 'still' class */
+} /* end of 'dart' namespace */
+
+#endif // __still_h_
+
+/* END OF 'still.h' FILE */
@@ -0,0 +1,146 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : swap_chain.h
+ * PURPOSE     : Raytracing project.
+ *               Presented images exchange module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __swap_chain_h_
+#define __swap_chain_h_
+
+#include <atomic>
+#include <windows.h>
+
+#include "def.h"
+
+namespace dart
+{
+  /* Presented images exchange class.
+   * Renderer (one thread) writes back buffer and publishes it, window
+   * (other thread) shows front buffer. Buffers are exchanged through
+   * third (ready) slot by atomic exchange only, so neither side ever
+   * waits for other one: renderer is never blocked by drawing and
+   * window always shows the last completed image.
+   */
+  template <typename InfoType>
+    class swap_chain
+    {
+    public:
+      /* Image buffer structure */
+      struct buffer
+      {
+        stock<DWORD> Image; // Image pixels (bottom-up rows, as in frame)
+        INT W, H;           // Image size
+        InfoType Info;      // Image information (renderer defined)
+      };
+
+    private:
+      static const INT FreshBit = 4; // Ready slot is not shown yet flag
+
+      buffer Buffers[3];      // Buffers
+      INT Back;               // Buffer written by renderer
+      INT Front;              // Buffer shown by window
+      std::atomic<INT> Ready; // Last published buffer (with 'FreshBit')
+
+    public:
+      /* Class default constructor */
+      swap_chain( VOID ) : Back(0), Front(1), Ready(2)
+      {
+        for (auto &b : Buffers)
+          b.W = b.H = 0;
+      } /* End of 'swap_chain' function */
+
+      /* Get back buffer image (renderer side) function.
+       * ARGUMENTS:
+       *   - image size:
+       *       INT W, H;
+       * RETURNS:
+       *   (DWORD *) image pixels.
+       */
+      DWORD * GetBack( INT W, INT H )
+      {
+        buffer &b = Buffers[Back];
+
+        b.W = W, b.H = H;
+        b.Image.resize(W * H);
+        return b.Image.data();
+      } /* End of 'GetBack' function */
+
+      /* Publish back buffer (renderer side) function.
+       * ARGUMENTS:
+       *   - reference at image information:
+       *       const InfoType &Info;
+       * RETURNS: None.
+       */
+      VOID Present( const InfoType &Info )
+      {
+        Buffers[Back].Info = Info;
+        Back = Ready.exchange(Back | FreshBit) & ~FreshBit;
+      } /* End of 'Present' function */
+
+      /* Take last published buffer as front one (window side) function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (BOOL) TRUE if front buffer has been changed, FALSE overwise.
+       */
+      BOOL Acquire( VOID )
+      {
+        // only renderer sets fresh flag, so it can not disappear before exchange
+        if (!(Ready.load() & FreshBit))
+          return FALSE;
+        Front = Ready.exchange(Front) & ~FreshBit;
+        return TRUE;
+      } /* End of 'Acquire' function */
+
+      /* Get front buffer (window side) function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (const buffer &) front buffer.
+       */
+      const buffer & GetFront( VOID ) const
+      {
+        return Buffers[Front];
+      } /* End of 'GetFront' function */
+
+      /* Draw front buffer (window side) function.
+       * ARGUMENTS:
+       *   - device context handle:
+       *       HDC hDC;
+       *   - window client area size (image is centered):
+       *       INT W, H;
+       * RETURNS: None.
+       */
+      VOID Draw( HDC hDC, INT W, INT H ) const
+      {
+        const buffer &b = Buffers[Front];
+
+        if (b.Image.empty())
+          return;
+
+        BITMAPINFOHEADER bmih = {0};
+        bmih.biSize = sizeof(BITMAPINFOHEADER);
+        bmih.biBitCount = 32;
+        bmih.biPlanes = 1;
+        bmih.biCompression = BI_RGB;
+        bmih.biWidth = b.W;
+        bmih.biHeight = b.H;
+        bmih.biSizeImage = b.W * b.H * sizeof(DWORD);
+
+        SetDIBitsToDevice(hDC, W / 2 - b.W / 2, H / 2 - b.H / 2, b.W, b.H, 0, 0, 0, b.H,
+          b.Image.data(), (BITMAPINFO *)&bmih, DIB_RGB_COLORS);
+      } /* End of 'Draw' function */
+    }; /* End of 'swap_chain' class */
+} /* end of 'dart' namespace */
+
+#endif // __swap_chain_h_
+
+/* END OF 'swap_chain.h' FILE */
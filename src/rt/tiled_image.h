@@ -0,0 +1,632 @@
+/*************************************************************
+ * Copyright (C) 2022
+ *    Computer Graphics Support Group of 30 Phys-Math Lyceum
+ *************************************************************/
+
+ /* FILE NAME   : tiled_image.h
+ * PURPOSE     : Raytracing project.
+ *               Tiled mip-mapped images module.
+ * PROGRAMMER  : CGSG-SummerCamp'2022.
+ *               Danil Belov.
+ * LAST UPDATE : 19.10.2026.
+ * NOTE        : Module namespace 'dart'.
+ *
+ * No part of this file may be changed without agreement of
+ * Computer Graphics Support Group of 30 Phys-Math Lyceum
+ */
+#ifndef __tiled_image_h_
+#define __tiled_image_h_
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rt/mapped_file.h"
+
+namespace dart
+{
+  /* Decoded image tiles cache class.
+   * Tiles of all images share one memory budget. Cache is split to
+   * parts by tile keys, every part has own lock and least recently used
+   * list, so rendering threads rarely wait for each other. Tiles are
+   * used only under part lock, so evicted tile memory is never read.
+   */
+  class tile_cache
+  {
+  public:
+    static const INT TileSize = 32;           // Tile size in image texels
+    static const INT Stride = TileSize + 1;   // Stored tile row size (with next tile column)
+
+    /* Decoded tile structure (linear colors) */
+    struct tile
+    {
+      FLT C[Stride * Stride][3]; // Texels colors by rows
+    };
+
+  private:
+    static const INT Parts = 16; // Cache parts count
+
+    /* Cache part structure */
+    struct part
+    {
+      std::mutex Mutex;                    // Part lock
+      std::unordered_map<UINT64, INT> Map; // Slots of tiles by keys
+      stock<tile> Tiles;                   // Tiles slots
+      stock<UINT64> Keys;                  // Tiles keys by slots
+      stock<INT> Prev, Next;               // Recently used list links by slots
+      INT First, Last;                     // Most and least recently used slots
+    };
+
+    part Part[Parts];           // Cache parts
+    std::atomic<size_t> Budget; // Memory budget in bytes
+    std::atomic<UINT64> Hits;   // Found tiles count
+    std::atomic<UINT64> Misses; // Decoded tiles count
+
+    /* Move slot to recently used list start function.
+     * ARGUMENTS:
+     *   - reference at cache part:
+     *       part &P;
+     *   - slot:
+     *       INT Slot;
+     * RETURNS: None.
+     */
+    static VOID Touch( part &P, INT Slot )
+    {
+      if (P.First == Slot)
+        return;
+      if (P.Prev[Slot] >= 0)
+        P.Next[P.Prev[Slot]] = P.Next[Slot];
+      if (P.Next[Slot] >= 0)
+        P.Prev[P.Next[Slot]] = P.Prev[Slot];
+      if (P.Last == Slot)
+        P.Last = P.Prev[Slot];
+      P.Prev[Slot] = -1;
+      P.Next[Slot] = P.First;
+      if (P.First >= 0)
+        P.Prev[P.First] = Slot;
+      P.First = Slot;
+      if (P.Last < 0)
+        P.Last = Slot;
+    } /* End of 'Touch' function */
+
+  public:
+    /* Class constructor.
+     * ARGUMENTS:
+     *   - memory budget in bytes:
+     *       size_t MemoryBudget;
+     */
+    tile_cache( size_t MemoryBudget = 64 << 20 ) : Budget(MemoryBudget), Hits(0), Misses(0)
+    {
+      for (auto &p : Part)
+        p.First = p.Last = -1;
+    } /* End of 'tile_cache' function */
+
+    /* Get cache of all images function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (tile_cache &) cache.
+     */
+    static tile_cache & Get( VOID )
+    {
+      static tile_cache Cache;
+
+      return Cache;
+    } /* End of 'Get' function */
+
+    /* Set memory budget function.
+     * Cached tiles are dropped if budget is changed.
+     * ARGUMENTS:
+     *   - memory budget in bytes:
+     *       size_t MemoryBudget;
+     * RETURNS: None.
+     */
+    VOID SetBudget( size_t MemoryBudget )
+    {
+      if (Budget == MemoryBudget)
+        return;
+      Budget = MemoryBudget;
+      for (auto &p : Part)
+      {
+        std::lock_guard<std::mutex> Lock(p.Mutex);
+
+        p.Map.clear();
+        stock<tile>().swap(p.Tiles);
+        p.Keys.clear();
+        p.Prev.clear();
+        p.Next.clear();
+        p.First = p.Last = -1;
+      }
+    } /* End of 'SetBudget' function */
+
+    /* Get memory budget function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (size_t) memory budget in bytes.
+     */
+    size_t GetBudget( VOID ) const
+    {
+      return Budget;
+    } /* End of 'GetBudget' function */
+
+    /* Get statistics function.
+     * ARGUMENTS:
+     *   - pointers at found and decoded tiles counts:
+     *       UINT64 *HitsCount, *MissesCount;
+     * RETURNS: None.
+     */
+    VOID Stats( UINT64 *HitsCount, UINT64 *MissesCount ) const
+    {
+      *HitsCount = Hits;
+      *MissesCount = Misses;
+    } /* End of 'Stats' function */
+
+    /* Use tile function.
+     * Missed tile is decoded to least recently used slot of full part.
+     * ARGUMENTS:
+     *   - tile key (unique for all images):
+     *       UINT64 Key;
+     *   - tile decoding function (called as 'Decode(tile *)'):
+     *       const DecodeFunc &Decode;
+     *   - tile using function (called as 'Use(const tile &)' under lock):
+     *       const UseFunc &Use;
+     * RETURNS: None.
+     */
+    template <typename DecodeFunc, typename UseFunc>
+      VOID Use( UINT64 Key, const DecodeFunc &Decode, const UseFunc &Use )
+      {
+        part &P = Part[(Key ^ Key >> 17 ^ Key >> 40) % Parts];
+        std::lock_guard<std::mutex> Lock(P.Mutex);
+        auto found = P.Map.find(Key);
+        INT Slot;
+
+        if (found != P.Map.end())
+        {
+          Slot = found->second;
+          Hits++;
+        }
+        else
+        {
+          INT Capacity = (INT)COM_MAX((size_t)1, Budget / Parts / sizeof(tile));
+
+          if ((INT)P.Tiles.size() < Capacity)
+          {
+            if (P.Tiles.empty())
+              P.Tiles.reserve(Capacity);
+            Slot = (INT)P.Tiles.size();
+            P.Tiles.emplace_back();
+            P.Keys.push_back(Key);
+            P.Prev.push_back(-1);
+            P.Next.push_back(-1);
+          }
+          else
+          {
+            Slot = P.Last;
+            P.Map.erase(P.Keys[Slot]);
+            P.Keys[Slot] = Key;
+          }
+          P.Map[Key] = Slot;
+          Decode(&P.Tiles[Slot]);
+          Misses++;
+        }
+        Touch(P, Slot);
+        Use(P.Tiles[Slot]);
+      } /* End of 'Use' function */
+  }; /* End of 'tile_cache' class */
+
+  /* Tiled mip-mapped image class.
+   * Image file ('.dtx') is mapped to memory and its tiles are decoded
+   * to cache when they are sampled first, so only used tiles of used
+   * levels occupy memory. File layout (little endian):
+   *   "DTX1", INT W, H, Levels, TileSize;
+   *   levels table: INT W, H, TilesW, TilesH; UINT64 Offset (of level tiles);
+   *   tiles by rows: (TileSize + 1)^2 sRGB texels (3 bytes) by rows.
+   * Last row and column of tile repeat texels of next tiles (image is
+   * wrapped), so bilinear sample reads one tile.
+   */
+  class tiled_image
+  {
+    /* Mip-map level structure */
+    struct level
+    {
+      INT W, H;           // Level size
+      INT TilesW, TilesH; // Level size in tiles
+      UINT64 Offset;      // Tiles offset in file
+    };
+
+    static const INT HeaderSize = 20, LevelSize = 24; // File header and level description sizes
+    static const INT TileBytes = tile_cache::Stride * tile_cache::Stride * 3; // Tile size in file
+
+    mapped_file File;   // Mapped image file
+    stock<level> Lvl;   // Mip-map levels
+    UINT64 Id;          // Image number in tiles keys
+
+    /* Get sRGB to linear colors table function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (const FLT *) table of 256 values.
+     */
+    static const FLT * Linear( VOID )
+    {
+      static FLT Lut[256];
+      static std::once_flag Once;
+
+      std::call_once(Once,
+        []( VOID )
+        {
+          for (INT i = 0; i < 256; i++)
+          {
+            DBL c = i / 255.0;
+
+            Lut[i] = (FLT)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+          }
+        });
+      return Lut;
+    } /* End of 'Linear' function */
+
+    /* Convert linear color component to sRGB byte function.
+     * ARGUMENTS:
+     *   - color component:
+     *       DBL C;
+     * RETURNS:
+     *   (BYTE) sRGB value.
+     */
+    static BYTE Srgb( DBL C )
+    {
+      C = C <= 0 ? 0 : C >= 1 ? 1 : C <= 0.0031308 ? C * 12.92 : 1.055 * pow(C, 1 / 2.4) - 0.055;
+      return (BYTE)(C * 255 + .5);
+    } /* End of 'Srgb' function */
+
+    /* Read 32-bit integer from file data function.
+     * ARGUMENTS:
+     *   - data:
+     *       const BYTE *P;
+     * RETURNS:
+     *   (UINT) value.
+     */
+    static UINT Read32( const BYTE *P )
+    {
+      return P[0] | P[1] << 8 | P[2] << 16 | (UINT)P[3] << 24;
+    } /* End of 'Read32' function */
+
+    /* Write little endian integer to file function.
+     * ARGUMENTS:
+     *   - file:
+     *       FILE *F;
+     *   - value:
+     *       UINT64 X;
+     *   - bytes count (4 by default):
+     *       INT Bytes;
+     * RETURNS: None.
+     */
+    static VOID Write( FILE *F, UINT64 X, INT Bytes = 4 )
+    {
+      for (INT i = 0; i < Bytes; i++)
+        fputc((INT)(X >> i * 8 & 0xFF), F);
+    } /* End of 'Write' function */
+
+    /* Sample level bilinearly function.
+     * ARGUMENTS:
+     *   - level number:
+     *       INT L;
+     *   - texture coordinates (image is wrapped):
+     *       DBL U, V;
+     * RETURNS:
+     *   (vec3) linear color.
+     */
+    vec3 Bilinear( INT L, DBL U, DBL V ) const
+    {
+      const level &lv = Lvl[L];
+      DBL x = U * lv.W - .5, y = V * lv.H - .5, x0 = floor(x), y0 = floor(y);
+      FLT fx = (FLT)(x - x0), fy = (FLT)(y - y0);
+      INT
+        X = (INT)(x0 - floor(x0 / lv.W) * lv.W),
+        Y = (INT)(y0 - floor(y0 / lv.H) * lv.H);
+
+      // rounding of big coordinates
+      X = COM_MIN(X, lv.W - 1), Y = COM_MIN(Y, lv.H - 1);
+
+      INT
+        tx = X / tile_cache::TileSize, ty = Y / tile_cache::TileSize,
+        t = ty * lv.TilesW + tx,
+        k = (Y - ty * tile_cache::TileSize) * tile_cache::Stride + X - tx * tile_cache::TileSize;
+      const BYTE *Src = File.GetData() + lv.Offset + (UINT64)t * TileBytes;
+      vec3 Res;
+
+      tile_cache::Get().Use(Id << 40 | (UINT64)L << 32 | (UINT)t,
+        [Src]( tile_cache::tile *Tile )
+        {
+          const FLT *Lut = Linear();
+
+          for (INT i = 0; i < tile_cache::Stride * tile_cache::Stride; i++)
+            for (INT c = 0; c < 3; c++)
+              Tile->C[i][c] = Lut[Src[i * 3 + c]];
+        },
+        [&]( const tile_cache::tile &Tile )
+        {
+          const FLT
+            *c00 = Tile.C[k], *c01 = Tile.C[k + 1],
+            *c10 = Tile.C[k + tile_cache::Stride], *c11 = Tile.C[k + tile_cache::Stride + 1];
+          FLT w00 = (1 - fx) * (1 - fy), w01 = fx * (1 - fy), w10 = (1 - fx) * fy, w11 = fx * fy;
+
+          Res = vec3(c00[0] * w00 + c01[0] * w01 + c10[0] * w10 + c11[0] * w11,
+                     c00[1] * w00 + c01[1] * w01 + c10[1] * w10 + c11[1] * w11,
+                     c00[2] * w00 + c01[2] * w01 + c10[2] * w10 + c11[2] * w11);
+        });
+      return Res;
+    } /* End of 'Bilinear' function */
+
+    /* Read TGA image function.
+     * Uncompressed and RLE compressed true color images are supported.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     *   - pointers at image size:
+     *       INT *W, *H;
+     *   - reference at linear colors to fill (3 components per texel by rows from top):
+     *       stock<FLT> &Texels;
+     * RETURNS:
+     *   (BOOL) TRUE if image is read, FALSE overwise.
+     */
+    static BOOL ReadTga( const CHAR *FileName, INT *W, INT *H, stock<FLT> &Texels )
+    {
+      mapped_file F;
+
+      if (!F.Open(FileName) || F.GetSize() < 18)
+        return FALSE;
+
+      const BYTE *P = F.GetData(), *End = P + F.GetSize();
+      INT type = P[2], bpp = P[16] / 8, w = P[12] | P[13] << 8, h = P[14] | P[15] << 8;
+      BOOL IsTop = (P[17] & 0x20) != 0;
+
+      if ((type != 2 && type != 10) || (bpp != 3 && bpp != 4) || w == 0 || h == 0 || P[1] != 0)
+        return FALSE;
+      P += 18 + P[0];
+
+      const FLT *Lut = Linear();
+      INT n = 0, count = w * h;
+
+      Texels.resize((size_t)count * 3);
+      while (n < count)
+      {
+        INT run = count - n;
+        BOOL IsRepeat = FALSE;
+
+        // RLE packet is one texel repeated, raw packet is texels sequence
+        if (type == 10)
+        {
+          if (P >= End)
+            return FALSE;
+          IsRepeat = (*P & 0x80) != 0;
+          run = (*P++ & 0x7F) + 1;
+        }
+        for (INT i = 0; i < run && n < count; i++, n++)
+        {
+          if (P + bpp > End)
+            return FALSE;
+
+          INT y = IsTop ? n / w : h - 1 - n / w;
+          FLT *T = &Texels[((size_t)y * w + n % w) * 3];
+
+          // BGR(A) order
+          T[0] = Lut[P[2]], T[1] = Lut[P[1]], T[2] = Lut[P[0]];
+          if (!IsRepeat || i == run - 1)
+            P += bpp;
+        }
+      }
+      *W = w, *H = h;
+      return TRUE;
+    } /* End of 'ReadTga' function */
+
+  public:
+    /* Class constructor */
+    tiled_image( VOID ) : File(), Lvl(), Id(0)
+    {
+    } /* End of 'tiled_image' function */
+
+    /* Open image file function.
+     * ARGUMENTS:
+     *   - file name:
+     *       const CHAR *FileName;
+     * RETURNS:
+     *   (BOOL) TRUE if image is opened, FALSE if file is not found or it is not valid.
+     */
+    BOOL Open( const CHAR *FileName )
+    {
+      static std::atomic<UINT64> Count(0);
+
+      Lvl.clear();
+      if (!File.Open(FileName) || File.GetSize() < HeaderSize)
+        return FALSE;
+
+      const BYTE *P = File.GetData();
+      INT levels = (INT)Read32(P + 12);
+
+      if (memcmp(P, "DTX1", 4) != 0 || Read32(P + 16) != tile_cache::TileSize ||
+          levels <= 0 || levels > 32 || File.GetSize() < HeaderSize + (size_t)levels * LevelSize)
+      {
+        File.Close();
+        return FALSE;
+      }
+      for (INT i = 0; i < levels; i++)
+      {
+        const BYTE *L = P + HeaderSize + i * LevelSize;
+        level lv {(INT)Read32(L), (INT)Read32(L + 4), (INT)Read32(L + 8), (INT)Read32(L + 12),
+          Read32(L + 16) | (UINT64)Read32(L + 20) << 32};
+
+        if (lv.W <= 0 || lv.H <= 0 ||
+            lv.TilesW != (lv.W + tile_cache::TileSize - 1) / tile_cache::TileSize ||
+            lv.TilesH != (lv.H + tile_cache::TileSize - 1) / tile_cache::TileSize ||
+            lv.Offset + (UINT64)lv.TilesW * lv.TilesH * TileBytes > File.GetSize())
+        {
+          File.Close();
+          Lvl.clear();
+          return FALSE;
+        }
+        Lvl.push_back(lv);
+      }
+      Id = ++Count;
+      return TRUE;
+    } /* End of 'Open' function */
+
+    /* Open shared image function.
+     * Image of the same file is opened once while it is used.
+     * ARGUMENTS:
+     *   - file name:
+     *       const std::string &FileName;
+     * RETURNS:
+     *   (std::shared_ptr<tiled_image>) image, nullptr if file is not valid.
+     */
+    static std::shared_ptr<tiled_image> Share( const std::string &FileName )
+    {
+      static std::mutex Mutex;
+      static std::map<std::string, std::weak_ptr<tiled_image>> Images;
+      std::lock_guard<std::mutex> Lock(Mutex);
+      std::shared_ptr<tiled_image> Img = Images[FileName].lock();
+
+      if (Img != nullptr)
+        return Img;
+      Img = std::make_shared<tiled_image>();
+      if (!Img->Open(FileName.c_str()))
+        return nullptr;
+      Images[FileName] = Img;
+      return Img;
+    } /* End of 'Share' function */
+
+    /* Get image size function.
+     * ARGUMENTS:
+     *   - pointers at image size:
+     *       INT *W, *H;
+     * RETURNS: None.
+     */
+    VOID Size( INT *W, INT *H ) const
+    {
+      *W = Lvl.empty() ? 0 : Lvl[0].W;
+      *H = Lvl.empty() ? 0 : Lvl[0].H;
+    } /* End of 'Size' function */
+
+    /* Sample image function.
+     * Levels are blended by fractional level (trilinear filtering).
+     * ARGUMENTS:
+     *   - texture coordinates (image is wrapped):
+     *       DBL U, V;
+     *   - footprint size in texels of largest level:
+     *       DBL Width;
+     * RETURNS:
+     *   (vec3) linear color.
+     */
+    vec3 Sample( DBL U, DBL V, DBL Width ) const
+    {
+      if (Lvl.empty())
+        return vec3(0);
+
+      DBL lod = Width > 1 ? log2(Width) : 0;
+      INT l0 = (INT)lod;
+
+      if (l0 >= (INT)Lvl.size() - 1)
+        return Bilinear((INT)Lvl.size() - 1, U, V);
+
+      DBL t = lod - l0;
+      vec3 c0 = Bilinear(l0, U, V);
+
+      if (t < 1e-3)
+        return c0;
+      return c0 * (1 - t) + Bilinear(l0 + 1, U, V) * t;
+    } /* End of 'Sample' function */
+
+    /* Build tiled image file from TGA image function.
+     * Levels are averaged by 2x2 texels in linear colors.
+     * ARGUMENTS:
+     *   - source TGA file name:
+     *       const CHAR *InName;
+     *   - tiled image file name:
+     *       const CHAR *OutName;
+     * RETURNS:
+     *   (BOOL) TRUE if file is written, FALSE overwise.
+     */
+    static BOOL Build( const CHAR *InName, const CHAR *OutName )
+    {
+      stock<stock<FLT>> Levels;
+      stock<INT> Ws, Hs;
+
+      Levels.resize(1), Ws.resize(1), Hs.resize(1);
+      if (!ReadTga(InName, &Ws[0], &Hs[0], Levels[0]))
+        return FALSE;
+      while (Ws.back() > 1 || Hs.back() > 1)
+      {
+        const stock<FLT> &S = Levels.back();
+        INT sw = Ws.back(), sh = Hs.back(), w = COM_MAX(1, sw / 2), h = COM_MAX(1, sh / 2);
+        stock<FLT> D;
+
+        D.resize((size_t)w * h * 3);
+        for (INT y = 0; y < h; y++)
+          for (INT x = 0; x < w; x++)
+          {
+            INT
+              x0 = COM_MIN(x * 2, sw - 1), x1 = COM_MIN(x * 2 + 1, sw - 1),
+              y0 = COM_MIN(y * 2, sh - 1), y1 = COM_MIN(y * 2 + 1, sh - 1);
+
+            for (INT c = 0; c < 3; c++)
+              D[((size_t)y * w + x) * 3 + c] = (S[((size_t)y0 * sw + x0) * 3 + c] + S[((size_t)y0 * sw + x1) * 3 + c] +
+                S[((size_t)y1 * sw + x0) * 3 + c] + S[((size_t)y1 * sw + x1) * 3 + c]) * .25f;
+          }
+        Levels.push_back(std::move(D));
+        Ws.push_back(w);
+        Hs.push_back(h);
+      }
+
+      FILE *F = fopen(OutName, "wb");
+
+      if (F == nullptr)
+        return FALSE;
+
+      INT n = (INT)Levels.size();
+      UINT64 Offset = HeaderSize + (UINT64)n * LevelSize;
+
+      fwrite("DTX1", 1, 4, F);
+      Write(F, Ws[0]), Write(F, Hs[0]), Write(F, n), Write(F, tile_cache::TileSize);
+      for (INT l = 0; l < n; l++)
+      {
+        INT tw = (Ws[l] + tile_cache::TileSize - 1) / tile_cache::TileSize, th = (Hs[l] + tile_cache::TileSize - 1) / tile_cache::TileSize;
+
+        Write(F, Ws[l]), Write(F, Hs[l]), Write(F, tw), Write(F, th), Write(F, Offset, 8);
+        Offset += (UINT64)tw * th * TileBytes;
+      }
+
+      stock<BYTE> Tile;
+
+      Tile.resize(TileBytes);
+      for (INT l = 0; l < n; l++)
+      {
+        INT w = Ws[l], h = Hs[l], tw = (w + tile_cache::TileSize - 1) / tile_cache::TileSize, th = (h + tile_cache::TileSize - 1) / tile_cache::TileSize;
+
+        for (INT ty = 0; ty < th; ty++)
+          for (INT tx = 0; tx < tw; tx++)
+          {
+            for (INT y = 0; y < tile_cache::Stride; y++)
+              for (INT x = 0; x < tile_cache::Stride; x++)
+              {
+                INT sx = (tx * tile_cache::TileSize + x) % w, sy = (ty * tile_cache::TileSize + y) % h;
+
+                for (INT c = 0; c < 3; c++)
+                  Tile[(y * tile_cache::Stride + x) * 3 + c] = Srgb(Levels[l][((size_t)sy * w + sx) * 3 + c]);
+              }
+            fwrite(Tile.data(), 1, TileBytes, F);
+          }
+      }
+      BOOL IsOk = !ferror(F);
+
+      fclose(F);
+      return IsOk;
+    } /* End of 'Build' function */
+  }; /* End of 'tiled_image' class */
+} /* end of 'dart' namespace */
+
+#endif // __tiled_image_h_
+
+/* END OF 'tiled_image.h' FILE */
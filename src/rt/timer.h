@@ -8,7 +8,7 @@
  *               Timer class implementation module.
  * PROGRAMMER  : CGSG-SummerCamp'2022.
  *               Danil Belov.
- * LAST UPDATE : 26.07.2022.
+ * LAST UPDATE : 19.10.2026.
  * NOTE        : Module namespace 'dart'.
  *
  * No part of this file may be changed without agreement of
@@ -17,6 +17,8 @@
 #ifndef __timer_h_
 #define __timer_h_
 
+#include <chrono>
+
 #include "def.h"
 
 typedef uint64_t UINT64;
@@ -31,15 +33,46 @@ namespace dart
       BOOL IsPause;
       UINT64 TimePerSec, StartTime, OldTime, OldTimeFPS, PauseTime, FrameCounter;
 
-      /* Class constructor */
-      timer( VOID ) : GlobalTime(), GlobalDeltaTime(), Time(), DeltaTime(), FPS(), IsPause(FALSE)
+      /* Get high resolution counter function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (UINT64) counter value (see 'Frequency').
+       */
+      static UINT64 Counter( VOID )
       {
+#ifdef _WIN32
         LARGE_INTEGER t;
-        QueryPerformanceFrequency(&t);
-        TimePerSec = t.QuadPart;
 
         QueryPerformanceCounter(&t);
-        StartTime = OldTime = OldTimeFPS = t.QuadPart;
+        return t.QuadPart;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+      } /* End of 'Counter' function */
+
+      /* Get high resolution counter frequency function.
+       * ARGUMENTS: None.
+       * RETURNS:
+       *   (UINT64) counter ticks per second.
+       */
+      static UINT64 Frequency( VOID )
+      {
+#ifdef _WIN32
+        LARGE_INTEGER t;
+
+        QueryPerformanceFrequency(&t);
+        return t.QuadPart;
+#else
+        return 1000000000;
+#endif
+      } /* End of 'Frequency' function */
+
+      /* Class constructor */
+      timer( VOID ) : GlobalTime(), GlobalDeltaTime(), Time(), DeltaTime(), FPS(), IsPause(FALSE)
+      {
+        TimePerSec = Frequency();
+        StartTime = OldTime = OldTimeFPS = Counter();
       } /* End of 'timer' function */
 
       /* Measure time and FPS function.
@@ -48,35 +81,47 @@ namespace dart
        */
       VOID Response( VOID )
       {
-        LARGE_INTEGER t;
-        QueryPerformanceCounter(&t);
+        UINT64 t = Counter();
 
         /* Global time */
-        GlobalTime = (DBL)(t.QuadPart - StartTime) / TimePerSec;
-        GlobalDeltaTime = (DBL)(t.QuadPart - OldTime) / TimePerSec;
+        GlobalTime = (DBL)(t - StartTime) / TimePerSec;
+        GlobalDeltaTime = (DBL)(t - OldTime) / TimePerSec;
 
         /* Time with pause */
         if (IsPause)
         {
           DeltaTime = 0;
-          PauseTime += t.QuadPart - OldTime;
+          PauseTime += t - OldTime;
         }
         else
         {
           DeltaTime = GlobalDeltaTime;
-          Time = (DBL)(t.QuadPart - PauseTime - StartTime) / TimePerSec;
+          Time = (DBL)(t - PauseTime - StartTime) / TimePerSec;
         }
 
         /* FPS measure */
         FrameCounter++;
-        if (t.QuadPart - OldTimeFPS > TimePerSec)
+        if (t - OldTimeFPS > TimePerSec)
         {
-          FPS = FrameCounter * TimePerSec / (DBL)(t.QuadPart - OldTimeFPS);
-          OldTimeFPS = t.QuadPart;
+          FPS = FrameCounter * TimePerSec / (DBL)(t - OldTimeFPS);
+          OldTimeFPS = t;
           FrameCounter = 0;
         }
-        OldTime = t.QuadPart;
+        OldTime = t;
       } /* End of 'Response' function */
+
+      /* Set fixed animation time (for offline rendering) function.
+       * ARGUMENTS:
+       *   - animation time and time step:
+       *       DBL NewTime, NewDeltaTime;
+       * RETURNS: None.
+       */
+      VOID Set( DBL NewTime, DBL NewDeltaTime )
+      {
+        IsPause = FALSE;
+        Time = NewTime;
+        DeltaTime = NewDeltaTime;
+      } /* End of 'Set' function */
     }; /* End of 'timer' class */
 } /* end of 'dart' namespace */
 